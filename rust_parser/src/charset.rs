@@ -0,0 +1,269 @@
+//! Charset detection and transcoding of response bodies to UTF-8
+//!
+//! The encoding is taken, in order, from a byte order mark, the Content-Type header
+//! charset, and a `<meta>` prescan of the first 1024 bytes (the HTML spec's order).
+//! Undeclared bodies stay UTF-8 when they are valid UTF-8 and fall back to
+//! windows-1252 otherwise.
+//!
+//! UTF-8 bodies, and pure-ASCII bodies in any ASCII-compatible charset, are validated
+//! in place and handed over without a copy; everything else goes through encoding_rs.
+
+use encoding_rs::{Encoding, UTF_16BE, UTF_16LE, UTF_8, WINDOWS_1252, X_USER_DEFINED};
+
+/// Bytes examined by the `<meta charset>` prescan
+const META_PRESCAN_BYTES: usize = 1024;
+
+/// Where the body's encoding came from
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum CharsetSource {
+    Bom,
+    Header,
+    Meta,
+    Undeclared,
+}
+
+/// Detect the encoding of a response body. Returns the encoding, where it came from
+/// and the length of the byte order mark to skip.
+pub fn detect_encoding(body: &[u8], content_type: &str) -> (&'static Encoding, CharsetSource, usize) {
+    if let Some((encoding, bom_len)) = Encoding::for_bom(body) {
+        return (encoding, CharsetSource::Bom, bom_len);
+    }
+    if let Some(encoding) = charset_from_content_type(content_type) {
+        return (encoding, CharsetSource::Header, 0);
+    }
+    let head = &body[..body.len().min(META_PRESCAN_BYTES)];
+    if let Some(encoding) = prescan_meta_charset(head) {
+        // The prescan read the bytes as ASCII, so a UTF-16 declaration cannot be right
+        let encoding = if encoding == UTF_16BE || encoding == UTF_16LE {
+            UTF_8
+        } else if encoding == X_USER_DEFINED {
+            WINDOWS_1252
+        } else {
+            encoding
+        };
+        return (encoding, CharsetSource::Meta, 0);
+    }
+    (UTF_8, CharsetSource::Undeclared, 0)
+}
+
+/// Decode a response body to UTF-8, taking ownership to avoid a copy on the fast path
+pub fn decode_body(body: Vec<u8>, content_type: &str) -> String {
+    let (encoding, source, bom_len) = detect_encoding(&body, content_type);
+
+    let mut body = body;
+    if encoding == UTF_8
+        || (encoding.is_ascii_compatible() && Encoding::ascii_valid_up_to(&body[bom_len..]) == body.len() - bom_len)
+    {
+        if bom_len > 0 {
+            body.drain(..bom_len);
+        }
+        match String::from_utf8(body) {
+            Ok(text) => return text,
+            Err(err) => {
+                // Not valid UTF-8 after all: undeclared bodies are legacy single-byte text,
+                // declared UTF-8 keeps its valid parts with replacement characters
+                let bytes = err.into_bytes();
+                let fallback = if source == CharsetSource::Undeclared { WINDOWS_1252 } else { UTF_8 };
+                return fallback.decode_without_bom_handling(&bytes).0.into_owned();
+            }
+        }
+    }
+
+    encoding.decode_without_bom_handling(&body[bom_len..]).0.into_owned()
+}
+
+/// Encoding named by the charset parameter of a Content-Type header value
+pub fn charset_from_content_type(content_type: &str) -> Option<&'static Encoding> {
+    content_type.split(';').skip(1).find_map(|param| {
+        let (name, value) = param.split_once('=')?;
+        if !name.trim().eq_ignore_ascii_case("charset") {
+            return None;
+        }
+        let label = value.trim().trim_matches(|c| c == '"' || c == '\'');
+        Encoding::for_label(label.as_bytes())
+    })
+}
+
+/// Encoding declared by the first `<meta charset>` or `<meta http-equiv="Content-Type">`
+/// tag (a reduced form of the HTML spec's prescan; comments are skipped)
+pub fn prescan_meta_charset(head: &[u8]) -> Option<&'static Encoding> {
+    let mut pos = 0;
+    while pos < head.len() {
+        if head[pos..].starts_with(b"<!--") {
+            pos = find(head, pos + 4, b"-->").map_or(head.len(), |end| end + 3);
+            continue;
+        }
+        if head[pos] == b'<'
+            && head.len() - pos > 5
+            && head[pos + 1..pos + 5].eq_ignore_ascii_case(b"meta")
+            && (head[pos + 5].is_ascii_whitespace() || head[pos + 5] == b'/')
+        {
+            let (encoding, end) = parse_meta_tag(head, pos + 5);
+            if encoding.is_some() {
+                return encoding;
+            }
+            pos = end;
+            continue;
+        }
+        pos += 1;
+    }
+    None
+}
+
+fn find(haystack: &[u8], from: usize, needle: &[u8]) -> Option<usize> {
+    haystack
+        .get(from..)?
+        .windows(needle.len())
+        .position(|window| window == needle)
+        .map(|offset| from + offset)
+}
+
+/// Parse the attributes of a meta tag starting at `pos`; returns its declared encoding
+/// and the position after the tag
+fn parse_meta_tag(head: &[u8], mut pos: usize) -> (Option<&'static Encoding>, usize) {
+    let mut charset = None;
+    let mut is_content_type = false;
+    let mut content_charset = None;
+
+    while let Some((name, value, next)) = next_attribute(head, pos) {
+        pos = next;
+        match name.as_slice() {
+            b"charset" if charset.is_none() => charset = Encoding::for_label(&value),
+            b"http-equiv" => is_content_type = value.eq_ignore_ascii_case(b"content-type"),
+            b"content" if content_charset.is_none() => content_charset = charset_from_meta_content(&value),
+            _ => {}
+        }
+    }
+
+    let encoding = charset.or(if is_content_type { content_charset } else { None });
+    (encoding, pos)
+}
+
+/// Next `name[=value]` attribute of a tag, or None at `>` or the end of the buffer.
+/// Names are lowercased; values are unquoted.
+fn next_attribute(head: &[u8], mut pos: usize) -> Option<(Vec<u8>, Vec<u8>, usize)> {
+    while pos < head.len() && (head[pos].is_ascii_whitespace() || head[pos] == b'/') {
+        pos += 1;
+    }
+    if pos >= head.len() || head[pos] == b'>' {
+        return None;
+    }
+
+    let mut name = Vec::new();
+    while pos < head.len() && !matches!(head[pos], b'=' | b'>' | b'/') && !head[pos].is_ascii_whitespace() {
+        name.push(head[pos].to_ascii_lowercase());
+        pos += 1;
+    }
+    while pos < head.len() && head[pos].is_ascii_whitespace() {
+        pos += 1;
+    }
+    if pos >= head.len() || head[pos] != b'=' {
+        return Some((name, Vec::new(), pos));
+    }
+    pos += 1;
+    while pos < head.len() && head[pos].is_ascii_whitespace() {
+        pos += 1;
+    }
+
+    let mut value = Vec::new();
+    if pos < head.len() && (head[pos] == b'"' || head[pos] == b'\'') {
+        let quote = head[pos];
+        pos += 1;
+        while pos < head.len() && head[pos] != quote {
+            value.push(head[pos]);
+            pos += 1;
+        }
+        pos += 1;
+    } else {
+        while pos < head.len() && head[pos] != b'>' && !head[pos].is_ascii_whitespace() {
+            value.push(head[pos]);
+            pos += 1;
+        }
+    }
+    Some((name, value, pos.min(head.len())))
+}
+
+/// Charset from a meta content value such as `text/html; charset=Shift_JIS`
+fn charset_from_meta_content(content: &[u8]) -> Option<&'static Encoding> {
+    let lower = content.to_ascii_lowercase();
+    let mut pos = find(&lower, 0, b"charset")? + 7;
+    while pos < content.len() && content[pos].is_ascii_whitespace() {
+        pos += 1;
+    }
+    if pos >= content.len() || content[pos] != b'=' {
+        return None;
+    }
+    pos += 1;
+    while pos < content.len() && content[pos].is_ascii_whitespace() {
+        pos += 1;
+    }
+    let value = match content.get(pos) {
+        Some(&quote @ (b'"' | b'\'')) => {
+            let rest = &content[pos + 1..];
+            &rest[..rest.iter().position(|&c| c == quote)?]
+        }
+        _ => {
+            let rest = &content[pos..];
+            &rest[..rest.iter().position(|&c| c == b';' || c.is_ascii_whitespace()).unwrap_or(rest.len())]
+        }
+    };
+    Encoding::for_label(value)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use encoding_rs::{KOI8_R, SHIFT_JIS, WINDOWS_1252};
+
+    #[test]
+    fn test_header_charset() {
+        assert_eq!(charset_from_content_type("text/html; charset=Shift_JIS"), Some(SHIFT_JIS));
+        assert_eq!(charset_from_content_type("text/html;charset=\"koi8-r\""), Some(KOI8_R));
+        assert_eq!(charset_from_content_type("text/html"), None);
+    }
+
+    #[test]
+    fn test_meta_prescan() {
+        assert_eq!(prescan_meta_charset(b"<html><head><meta charset=\"shift_jis\">"), Some(SHIFT_JIS));
+        assert_eq!(
+            prescan_meta_charset(b"<META http-equiv='Content-Type' content='text/html; charset=koi8-r'>"),
+            Some(KOI8_R)
+        );
+        // content without http-equiv does not count, and comments are skipped
+        assert_eq!(prescan_meta_charset(b"<meta content=\"charset=koi8-r\"><title>x</title>"), None);
+        assert_eq!(prescan_meta_charset(b"<!-- <meta charset=koi8-r> --><meta charset=utf-8>"), Some(UTF_8));
+        assert_eq!(prescan_meta_charset(b"<meta name=viewport content=width=device-width>"), None);
+    }
+
+    #[test]
+    fn test_precedence() {
+        let body = b"\xEF\xBB\xBF<meta charset=koi8-r>";
+        assert_eq!(detect_encoding(body, "text/html; charset=shift_jis"), (UTF_8, CharsetSource::Bom, 3));
+        assert_eq!(
+            detect_encoding(b"<meta charset=koi8-r>", "text/html; charset=shift_jis"),
+            (SHIFT_JIS, CharsetSource::Header, 0)
+        );
+        assert_eq!(detect_encoding(b"<meta charset=koi8-r>", "text/html"), (KOI8_R, CharsetSource::Meta, 0));
+        assert_eq!(detect_encoding(b"<meta charset=utf-16le>", ""), (UTF_8, CharsetSource::Meta, 0));
+    }
+
+    #[test]
+    fn test_decode_body() {
+        // Meta-declared Shift_JIS: "日本" is 93 FA 96 7B
+        let sjis = b"<meta charset=\"Shift_JIS\"><p>\x93\xFA\x96\x7B</p>".to_vec();
+        assert_eq!(decode_body(sjis, "text/html"), "<meta charset=\"Shift_JIS\"><p>日本</p>");
+
+        // KOI8-R "мир" is CD C9 D2
+        assert_eq!(decode_body(b"\xCD\xC9\xD2".to_vec(), "text/html; charset=koi8-r"), "мир");
+
+        // BOM is stripped, UTF-8 passes through
+        assert_eq!(decode_body("\u{FEFF}hyvää".as_bytes().to_vec(), "text/html"), "hyvää");
+
+        // Undeclared invalid UTF-8 falls back to windows-1252
+        assert_eq!(decode_body(b"hyv\xE4\xE4".to_vec(), "text/html"), "hyvää");
+        assert_eq!(WINDOWS_1252.decode_without_bom_handling(b"\xE4").0, "ä");
+
+        // ASCII under a legacy charset takes the fast path unchanged
+        assert_eq!(decode_body(b"plain".to_vec(), "text/html; charset=iso-8859-1"), "plain");
+    }
+}
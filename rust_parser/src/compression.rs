@@ -0,0 +1,144 @@
+//! Content-Encoding handling for raw (still compressed) response bodies
+//!
+//! The client is built without automatic decompression, so bodies arrive exactly as
+//! transferred. They are inflated here, and only when text is actually needed; when the
+//! origin's compressed bytes are kept for archival, that can be never.
+
+use std::io::Read;
+
+/// Accept-Encoding sent with every fetch (most compact codings first)
+pub const ACCEPT_ENCODING: &str = "zstd, br, gzip, deflate";
+
+/// How the origin's compressed bytes are kept
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default, serde::Deserialize)]
+#[serde(rename_all = "lowercase")]
+pub enum StoreCompressed {
+    /// Bodies are decompressed after the fetch; nothing is kept
+    #[default]
+    Off,
+    /// Keep the compressed bytes and also return the decoded text
+    Alongside,
+    /// Keep only the compressed bytes; no decompression or extraction at fetch time
+    Only,
+}
+
+/// True if a Content-Encoding value means the body is not compressed
+pub fn is_identity(content_encoding: &str) -> bool {
+    let encoding = content_encoding.trim();
+    encoding.is_empty() || encoding.eq_ignore_ascii_case("identity")
+}
+
+/// Undo a Content-Encoding. Stacked codings ("gzip, br") are removed last to first.
+pub fn decompress(content_encoding: &str, data: &[u8]) -> Result<Vec<u8>, String> {
+    let mut body = data.to_vec();
+    for coding in content_encoding.rsplit(',') {
+        let coding = coding.trim().to_ascii_lowercase();
+        body = match coding.as_str() {
+            "" | "identity" => body,
+            "gzip" | "x-gzip" => read_all(flate2::read::MultiGzDecoder::new(&body[..]))?,
+            "deflate" => {
+                // RFC 9110 deflate is zlib-wrapped, but some servers send raw deflate
+                read_all(flate2::read::ZlibDecoder::new(&body[..]))
+                    .or_else(|_| read_all(flate2::read::DeflateDecoder::new(&body[..])))?
+            }
+            "br" => read_all(brotli::Decompressor::new(&body[..], 64 * 1024))?,
+            "zstd" => zstd::stream::decode_all(&body[..]).map_err(|e| format!("zstd: {}", e))?,
+            other => return Err(format!("unsupported content encoding: {}", other)),
+        };
+    }
+    Ok(body)
+}
+
+/// Inflated size of a body, when the coding records it: the gzip trailer's ISIZE or the
+/// zstd frame header's content size. None when it is not known up front.
+pub fn inflated_len_hint(content_encoding: &str, data: &[u8]) -> Option<usize> {
+    if is_identity(content_encoding) {
+        return Some(data.len());
+    }
+    match content_encoding.trim().to_ascii_lowercase().as_str() {
+        "gzip" | "x-gzip" if data.len() >= 18 => {
+            let trailer: [u8; 4] = data[data.len() - 4..].try_into().ok()?;
+            Some(u32::from_le_bytes(trailer) as usize)
+        }
+        "zstd" => zstd::zstd_safe::get_frame_content_size(data)
+            .ok()
+            .flatten()
+            .and_then(|n| usize::try_from(n).ok()),
+        _ => None,
+    }
+}
+
+fn read_all(mut reader: impl Read) -> Result<Vec<u8>, String> {
+    let mut out = Vec::new();
+    reader.read_to_end(&mut out).map_err(|e| e.to_string())?;
+    Ok(out)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::io::Write;
+
+    const TEXT: &[u8] = b"<html><body>Hello, compressed world</body></html>";
+
+    #[test]
+    fn test_gzip_and_deflate() {
+        let mut gz = flate2::write::GzEncoder::new(Vec::new(), flate2::Compression::default());
+        gz.write_all(TEXT).unwrap();
+        assert_eq!(decompress("gzip", &gz.finish().unwrap()).unwrap(), TEXT);
+
+        let mut zlib = flate2::write::ZlibEncoder::new(Vec::new(), flate2::Compression::default());
+        zlib.write_all(TEXT).unwrap();
+        assert_eq!(decompress("deflate", &zlib.finish().unwrap()).unwrap(), TEXT);
+
+        let mut raw = flate2::write::DeflateEncoder::new(Vec::new(), flate2::Compression::default());
+        raw.write_all(TEXT).unwrap();
+        assert_eq!(decompress("Deflate", &raw.finish().unwrap()).unwrap(), TEXT);
+    }
+
+    #[test]
+    fn test_brotli_and_zstd() {
+        let mut br = Vec::new();
+        {
+            let mut writer = brotli::CompressorWriter::new(&mut br, 4096, 5, 22);
+            writer.write_all(TEXT).unwrap();
+        }
+        assert_eq!(decompress("br", &br).unwrap(), TEXT);
+
+        let zst = zstd::stream::encode_all(TEXT, 3).unwrap();
+        assert_eq!(decompress("zstd", &zst).unwrap(), TEXT);
+    }
+
+    #[test]
+    fn test_stacked_and_identity() {
+        let zst = zstd::stream::encode_all(TEXT, 3).unwrap();
+        let mut gz = flate2::write::GzEncoder::new(Vec::new(), flate2::Compression::default());
+        gz.write_all(&zst).unwrap();
+        // zstd applied first, then gzip
+        assert_eq!(decompress("zstd, gzip", &gz.finish().unwrap()).unwrap(), TEXT);
+
+        assert_eq!(decompress("identity", TEXT).unwrap(), TEXT);
+        assert!(is_identity(" "));
+        assert!(decompress("compress", TEXT).is_err());
+        assert!(decompress("gzip", b"not gzip").is_err());
+    }
+
+    #[test]
+    fn test_inflated_len_hint() {
+        assert_eq!(inflated_len_hint("", TEXT), Some(TEXT.len()));
+
+        let mut gz = flate2::write::GzEncoder::new(Vec::new(), flate2::Compression::default());
+        gz.write_all(TEXT).unwrap();
+        assert_eq!(inflated_len_hint("GZIP", &gz.finish().unwrap()), Some(TEXT.len()));
+        assert_eq!(inflated_len_hint("gzip", b"short"), None);
+
+        // One-shot compression records the content size; streamed frames may not
+        let zst = zstd::bulk::compress(TEXT, 3).unwrap();
+        assert_eq!(inflated_len_hint("zstd", &zst), Some(TEXT.len()));
+        assert_eq!(inflated_len_hint("zstd", b"not zstd"), None);
+
+        // No size on record: the caller has to assume the worst
+        assert_eq!(inflated_len_hint("br", TEXT), None);
+        assert_eq!(inflated_len_hint("zstd, gzip", TEXT), None);
+    }
+}
@@ -0,0 +1,125 @@
+//! Dedicated threads for the CPU-bound half of a fetch
+//!
+//! Charset decoding, decompression and extraction (CSS selection, SWC parsing of
+//! inline scripts) of a multi-megabyte page can take tens of milliseconds. Run inside
+//! the fetch task, that stalls every other connection the tokio worker is driving.
+//! Fetch tasks instead hand the work to this pool and await the result, so sockets
+//! keep being polled while pages are processed.
+//!
+//! The worker threads are shared by all crawls in the process (one per core). Each
+//! crawl bounds its own share with a `ComputeLimiter`: a fetch task waits for a permit
+//! before handing work off, so when processing falls behind, downloads pause instead of
+//! queueing bodies without limit.
+
+use std::panic::{catch_unwind, AssertUnwindSafe};
+use std::sync::mpsc;
+use std::sync::{Arc, Mutex, OnceLock};
+use tokio::sync::Semaphore;
+
+/// Bodies smaller than this are processed inline; the handoff would cost more
+pub const INLINE_MAX_BYTES: usize = 64 * 1024;
+
+type Job = Box<dyn FnOnce() + Send + 'static>;
+
+struct Workers {
+    sender: Mutex<mpsc::Sender<Job>>,
+    threads: usize,
+}
+
+static WORKERS: OnceLock<Workers> = OnceLock::new();
+
+fn workers() -> &'static Workers {
+    WORKERS.get_or_init(|| {
+        let threads = std::thread::available_parallelism().map_or(4, |n| n.get());
+        let (sender, receiver) = mpsc::channel::<Job>();
+        let receiver = Arc::new(Mutex::new(receiver));
+        for i in 0..threads {
+            let receiver = receiver.clone();
+            std::thread::Builder::new()
+                .name(format!("crawler-compute-{}", i))
+                .spawn(move || loop {
+                    let job = match receiver.lock().unwrap().recv() {
+                        Ok(job) => job,
+                        Err(_) => return,
+                    };
+                    job();
+                })
+                .expect("failed to spawn compute thread");
+        }
+        Workers { sender: Mutex::new(sender), threads }
+    })
+}
+
+/// One crawl's share of the compute pool
+pub struct ComputeLimiter {
+    permits: Semaphore,
+}
+
+impl ComputeLimiter {
+    /// Allow up to `threads` jobs in flight (0 = one per core)
+    pub fn new(threads: usize) -> Self {
+        let available = workers().threads;
+        let threads = if threads == 0 { available } else { threads.min(available) };
+        ComputeLimiter { permits: Semaphore::new(threads) }
+    }
+
+    /// Run `f` on a compute thread. Waits for a permit first (backpressure). A panic in
+    /// `f` is returned as an error instead of taking the worker down.
+    pub async fn run<F, R>(&self, f: F) -> Result<R, String>
+    where
+        F: FnOnce() -> R + Send + 'static,
+        R: Send + 'static,
+    {
+        let _permit = self.permits.acquire().await.map_err(|e| e.to_string())?;
+        let (sender, receiver) = tokio::sync::oneshot::channel();
+        let job: Job = Box::new(move || {
+            let result = catch_unwind(AssertUnwindSafe(f)).map_err(|_| "compute task panicked".to_string());
+            let _ = sender.send(result);
+        });
+        workers()
+            .sender
+            .lock()
+            .unwrap()
+            .send(job)
+            .map_err(|_| "compute pool is shut down".to_string())?;
+        receiver.await.map_err(|_| "compute task dropped".to_string())?
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_runs_off_the_runtime_thread() {
+        let runtime = tokio::runtime::Builder::new_current_thread().build().unwrap();
+        let limiter = ComputeLimiter::new(2);
+        let caller = std::thread::current().id();
+        let worker = runtime.block_on(limiter.run(|| std::thread::current().id())).unwrap();
+        assert_ne!(caller, worker);
+    }
+
+    #[test]
+    fn test_panic_is_an_error() {
+        let runtime = tokio::runtime::Builder::new_current_thread().build().unwrap();
+        let limiter = ComputeLimiter::new(1);
+        let result: Result<(), String> = runtime.block_on(limiter.run(|| panic!("boom")));
+        assert!(result.is_err());
+        // The worker survived
+        assert_eq!(runtime.block_on(limiter.run(|| 42)).unwrap(), 42);
+    }
+
+    #[test]
+    fn test_overlaps_jobs() {
+        let runtime = tokio::runtime::Builder::new_multi_thread().worker_threads(2).build().unwrap();
+        let limiter = Arc::new(ComputeLimiter::new(0));
+        let results = runtime.block_on(async {
+            let jobs = (0..16).map(|i| {
+                let limiter = limiter.clone();
+                async move { limiter.run(move || i * 2).await.unwrap() }
+            });
+            futures::future::join_all(jobs).await
+        });
+        assert_eq!(results, (0..16).map(|i| i * 2).collect::<Vec<_>>());
+    }
+}
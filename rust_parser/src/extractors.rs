@@ -1,17 +1,81 @@
 //! HTML content extractors
 
+use crate::lazy_json;
 use scraper::{Html, Selector};
 use serde::{Deserialize, Serialize};
+use serde_json::value::RawValue;
 use serde_json::Value;
 use std::collections::HashMap;
-use swc_common::{sync::Lrc, SourceMap, FileName};
+use std::time::{Duration, Instant};
+use swc_common::{sync::Lrc, BytePos, SourceMap, FileName, Span};
 use swc_ecma_parser::{lexer::Lexer, Parser, StringInput, Syntax};
 use swc_ecma_ast::*;
 
 /// Extraction request from C++
-#[derive(Debug, Clone, Deserialize)]
+///
+/// Besides the specs, crawl() and crawl_url() ask for the html facets and the links to
+/// follow, so the fetch task parses each page once for all of them.
+#[derive(Debug, Clone, Default, Deserialize)]
 pub struct ExtractionRequest {
+    #[serde(default)]
     pub specs: Vec<ExtractSpec>,
+    /// Compute the html facets (js, opengraph, schema, readability) of HTML pages
+    #[serde(default)]
+    pub facets: bool,
+    /// Return the links matching this CSS selector ("" = a[href])
+    #[serde(default)]
+    pub follow: Option<String>,
+    /// Limits on the work spent per document
+    #[serde(default)]
+    pub budget: ExtractionBudget,
+}
+
+/// Key (or field) marking a facet that hit its budget; the value names the limit
+pub const TRUNCATED_KEY: &str = "$truncated";
+
+/// Per-document extraction limits, so a pathological page (a 40 MB inline state blob,
+/// a 100k-row table, a million-node DOM) cannot stall a worker. 0 = unlimited.
+/// Extractors stop at the limit and mark what they return with `TRUNCATED_KEY`.
+#[derive(Debug, Clone, Default, Deserialize)]
+#[serde(default)]
+pub struct ExtractionBudget {
+    /// Documents with more nodes skip the DOM-walking facets (microdata, readability)
+    pub max_dom_nodes: usize,
+    /// Inline script bytes handed to the JS parser, per document
+    pub max_script_bytes: usize,
+    /// Cells of an extracted table
+    pub max_table_cells: usize,
+    /// Wall-clock time per facet, checked between scripts, items and rows
+    pub max_facet_ms: u64,
+}
+
+impl ExtractionBudget {
+    /// Parse a budget sent by C++ ("" or invalid JSON = unlimited)
+    pub fn from_json(json: &str) -> Self {
+        serde_json::from_str(json).unwrap_or_default()
+    }
+
+    fn too_many_nodes(&self, document: &Html) -> bool {
+        self.max_dom_nodes > 0 && document.tree.nodes().count() > self.max_dom_nodes
+    }
+
+    fn clock(&self) -> FacetClock {
+        FacetClock {
+            deadline: (self.max_facet_ms > 0)
+                .then(|| Instant::now() + Duration::from_millis(self.max_facet_ms)),
+        }
+    }
+}
+
+/// Wall-clock budget of one facet
+struct FacetClock {
+    deadline: Option<Instant>,
+}
+
+impl FacetClock {
+    fn expired(&self) -> bool {
+        self.deadline.map_or(false, |deadline| Instant::now() >= deadline)
+    }
 }
 
 /// Single extraction specification
@@ -65,43 +129,141 @@ pub struct ExtractionResult {
     pub error: Option<String>,
 }
 
+/// Structured data of a parsed document, extracted once and shared by all specs
+struct DocumentData {
+    jsonld: HashMap<String, Value>,
+    microdata: HashMap<String, Value>,
+    og: HashMap<String, String>,
+    meta: HashMap<String, String>,
+    js: JsVariables,
+}
+
+impl DocumentData {
+    fn new(document: &Html, budget: &ExtractionBudget) -> Self {
+        DocumentData {
+            jsonld: extract_jsonld_objects(document),
+            microdata: extract_microdata(document, budget),
+            og: extract_opengraph(document),
+            meta: extract_meta_tags(document),
+            js: extract_js_variables(document, budget),
+        }
+    }
+}
+
 /// Extract all requested data from HTML
 pub fn extract_all(html: &str, request: &ExtractionRequest) -> ExtractionResult {
     let document = Html::parse_document(html);
+    let data = DocumentData::new(&document, &request.budget);
+    evaluate_specs(&document, &data, &request.specs)
+}
+
+/// The html facets of a page, as crawl() returns them in its `html` column
+#[derive(Debug, Serialize)]
+pub struct PageFacets {
+    pub js: JsVariables,
+    pub opengraph: HashMap<String, String>,
+    /// JSON-LD and microdata, keyed by @type
+    pub schema: serde_json::Map<String, Value>,
+    pub readability: ReadabilityResult,
+}
+
+/// Everything an extraction request asked for, from one parse of the page
+#[derive(Debug, Default)]
+pub struct PageExtraction {
+    /// Spec values (None without specs)
+    pub values: Option<HashMap<String, Option<String>>>,
+    /// None unless requested and the page is HTML
+    pub facets: Option<PageFacets>,
+    /// None unless requested
+    pub links: Option<Vec<String>>,
+}
+
+fn is_html_content_type(content_type: &str) -> bool {
+    content_type.contains("text/html") || content_type.contains("application/xhtml")
+}
+
+/// Run a whole extraction request against a fetched page. The document is parsed once
+/// for the specs, facets and links; only readability parses it again, with its own parser.
+pub fn extract_page(html: &str, content_type: &str, url: &str, request: &ExtractionRequest) -> PageExtraction {
+    let mut result = PageExtraction::default();
+    let want_facets = request.facets && !html.is_empty() && is_html_content_type(content_type);
+    if request.specs.is_empty() && !want_facets && request.follow.is_none() {
+        return result;
+    }
+
+    let document = Html::parse_document(html);
+    if !request.specs.is_empty() || want_facets {
+        let data = DocumentData::new(&document, &request.budget);
+        if !request.specs.is_empty() {
+            result.values = Some(evaluate_specs(&document, &data, &request.specs).values);
+        }
+        if want_facets {
+            result.facets = Some(PageFacets {
+                schema: combine_schema(&data.jsonld, &data.microdata),
+                js: data.js,
+                opengraph: data.og,
+                readability: readability_within_budget(&document, html, url, &request.budget),
+            });
+        }
+    }
+    if let Some(ref selector) = request.follow {
+        result.links = Some(links_in_document(&document, selector, url));
+    }
+    result
+}
+
+/// JSON-LD items by @type, with microdata items of the same type appended
+fn combine_schema(jsonld: &HashMap<String, Value>, microdata: &HashMap<String, Value>) -> serde_json::Map<String, Value> {
+    let mut schema: serde_json::Map<String, Value> = jsonld.iter().map(|(k, v)| (k.clone(), v.clone())).collect();
+    for (type_name, items) in microdata {
+        match schema.get_mut(type_name) {
+            Some(Value::Array(existing)) => {
+                if let Value::Array(items) = items {
+                    existing.extend(items.iter().cloned());
+                }
+            }
+            Some(_) => {}
+            None => {
+                schema.insert(type_name.clone(), items.clone());
+            }
+        }
+    }
+    schema
+}
+
+fn evaluate_specs(document: &Html, data: &DocumentData, specs: &[ExtractSpec]) -> ExtractionResult {
     let mut values = HashMap::new();
     let mut expanded_values = HashMap::new();
 
-    // Pre-extract structured data once
-    let jsonld_data = extract_jsonld_objects(&document);
-    let microdata = extract_microdata(&document);
-    let og_data = extract_opengraph(&document);
-    let meta_data = extract_meta_tags(&document);
-    let js_data = extract_js_variables(&document);
-
-    for spec in &request.specs {
+    for spec in specs {
         let raw_value = extract_single(
-            &document,
+            document,
             spec,
-            &jsonld_data,
-            &microdata,
-            &og_data,
-            &meta_data,
-            &js_data,
+            &data.jsonld,
+            &data.microdata,
+            &data.og,
+            &data.meta,
+            &data.js,
         );
 
         // Handle JSON cast and array expansion
         if spec.is_json_cast || spec.expand_array {
             if let Some(ref raw) = raw_value {
-                // Parse as JSON
-                match serde_json::from_str::<Value>(raw) {
-                    Ok(json_val) => {
-                        // Navigate json_path if specified
-                        let target = if let Some(ref path) = spec.json_path {
-                            navigate_json_path(&json_val, path)
-                        } else {
-                            Some(json_val)
-                        };
-
+                // Parse as JSON; with a json_path only the target is built
+                let parsed = match spec.json_path {
+                    Some(ref path) => match lazy_json::arrow_path_segments(path) {
+                        Some(segments) => match lazy_json::select(raw, &segments) {
+                            Some(val) => Ok(Some(val)),
+                            None if lazy_json::is_valid(raw) => Ok(None),
+                            None => Err(()),
+                        },
+                        None if lazy_json::is_valid(raw) => Ok(None),
+                        None => Err(()),
+                    },
+                    None => serde_json::from_str::<Value>(raw).map(Some).map_err(|_| ()),
+                };
+                match parsed {
+                    Ok(target) => {
                         if let Some(val) = target {
                             if spec.expand_array {
                                 // Expand array into multiple values
@@ -161,57 +323,6 @@ pub fn extract_all(html: &str, request: &ExtractionRequest) -> ExtractionResult
     ExtractionResult { values, expanded_values, error: None }
 }
 
-/// Navigate a JSON value using arrow notation path
-fn navigate_json_path(value: &Value, path: &str) -> Option<Value> {
-    let mut current = value.clone();
-    let mut remaining = path.trim();
-
-    while !remaining.is_empty() {
-        // Skip arrow
-        if remaining.starts_with("->>") {
-            remaining = &remaining[3..];
-        } else if remaining.starts_with("->") {
-            remaining = &remaining[2..];
-        } else {
-            break;
-        }
-
-        remaining = remaining.trim_start();
-
-        // Extract key
-        let key = if remaining.starts_with('\'') {
-            let end = remaining[1..].find('\'')?;
-            let k = &remaining[1..=end];
-            remaining = &remaining[end + 2..];
-            k.to_string()
-        } else if remaining.starts_with('"') {
-            let end = remaining[1..].find('"')?;
-            let k = &remaining[1..=end];
-            remaining = &remaining[end + 2..];
-            k.to_string()
-        } else if remaining.starts_with('[') {
-            let end = remaining.find(']')?;
-            let idx = &remaining[1..end];
-            remaining = &remaining[end + 1..];
-            idx.to_string()
-        } else {
-            let end = remaining.find("->").unwrap_or(remaining.len());
-            let k = remaining[..end].trim();
-            remaining = &remaining[end..];
-            k.to_string()
-        };
-
-        // Navigate
-        if let Ok(idx) = key.parse::<usize>() {
-            current = current.get(idx)?.clone();
-        } else {
-            current = current.get(&key)?.clone();
-        }
-    }
-
-    Some(current)
-}
-
 /// Extract a single value based on spec
 fn extract_single(
     document: &Html,
@@ -220,7 +331,7 @@ fn extract_single(
     microdata: &HashMap<String, Value>,
     og_data: &HashMap<String, String>,
     meta_data: &HashMap<String, String>,
-    js_data: &HashMap<String, Value>,
+    js_data: &JsVariables,
 ) -> Option<String> {
     // Try main spec first
     let result = match spec.source.as_str() {
@@ -339,11 +450,22 @@ fn extract_from_jsonld(
 
 /// Extract microdata from HTML, keyed by itemtype
 /// Returns HashMap where each value is a JSON array of items with that type
-pub fn extract_microdata(document: &Html) -> HashMap<String, Value> {
+/// Over budget, the items found so far are returned with a `TRUNCATED_KEY` entry
+pub fn extract_microdata(document: &Html, budget: &ExtractionBudget) -> HashMap<String, Value> {
+    // Every item scans its whole subtree for properties
+    if budget.too_many_nodes(document) {
+        return truncated_map("max_dom_nodes");
+    }
     let mut collected: HashMap<String, Vec<Value>> = HashMap::new();
     let selector = Selector::parse("[itemscope][itemtype]").unwrap();
+    let clock = budget.clock();
+    let mut truncated = None;
 
     for element in document.select(&selector) {
+        if clock.expired() {
+            truncated = Some("max_facet_ms");
+            break;
+        }
         if let Some(itemtype) = element.value().attr("itemtype") {
             // Extract type name from URL
             let type_name = itemtype
@@ -376,10 +498,18 @@ pub fn extract_microdata(document: &Html) -> HashMap<String, Value> {
     }
 
     // Convert Vec<Value> to Value::Array for each type
-    collected
+    let mut result: HashMap<String, Value> = collected
         .into_iter()
         .map(|(k, v)| (k, Value::Array(v)))
-        .collect()
+        .collect();
+    if let Some(limit) = truncated {
+        result.insert(TRUNCATED_KEY.to_string(), Value::String(limit.to_string()));
+    }
+    result
+}
+
+fn truncated_map(limit: &str) -> HashMap<String, Value> {
+    HashMap::from([(TRUNCATED_KEY.to_string(), Value::String(limit.to_string()))])
 }
 
 /// Navigate microdata by path
@@ -466,6 +596,18 @@ pub struct ReadabilityResult {
     pub text_content: String, // Plain text content
     pub length: usize,        // Character count of text
     pub excerpt: String,      // Short excerpt/summary
+    /// The limit that skipped extraction, if any
+    #[serde(rename = "$truncated", skip_serializing_if = "Option::is_none")]
+    pub truncated: Option<String>,
+}
+
+/// Readability of an already parsed page. The readability crate cannot be interrupted,
+/// so only the DOM size gates it; an oversized page gets an empty, marked result.
+pub fn readability_within_budget(document: &Html, html: &str, url: &str, budget: &ExtractionBudget) -> ReadabilityResult {
+    if budget.too_many_nodes(document) {
+        return ReadabilityResult { truncated: Some("max_dom_nodes".to_string()), ..Default::default() };
+    }
+    extract_readability(html, url)
 }
 
 /// Extract article content using readability algorithm
@@ -495,6 +637,7 @@ pub fn extract_readability(html: &str, url: &str) -> ReadabilityResult {
                 length: text_len,
                 excerpt,
                 text_content: product.text,
+                truncated: None,
             }
         }
         Err(_) => ReadabilityResult::default(),
@@ -806,13 +949,42 @@ fn navigate_json(value: &serde_json::Value, path: &[String]) -> Option<serde_jso
     Some(current)
 }
 
+/// JS variable values, kept as their raw JSON text. Paths into them are evaluated on
+/// demand (see `lazy_json`), so a megabyte hydration object is never built as a `Value`.
+pub type JsVariables = HashMap<String, Box<RawValue>>;
+
+fn raw_json<T: Serialize>(value: &T) -> Option<Box<RawValue>> {
+    serde_json::value::to_raw_value(value).ok()
+}
+
 /// Extract JavaScript variables from script tags using AST parsing
-pub fn extract_js_variables(document: &Html) -> HashMap<String, Value> {
+///
+/// Scripts are parsed within the budget's script bytes and time; if any were skipped,
+/// the variables found are returned with a `TRUNCATED_KEY` entry.
+pub fn extract_js_variables(document: &Html, budget: &ExtractionBudget) -> JsVariables {
     let mut result = HashMap::new();
     let selector = Selector::parse("script:not([type]), script[type='text/javascript']").unwrap();
+    let clock = budget.clock();
+    let mut script_bytes = 0;
 
     for element in document.select(&selector) {
+        if clock.expired() {
+            result.extend(raw_json(&"max_facet_ms").map(|v| (TRUNCATED_KEY.to_string(), v)));
+            break;
+        }
         let script_text = element.text().collect::<String>();
+        // A script over the remaining allowance is skipped; smaller ones after it still fit
+        if budget.max_script_bytes > 0 && script_bytes + script_text.len() > budget.max_script_bytes {
+            result.extend(raw_json(&"max_script_bytes").map(|v| (TRUNCATED_KEY.to_string(), v)));
+            continue;
+        }
+        script_bytes += script_text.len();
+
+        // A lone `[window.]name = <JSON>` (the usual hydration script) needs no JS parser
+        if let Some((name, value)) = json_assignment(&script_text) {
+            result.insert(name, value);
+            continue;
+        }
 
         // Parse with SWC and extract variables
         if let Some(vars) = parse_js_and_extract_vars(&script_text) {
@@ -825,8 +997,41 @@ pub fn extract_js_variables(document: &Html) -> HashMap<String, Value> {
     result
 }
 
+/// `[var|let|const] [window.]name = <JSON>[;]` as the whole script: the name and the raw
+/// JSON, validated but not built
+fn json_assignment(source: &str) -> Option<(String, Box<RawValue>)> {
+    let mut rest = source.trim();
+    for keyword in ["var ", "let ", "const "] {
+        if let Some(stripped) = rest.strip_prefix(keyword) {
+            rest = stripped.trim_start();
+            break;
+        }
+    }
+    rest = rest.strip_prefix("window.").unwrap_or(rest);
+
+    let name_len = rest
+        .find(|c: char| !(c.is_ascii_alphanumeric() || c == '_' || c == '$'))
+        .unwrap_or(rest.len());
+    let name = &rest[..name_len];
+    if name.is_empty() || name.starts_with(|c: char| c.is_ascii_digit()) {
+        return None;
+    }
+    let value_text = rest[name_len..].trim_start().strip_prefix('=')?.trim_start();
+    if !value_text.starts_with(|c| c == '{' || c == '[') {
+        return None;
+    }
+
+    let mut values = serde_json::Deserializer::from_str(value_text).into_iter::<Box<RawValue>>();
+    let value = values.next()?.ok()?;
+    let trailing = value_text[values.byte_offset()..].trim();
+    if !trailing.is_empty() && trailing != ";" {
+        return None;
+    }
+    Some((name.to_string(), value))
+}
+
 /// Parse JavaScript source and extract variable declarations
-fn parse_js_and_extract_vars(source: &str) -> Option<HashMap<String, Value>> {
+fn parse_js_and_extract_vars(source: &str) -> Option<JsVariables> {
     let cm: Lrc<SourceMap> = Default::default();
     let fm = cm.new_source_file(FileName::Anon.into(), source.to_string());
 
@@ -845,24 +1050,39 @@ fn parse_js_and_extract_vars(source: &str) -> Option<HashMap<String, Value>> {
         Err(_) => return None,
     };
 
+    let source = ScriptSource { text: &fm.src, start: fm.start_pos };
     let mut result = HashMap::new();
 
     for stmt in &script.body {
-        extract_vars_from_stmt(stmt, &mut result);
+        extract_vars_from_stmt(stmt, &source, &mut result);
     }
 
     Some(result)
 }
 
+/// Script text, to slice expressions out of by their spans
+struct ScriptSource<'a> {
+    text: &'a str,
+    start: BytePos,
+}
+
+impl ScriptSource<'_> {
+    fn snippet(&self, span: Span) -> Option<&str> {
+        let lo = (span.lo.0.checked_sub(self.start.0)?) as usize;
+        let hi = (span.hi.0.checked_sub(self.start.0)?) as usize;
+        self.text.get(lo..hi)
+    }
+}
+
 /// Extract variable declarations from a statement
-fn extract_vars_from_stmt(stmt: &Stmt, result: &mut HashMap<String, Value>) {
+fn extract_vars_from_stmt(stmt: &Stmt, source: &ScriptSource, result: &mut JsVariables) {
     match stmt {
         Stmt::Decl(Decl::Var(var_decl)) => {
             for decl in &var_decl.decls {
                 if let Some(init) = &decl.init {
                     if let Pat::Ident(ident) = &decl.name {
                         let var_name = ident.sym.as_str().to_string();
-                        if let Some(value) = expr_to_json(init) {
+                        if let Some(value) = expr_to_raw_json(init, source) {
                             result.insert(var_name, value);
                         }
                     }
@@ -870,11 +1090,15 @@ fn extract_vars_from_stmt(stmt: &Stmt, result: &mut HashMap<String, Value>) {
             }
         }
         Stmt::Expr(expr_stmt) => {
-            // Handle: varName = value (assignment expressions)
+            // Handle: varName = value and window.varName = value (assignment expressions)
             if let Expr::Assign(assign) = &*expr_stmt.expr {
-                if let AssignTarget::Simple(SimpleAssignTarget::Ident(ident)) = &assign.left {
-                    let var_name = ident.sym.as_str().to_string();
-                    if let Some(value) = expr_to_json(&assign.right) {
+                let var_name = match &assign.left {
+                    AssignTarget::Simple(SimpleAssignTarget::Ident(ident)) => Some(ident.sym.as_str().to_string()),
+                    AssignTarget::Simple(SimpleAssignTarget::Member(member)) => window_property(member),
+                    _ => None,
+                };
+                if let Some(var_name) = var_name {
+                    if let Some(value) = expr_to_raw_json(&assign.right, source) {
                         result.insert(var_name, value);
                     }
                 }
@@ -884,6 +1108,39 @@ fn extract_vars_from_stmt(stmt: &Stmt, result: &mut HashMap<String, Value>) {
     }
 }
 
+/// `name` of a `window.name` member expression
+fn window_property(member: &MemberExpr) -> Option<String> {
+    match (&*member.obj, &member.prop) {
+        (Expr::Ident(obj), MemberProp::Ident(prop)) if obj.sym.as_ref() == "window" => {
+            Some(prop.sym.as_str().to_string())
+        }
+        _ => None,
+    }
+}
+
+/// The raw JSON of an initializer. Object and array literals that are already JSON, and
+/// JSON.parse('...') payloads, are only validated; anything else goes through the AST.
+fn expr_to_raw_json(expr: &Expr, source: &ScriptSource) -> Option<Box<RawValue>> {
+    match expr {
+        Expr::Object(ObjectLit { span, .. }) | Expr::Array(ArrayLit { span, .. }) => {
+            if let Some(raw) = source.snippet(*span).and_then(|text| serde_json::from_str::<Box<RawValue>>(text).ok()) {
+                return Some(raw);
+            }
+        }
+        Expr::Call(call) if is_json_parse_call(call) => {
+            if let Some(ExprOrSpread { expr: arg, .. }) = call.args.first() {
+                if let Expr::Lit(Lit::Str(s)) = &**arg {
+                    if let Some(raw) = s.value.as_str().and_then(|text| RawValue::from_string(text.to_string()).ok()) {
+                        return Some(raw);
+                    }
+                }
+            }
+        }
+        _ => {}
+    }
+    expr_to_json(expr).and_then(|value| raw_json(&value))
+}
+
 /// Convert a JavaScript expression to a JSON Value
 fn expr_to_json(expr: &Expr) -> Option<Value> {
     match expr {
@@ -1008,9 +1265,9 @@ fn prop_name_to_string(name: &PropName) -> Option<String> {
     }
 }
 
-/// Navigate JS variable data by path
+/// Navigate JS variable data by path, reading only the target out of the raw JSON
 fn extract_from_js(
-    data: &HashMap<String, Value>,
+    data: &JsVariables,
     path: &[String],
     return_text: bool,
 ) -> Option<String> {
@@ -1020,18 +1277,11 @@ fn extract_from_js(
 
     // First segment is the variable name
     let var_name = &path[0];
-    let obj = data.get(var_name)?;
+    let raw = data.get(var_name)?;
 
-    // Navigate remaining path
-    let mut current = obj;
-    for segment in path.iter().skip(1) {
-        // Try as object key first, then as array index
-        current = current.get(segment).or_else(|| {
-            segment.parse::<usize>().ok().and_then(|idx| current.get(idx))
-        })?;
-    }
-
-    value_to_string(current, return_text)
+    // Segments are object keys, or indexes into arrays
+    let value = lazy_json::select(raw.get(), &path[1..])?;
+    value_to_string(&value, return_text)
 }
 
 /// Convert JSON value to string
@@ -1061,6 +1311,9 @@ pub struct TableExtractionResult {
     /// Error if extraction failed
     #[serde(skip_serializing_if = "Option::is_none")]
     pub error: Option<String>,
+    /// The limit that cut the rows short, if any
+    #[serde(rename = "$truncated", skip_serializing_if = "Option::is_none")]
+    pub truncated: Option<String>,
 }
 
 /// Extract an HTML table or list using CSS selector
@@ -1068,7 +1321,14 @@ pub struct TableExtractionResult {
 /// Supports: table, ul, ol elements
 /// If is_wikipedia is true, removes citation references from cells
 /// table_index: 0 = first match (default), 1 = second match, etc.
-pub fn extract_table(html: &str, selector: &str, is_wikipedia: bool, table_index: usize) -> TableExtractionResult {
+/// Rows stop at the budget's table cells or facet time (see `truncated`)
+pub fn extract_table(
+    html: &str,
+    selector: &str,
+    is_wikipedia: bool,
+    table_index: usize,
+    budget: &ExtractionBudget,
+) -> TableExtractionResult {
     let document = Html::parse_document(html);
 
     // Parse selector
@@ -1081,6 +1341,7 @@ pub fn extract_table(html: &str, selector: &str, is_wikipedia: bool, table_index
                 num_columns: 0,
                 num_rows: 0,
                 error: Some(format!("Invalid CSS selector: {:?}", e)),
+                truncated: None,
             };
         }
     };
@@ -1099,6 +1360,7 @@ pub fn extract_table(html: &str, selector: &str, is_wikipedia: bool, table_index
                     "No element found at index {} (found {} matching '{}')",
                     table_index, total, selector
                 )),
+                truncated: None,
             };
         }
     };
@@ -1108,20 +1370,25 @@ pub fn extract_table(html: &str, selector: &str, is_wikipedia: bool, table_index
 
     // Handle list elements (ul, ol)
     if tag_name == "ul" || tag_name == "ol" {
-        return extract_list_as_table(element, is_wikipedia);
+        return extract_list_as_table(element, is_wikipedia, budget);
     }
 
     // Handle table elements
-    extract_table_element(element, is_wikipedia)
+    extract_table_element(element, is_wikipedia, budget)
 }
 
 /// Extract a list (ul/ol) as a single-column table
-fn extract_list_as_table(list: scraper::ElementRef, is_wikipedia: bool) -> TableExtractionResult {
+fn extract_list_as_table(list: scraper::ElementRef, is_wikipedia: bool, budget: &ExtractionBudget) -> TableExtractionResult {
     let li_sel = Selector::parse("li").unwrap();
+    let mut limiter = RowLimiter::new(budget);
 
-    let rows: Vec<Vec<String>> = list.select(&li_sel)
-        .map(|li| vec![extract_cell_text(li, is_wikipedia)])
-        .collect();
+    let mut rows: Vec<Vec<String>> = Vec::new();
+    for li in list.select(&li_sel) {
+        if !limiter.admit(1) {
+            break;
+        }
+        rows.push(vec![extract_cell_text(li, is_wikipedia)]);
+    }
 
     let num_rows = rows.len();
 
@@ -1131,11 +1398,41 @@ fn extract_list_as_table(list: scraper::ElementRef, is_wikipedia: bool) -> Table
         num_columns: 1,
         num_rows,
         error: None,
+        truncated: limiter.truncated.map(String::from),
+    }
+}
+
+/// Admits table rows while the budget's cells and facet time last
+struct RowLimiter {
+    clock: FacetClock,
+    max_cells: usize,
+    cells: usize,
+    truncated: Option<&'static str>,
+}
+
+impl RowLimiter {
+    fn new(budget: &ExtractionBudget) -> Self {
+        RowLimiter { clock: budget.clock(), max_cells: budget.max_table_cells, cells: 0, truncated: None }
+    }
+
+    /// Whether a row of `cells` cells fits; once one does not, no later row does
+    fn admit(&mut self, cells: usize) -> bool {
+        if self.truncated.is_some() {
+            return false;
+        }
+        if self.max_cells > 0 && self.cells + cells > self.max_cells {
+            self.truncated = Some("max_table_cells");
+        } else if self.clock.expired() {
+            self.truncated = Some("max_facet_ms");
+        } else {
+            self.cells += cells;
+        }
+        self.truncated.is_none()
     }
 }
 
 /// Extract a table element
-fn extract_table_element(table: scraper::ElementRef, is_wikipedia: bool) -> TableExtractionResult {
+fn extract_table_element(table: scraper::ElementRef, is_wikipedia: bool, budget: &ExtractionBudget) -> TableExtractionResult {
     // Try to extract headers from thead > tr > th, or first tr > th
     let mut headers: Vec<String> = Vec::new();
 
@@ -1167,6 +1464,7 @@ fn extract_table_element(table: scraper::ElementRef, is_wikipedia: bool) -> Tabl
 
     // Extract data rows - try tbody tr first, then just tr
     let mut rows: Vec<Vec<String>> = Vec::new();
+    let mut limiter = RowLimiter::new(budget);
     let row_selector = Selector::parse("tbody tr").ok()
         .or_else(|| Selector::parse("tr").ok());
 
@@ -1183,6 +1481,9 @@ fn extract_table_element(table: scraper::ElementRef, is_wikipedia: bool) -> Tabl
             if tds.is_empty() && !ths.is_empty() {
                 continue;
             }
+            if !limiter.admit(tds.len().max(ths.len())) {
+                break;
+            }
 
             // Extract cell values (prefer td, fall back to th)
             let cells: Vec<String> = if !tds.is_empty() {
@@ -1222,6 +1523,7 @@ fn extract_table_element(table: scraper::ElementRef, is_wikipedia: bool) -> Tabl
         num_columns,
         num_rows,
         error: None,
+        truncated: limiter.truncated.map(String::from),
     }
 }
 
@@ -1274,6 +1576,10 @@ fn extract_text_excluding_citations(element: scraper::ElementRef, parts: &mut Ve
 /// Returns a list of absolute URLs
 pub fn extract_links(html: &str, selector: &str, base_url: &str) -> Vec<String> {
     let document = Html::parse_document(html);
+    links_in_document(&document, selector, base_url)
+}
+
+fn links_in_document(document: &Html, selector: &str, base_url: &str) -> Vec<String> {
     let mut links = Vec::new();
 
     // Parse the base URL for resolving relative links
@@ -1439,6 +1745,7 @@ fn test_full_extraction() {
                 json_path: None,
             },
         ],
+        ..Default::default()
     };
 
     let result = extract_all(html, &request);
@@ -1550,6 +1857,11 @@ fn test_attribute_selectors() {
     assert_eq!(complex, Some("Item 3".to_string()));
 }
 
+#[cfg(test)]
+fn js_value(vars: &JsVariables, name: &str) -> Value {
+    serde_json::from_str(vars[name].get()).unwrap()
+}
+
 #[test]
 fn test_js_extraction_json_parse() {
     let html = r#"
@@ -1565,22 +1877,22 @@ fn test_js_extraction_json_parse() {
     "#;
 
     let document = Html::parse_document(html);
-    let js_vars = extract_js_variables(&document);
+    let js_vars = extract_js_variables(&document, &ExtractionBudget::default());
 
     // Test JSON.parse extraction
     assert!(js_vars.contains_key("jobs"));
-    let jobs = &js_vars["jobs"];
+    let jobs = js_value(&js_vars, "jobs");
     assert!(jobs.is_array());
     assert_eq!(jobs[0]["id"], "123");
     assert_eq!(jobs[0]["title"], "Developer");
 
     // Test simple string extraction
     assert!(js_vars.contains_key("page_id"));
-    assert_eq!(js_vars["page_id"], "900000000022233");
+    assert_eq!(js_value(&js_vars, "page_id"), "900000000022233");
 
     // Test object literal extraction
     assert!(js_vars.contains_key("meta"));
-    let meta = &js_vars["meta"];
+    let meta = js_value(&js_vars, "meta");
     assert_eq!(meta["org_info"]["company_name"], "Test Corp");
     assert_eq!(meta["page_id"], "abc");
 }
@@ -1598,30 +1910,60 @@ fn test_js_extraction_escaped_strings() {
     "#;
 
     let document = Html::parse_document(html);
-    let js_vars = extract_js_variables(&document);
+    let js_vars = extract_js_variables(&document, &ExtractionBudget::default());
 
     assert!(js_vars.contains_key("data"));
-    let data = &js_vars["data"];
+    let data = js_value(&js_vars, "data");
     assert_eq!(data[0]["name"], "Test");
 }
 
+#[test]
+fn test_js_extraction_hydration_assignments() {
+    let html = r#"
+    <html>
+    <head>
+        <script>window.__INITIAL_STATE__ = {"user": {"name": "Ann"}, "items": [1, 2]};</script>
+        <script>
+        window.__APOLLO_STATE__ = {"ROOT_QUERY": {"id": 7}};
+        var config = {debug: true, 'level': 2};
+        </script>
+    </head>
+    </html>
+    "#;
+
+    let document = Html::parse_document(html);
+    let js_vars = extract_js_variables(&document, &ExtractionBudget::default());
+
+    // The single-assignment script is kept as its raw JSON text
+    assert_eq!(js_vars["__INITIAL_STATE__"].get(), r#"{"user": {"name": "Ann"}, "items": [1, 2]}"#);
+    let path = ["__INITIAL_STATE__".to_string(), "user".to_string(), "name".to_string()];
+    assert_eq!(extract_from_js(&js_vars, &path, true), Some("Ann".to_string()));
+
+    // window.X assignments inside larger scripts, and literals that are not JSON
+    assert_eq!(js_value(&js_vars, "__APOLLO_STATE__")["ROOT_QUERY"]["id"], 7);
+    assert_eq!(js_value(&js_vars, "config"), serde_json::json!({"debug": true, "level": 2}));
+
+    assert!(json_assignment("window.state = {\"a\": 1}; render();").is_none());
+    assert!(json_assignment("var n = 1;").is_none());
+}
+
 #[test]
 fn test_extract_from_js() {
     let mut js_data = HashMap::new();
     js_data.insert(
         "meta".to_string(),
-        serde_json::json!({
+        raw_json(&serde_json::json!({
             "org_info": {
                 "company_name": "Test Corp"
             }
-        }),
+        })).unwrap(),
     );
     js_data.insert(
         "jobs".to_string(),
-        serde_json::json!([
+        raw_json(&serde_json::json!([
             {"id": "1", "title": "Dev"},
             {"id": "2", "title": "Designer"}
-        ]),
+        ])).unwrap(),
     );
 
     // Navigate nested object
@@ -1675,6 +2017,39 @@ fn test_extract_links() {
     assert!(!links.iter().any(|l| l.contains("#anchor")));
 }
 
+#[test]
+fn test_extract_page_single_parse_plan() {
+    let html = r#"<html><head>
+        <meta property="og:title" content="Widget">
+        <script type="application/ld+json">{"@type": "Product", "name": "Widget"}</script>
+    </head><body>
+        <div itemscope itemtype="https://schema.org/Product"><span itemprop="name">Widget B</span></div>
+        <div itemscope itemtype="https://schema.org/Offer"><span itemprop="price">5</span></div>
+        <a href="/next">Next</a>
+    </body></html>"#;
+
+    let request: ExtractionRequest = serde_json::from_str(
+        r#"{"specs": [{"source": "og", "path": ["title"], "alias": "title", "return_text": true}],
+            "facets": true, "follow": "a[href]"}"#,
+    )
+    .unwrap();
+    let page = extract_page(html, "text/html; charset=utf-8", "https://shop.example/item", &request);
+
+    assert_eq!(page.values.unwrap()["title"].as_deref(), Some("Widget"));
+    assert_eq!(page.links.unwrap(), vec!["https://shop.example/next".to_string()]);
+    let facets = page.facets.unwrap();
+    assert_eq!(facets.opengraph["title"], "Widget");
+    // Microdata items are appended to JSON-LD items of the same type
+    assert_eq!(facets.schema["Product"].as_array().unwrap().len(), 2);
+    assert!(facets.schema.contains_key("Offer"));
+
+    // Facets are only computed for HTML; nothing requested means no parse at all
+    let page = extract_page(html, "application/json", "https://shop.example/item", &request);
+    assert!(page.facets.is_none());
+    let page = extract_page(html, "text/html", "https://shop.example/item", &ExtractionRequest::default());
+    assert!(page.values.is_none() && page.facets.is_none() && page.links.is_none());
+}
+
 #[test]
 fn test_extract_table_basic() {
     let html = r#"
@@ -1693,7 +2068,7 @@ fn test_extract_table_basic() {
     </html>
     "#;
 
-    let result = extract_table(html, "table#data", false);
+    let result = extract_table(html, "table#data", false, 0, &ExtractionBudget::default());
 
     assert!(result.error.is_none());
     assert_eq!(result.headers, vec!["Name", "Value"]);
@@ -1729,7 +2104,7 @@ fn test_extract_table_wikipedia_citations_removed() {
     "##;
 
     // Test WITH Wikipedia mode (citations should be removed)
-    let result_wiki = extract_table(html, "table.wikitable", true);
+    let result_wiki = extract_table(html, "table.wikitable", true, 0, &ExtractionBudget::default());
 
     assert!(result_wiki.error.is_none());
     assert_eq!(result_wiki.headers, vec!["Building", "Cost"]);
@@ -1739,9 +2114,49 @@ fn test_extract_table_wikipedia_citations_removed() {
     assert_eq!(result_wiki.rows[1][1], "10.5");  // No citation numbers!
 
     // Test WITHOUT Wikipedia mode (citations should be preserved in text)
-    let result_normal = extract_table(html, "table.wikitable", false);
+    let result_normal = extract_table(html, "table.wikitable", false, 0, &ExtractionBudget::default());
 
     assert!(result_normal.error.is_none());
     // Normal mode includes the citation text
     assert!(result_normal.rows[0][1].contains("[15]") || result_normal.rows[0][1].contains("15"));
 }
+
+#[test]
+fn test_extraction_budget_truncates_facets() {
+    let html = r#"<html><head>
+        <script>var big = "0123456789012345678901234567890123456789";</script>
+        <script>var small = 1;</script>
+    </head><body>
+        <div itemscope itemtype="https://schema.org/Product"><span itemprop="name">Widget</span></div>
+        <table><tr><td>a</td><td>b</td></tr><tr><td>c</td><td>d</td></tr><tr><td>e</td><td>f</td></tr></table>
+    </body></html>"#;
+    let document = Html::parse_document(html);
+
+    // The oversized script is skipped and marked; the small one after it still fits
+    let budget = ExtractionBudget { max_script_bytes: 32, ..Default::default() };
+    let js = extract_js_variables(&document, &budget);
+    assert!(!js.contains_key("big"));
+    assert_eq!(js_value(&js, "small"), 1);
+    assert_eq!(js_value(&js, TRUNCATED_KEY), "max_script_bytes");
+
+    // Rows stop at the cell budget
+    let budget = ExtractionBudget { max_table_cells: 4, ..Default::default() };
+    let table = extract_table(html, "table", false, 0, &budget);
+    assert_eq!(table.rows.len(), 2);
+    assert_eq!(table.truncated.as_deref(), Some("max_table_cells"));
+
+    // Oversized DOMs skip the DOM-walking facets
+    let budget = ExtractionBudget { max_dom_nodes: 5, ..Default::default() };
+    let microdata = extract_microdata(&document, &budget);
+    assert_eq!(microdata.len(), 1);
+    assert_eq!(microdata[TRUNCATED_KEY], "max_dom_nodes");
+    let readability = readability_within_budget(&document, html, "https://a.example/", &budget);
+    assert_eq!(readability.truncated.as_deref(), Some("max_dom_nodes"));
+
+    // The default budget is unlimited and leaves no marker
+    let js = extract_js_variables(&document, &ExtractionBudget::default());
+    assert!(js.contains_key("big") && !js.contains_key(TRUNCATED_KEY));
+    let budget = ExtractionBudget::from_json(r#"{"max_script_bytes": 32}"#);
+    assert_eq!(budget.max_script_bytes, 32);
+    assert_eq!(budget.max_dom_nodes, 0);
+}
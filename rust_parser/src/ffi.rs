@@ -1,6 +1,10 @@
 //! C FFI interface for the HTML parser
 
-use crate::extractors::{extract_all, ExtractionRequest};
+use crate::charset::decode_body;
+use crate::compression::{self, StoreCompressed};
+use crate::compute_pool::{self, ComputeLimiter};
+use base64::Engine;
+use crate::extractors::{extract_all, extract_page, ExtractionBudget, ExtractionRequest, PageFacets};
 use std::ffi::{c_char, CStr, CString};
 use std::ptr;
 use std::sync::atomic::{AtomicBool, Ordering};
@@ -122,6 +126,14 @@ fn string_to_ptr(s: String) -> *mut c_char {
     }
 }
 
+/// Extraction budget passed as JSON (null, empty or invalid = unlimited)
+unsafe fn budget_from_ptr(budget_ptr: *const c_char) -> ExtractionBudget {
+    if budget_ptr.is_null() {
+        return ExtractionBudget::default();
+    }
+    ExtractionBudget::from_json(CStr::from_ptr(budget_ptr).to_str().unwrap_or(""))
+}
+
 /// Get version string
 #[no_mangle]
 pub extern "C" fn rust_parser_version() -> *const c_char {
@@ -167,6 +179,7 @@ pub unsafe extern "C" fn extract_jsonld_ffi(
 pub unsafe extern "C" fn extract_microdata_ffi(
     html_ptr: *const c_char,
     html_len: usize,
+    budget_ptr: *const c_char,
 ) -> ExtractionResultFFI {
     let html = match std::str::from_utf8(std::slice::from_raw_parts(html_ptr as *const u8, html_len)) {
         Ok(s) => s,
@@ -179,7 +192,7 @@ pub unsafe extern "C" fn extract_microdata_ffi(
     };
 
     let document = scraper::Html::parse_document(html);
-    let microdata = crate::extractors::extract_microdata(&document);
+    let microdata = crate::extractors::extract_microdata(&document, &budget_from_ptr(budget_ptr));
 
     match serde_json::to_string(&microdata) {
         Ok(json) => ExtractionResultFFI {
@@ -229,6 +242,7 @@ pub unsafe extern "C" fn extract_opengraph_ffi(
 pub unsafe extern "C" fn extract_js_ffi(
     html_ptr: *const c_char,
     html_len: usize,
+    budget_ptr: *const c_char,
 ) -> ExtractionResultFFI {
     let html = match std::str::from_utf8(std::slice::from_raw_parts(html_ptr as *const u8, html_len)) {
         Ok(s) => s,
@@ -241,7 +255,7 @@ pub unsafe extern "C" fn extract_js_ffi(
     };
 
     let document = scraper::Html::parse_document(html);
-    let js_vars = crate::extractors::extract_js_variables(&document);
+    let js_vars = crate::extractors::extract_js_variables(&document, &budget_from_ptr(budget_ptr));
 
     match serde_json::to_string(&js_vars) {
         Ok(json) => ExtractionResultFFI {
@@ -261,6 +275,7 @@ pub unsafe extern "C" fn extract_readability_ffi(
     html_ptr: *const c_char,
     html_len: usize,
     url_ptr: *const c_char,
+    budget_ptr: *const c_char,
 ) -> ExtractionResultFFI {
     let html = match std::str::from_utf8(std::slice::from_raw_parts(html_ptr as *const u8, html_len)) {
         Ok(s) => s,
@@ -282,7 +297,14 @@ pub unsafe extern "C" fn extract_readability_ffi(
         }
     };
 
-    let result = crate::extractors::extract_readability(html, url);
+    // The DOM size gate needs a parse of its own; skip it without a node limit
+    let budget = budget_from_ptr(budget_ptr);
+    let result = if budget.max_dom_nodes > 0 {
+        let document = scraper::Html::parse_document(html);
+        crate::extractors::readability_within_budget(&document, html, url, &budget)
+    } else {
+        crate::extractors::extract_readability(html, url)
+    };
 
     match serde_json::to_string(&result) {
         Ok(json) => ExtractionResultFFI {
@@ -519,6 +541,7 @@ pub unsafe extern "C" fn extract_table_ffi(
     selector_ptr: *const c_char,
     url_ptr: *const c_char,
     table_index: usize,
+    budget_ptr: *const c_char,
 ) -> ExtractionResultFFI {
     let html = match std::str::from_utf8(std::slice::from_raw_parts(html_ptr as *const u8, html_len)) {
         Ok(s) => s,
@@ -548,7 +571,7 @@ pub unsafe extern "C" fn extract_table_ffi(
     // Detect Wikipedia pages for special handling
     let is_wikipedia = url.contains("wikipedia.org");
 
-    let result = crate::extractors::extract_table(html, selector, is_wikipedia, table_index);
+    let result = crate::extractors::extract_table(html, selector, is_wikipedia, table_index, &budget_from_ptr(budget_ptr));
 
     match serde_json::to_string(&result) {
         Ok(json) => ExtractionResultFFI {
@@ -562,6 +585,228 @@ pub unsafe extern "C" fn extract_table_ffi(
     }
 }
 
+/// FFI-safe columnar table (see extract_table_columnar_ffi)
+#[repr(C)]
+pub struct ColumnarTableFFI {
+    /// All header and cell bytes, headers first, then column by column (not null-terminated)
+    pub data_ptr: *mut u8,
+    pub data_len: usize,
+    /// Byte offsets into data: num_columns + 1 header offsets, then num_rows + 1 per column
+    pub offsets_ptr: *mut u64,
+    pub offsets_len: usize,
+    pub num_columns: usize,
+    pub num_rows: usize,
+    /// Error message if extraction failed
+    pub error_ptr: *mut c_char,
+}
+
+impl ColumnarTableFFI {
+    fn from_error(message: String) -> Self {
+        ColumnarTableFFI {
+            data_ptr: ptr::null_mut(),
+            data_len: 0,
+            offsets_ptr: ptr::null_mut(),
+            offsets_len: 0,
+            num_columns: 0,
+            num_rows: 0,
+            error_ptr: string_to_ptr(message),
+        }
+    }
+}
+
+/// Pack headers and rows into one byte buffer plus offsets, column by column.
+/// Short rows are padded with empty cells; cells beyond num_columns are dropped.
+fn pack_columnar(result: &crate::extractors::TableExtractionResult) -> (Vec<u8>, Vec<u64>) {
+    let num_columns = result.num_columns;
+    let num_rows = result.rows.len();
+    let total: usize = result.headers.iter().map(|h| h.len()).sum::<usize>()
+        + result.rows.iter().flat_map(|r| r.iter().take(num_columns)).map(|c| c.len()).sum::<usize>();
+
+    let mut data = Vec::with_capacity(total);
+    let mut offsets = Vec::with_capacity((num_columns + 1) * (num_rows + 2));
+
+    offsets.push(0u64);
+    for col in 0..num_columns {
+        if let Some(header) = result.headers.get(col) {
+            data.extend_from_slice(header.as_bytes());
+        }
+        offsets.push(data.len() as u64);
+    }
+
+    for col in 0..num_columns {
+        offsets.push(data.len() as u64);
+        for row in &result.rows {
+            if let Some(cell) = row.get(col) {
+                data.extend_from_slice(cell.as_bytes());
+            }
+            offsets.push(data.len() as u64);
+        }
+    }
+
+    (data, offsets)
+}
+
+/// Extract HTML table in columnar form, avoiding JSON serialization of every cell.
+/// Header c spans data[offsets[c]..offsets[c + 1]]; cell (row r, column c) spans
+/// data[offsets[base + r]..offsets[base + r + 1]] with base = (num_columns + 1) + c * (num_rows + 1).
+///
+/// # Safety
+/// Same inputs as extract_table_ffi. Caller must free the result with free_columnar_table.
+#[no_mangle]
+pub unsafe extern "C" fn extract_table_columnar_ffi(
+    html_ptr: *const c_char,
+    html_len: usize,
+    selector_ptr: *const c_char,
+    url_ptr: *const c_char,
+    table_index: usize,
+    budget_ptr: *const c_char,
+) -> ColumnarTableFFI {
+    let html = match std::str::from_utf8(std::slice::from_raw_parts(html_ptr as *const u8, html_len)) {
+        Ok(s) => s,
+        Err(e) => return ColumnarTableFFI::from_error(format!("Invalid UTF-8: {}", e)),
+    };
+
+    let selector = match CStr::from_ptr(selector_ptr).to_str() {
+        Ok(s) => s,
+        Err(e) => return ColumnarTableFFI::from_error(format!("Invalid selector: {}", e)),
+    };
+
+    let url = match CStr::from_ptr(url_ptr).to_str() {
+        Ok(s) => s,
+        Err(_) => "",
+    };
+
+    // Detect Wikipedia pages for special handling
+    let is_wikipedia = url.contains("wikipedia.org");
+
+    let result = crate::extractors::extract_table(html, selector, is_wikipedia, table_index, &budget_from_ptr(budget_ptr));
+    if let Some(error) = result.error {
+        return ColumnarTableFFI::from_error(error);
+    }
+
+    let (data, offsets) = pack_columnar(&result);
+    let data_len = data.len();
+    let offsets_len = offsets.len();
+    let data = Box::into_raw(data.into_boxed_slice());
+    let offsets = Box::into_raw(offsets.into_boxed_slice());
+
+    ColumnarTableFFI {
+        data_ptr: data as *mut u8,
+        data_len,
+        offsets_ptr: offsets as *mut u64,
+        offsets_len,
+        num_columns: result.num_columns,
+        num_rows: result.rows.len(),
+        error_ptr: ptr::null_mut(),
+    }
+}
+
+/// Free a table returned by extract_table_columnar_ffi
+///
+/// # Safety
+/// Must only be called once with a result from extract_table_columnar_ffi
+#[no_mangle]
+pub unsafe extern "C" fn free_columnar_table(table: ColumnarTableFFI) {
+    if !table.data_ptr.is_null() {
+        drop(Box::from_raw(ptr::slice_from_raw_parts_mut(table.data_ptr, table.data_len)));
+    }
+    if !table.offsets_ptr.is_null() {
+        drop(Box::from_raw(ptr::slice_from_raw_parts_mut(table.offsets_ptr, table.offsets_len)));
+    }
+    if !table.error_ptr.is_null() {
+        drop(CString::from_raw(table.error_ptr));
+    }
+}
+
+// ============================================================================
+// Per-query cancellation
+// ============================================================================
+
+/// Probe polled by in-flight work; returns true once the owning query is gone
+/// (interrupted by DuckDB, LIMIT satisfied, ...)
+pub type CancelProbeFn = unsafe extern "C" fn(*mut std::ffi::c_void) -> bool;
+
+/// Cancellation token owned by a single query. Unlike INTERRUPTED, cancelling it
+/// only stops the crawl that was started with it.
+pub struct CancelToken {
+    cancelled: AtomicBool,
+    probe: Option<CancelProbeFn>,
+    probe_data: *mut std::ffi::c_void,
+}
+
+// The probe data is owned by C++ and only read through the (thread-safe) probe
+unsafe impl Send for CancelToken {}
+unsafe impl Sync for CancelToken {}
+
+impl CancelToken {
+    pub fn is_cancelled(&self) -> bool {
+        if self.cancelled.load(Ordering::SeqCst) {
+            return true;
+        }
+        if let Some(probe) = self.probe {
+            if unsafe { probe(self.probe_data) } {
+                self.cancelled.store(true, Ordering::SeqCst);
+                return true;
+            }
+        }
+        false
+    }
+
+    /// Resolve once the token is cancelled
+    pub async fn cancelled(&self) {
+        while !self.is_cancelled() {
+            tokio::time::sleep(Duration::from_millis(20)).await;
+        }
+    }
+}
+
+/// Create a cancellation token (free with cancel_token_free)
+///
+/// `probe` may be null; otherwise it is called with `probe_data` from crawl
+/// worker threads and must be thread-safe.
+#[no_mangle]
+pub extern "C" fn cancel_token_new(
+    probe: Option<CancelProbeFn>,
+    probe_data: *mut std::ffi::c_void,
+) -> *mut CancelToken {
+    Box::into_raw(Box::new(CancelToken {
+        cancelled: AtomicBool::new(false),
+        probe,
+        probe_data,
+    }))
+}
+
+/// Cancel a token; running crawls using it stop promptly
+///
+/// # Safety
+/// `token` must be null or a live pointer from cancel_token_new
+#[no_mangle]
+pub unsafe extern "C" fn cancel_token_cancel(token: *const CancelToken) {
+    if let Some(token) = token.as_ref() {
+        token.cancelled.store(true, Ordering::SeqCst);
+    }
+}
+
+/// Check whether a token was cancelled (explicitly or via its probe)
+///
+/// # Safety
+/// `token` must be null or a live pointer from cancel_token_new
+#[no_mangle]
+pub unsafe extern "C" fn cancel_token_is_cancelled(token: *const CancelToken) -> bool {
+    token.as_ref().map_or(false, |t| t.is_cancelled())
+}
+
+/// Free a token. No crawl may still be using it.
+///
+/// # Safety
+/// `token` must be null or a pointer from cancel_token_new, freed only once
+#[no_mangle]
+pub unsafe extern "C" fn cancel_token_free(token: *mut CancelToken) {
+    if !token.is_null() {
+        drop(Box::from_raw(token));
+    }
+}
+
 // ============================================================================
 // Batch Crawl + Extract (HTTP in Rust)
 // ============================================================================
@@ -594,6 +839,14 @@ struct BatchCrawlRequest {
     http_proxy_password: Option<String>,
     #[serde(default)]
     extra_headers: Option<std::collections::HashMap<String, String>>, // Extra HTTP headers
+    #[serde(default)]
+    store_compressed: StoreCompressed, // Keep the origin's compressed bytes
+    #[serde(default)]
+    probe: bool, // Headers only: HEAD, falling back to a one-byte range GET
+    #[serde(default)]
+    head_only: bool, // Stop reading HTML bodies at the end of <head>
+    #[serde(default)]
+    compute_threads: usize, // Decode/extract jobs in flight on the compute pool (0 = one per core)
 }
 
 fn default_user_agent() -> String {
@@ -629,6 +882,29 @@ struct CrawlResult {
     error: Option<String>,
     extracted: Option<serde_json::Value>,
     response_time_ms: u64,
+    /// Content-Encoding of compressed_body (store_compressed only)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    content_encoding: Option<String>,
+    /// Base64 of the body exactly as received (store_compressed only)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    compressed_body: Option<String>,
+    /// Resource size from Content-Length or Content-Range (probe only)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    content_length: Option<u64>,
+    /// Body bytes read off the connection, before any Content-Encoding is undone
+    #[serde(skip_serializing_if = "Option::is_none")]
+    transfer_size: Option<u64>,
+    /// Validators for freshness checks (probe only)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    etag: Option<String>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    last_modified: Option<String>,
+    /// html facets of an HTML page (extraction.facets only)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    facets: Option<PageFacets>,
+    /// Links matching extraction.follow, resolved against the URL
+    #[serde(skip_serializing_if = "Option::is_none")]
+    links: Option<Vec<String>>,
 }
 
 /// Batch crawl response
@@ -637,13 +913,193 @@ struct BatchCrawlResponse {
     results: Vec<CrawlResult>,
 }
 
+/// Status codes servers answer HEAD with when they only implement GET
+fn head_rejected(status: reqwest::StatusCode) -> bool {
+    matches!(status.as_u16(), 400 | 403 | 405 | 501)
+}
+
+fn header_string(headers: &reqwest::header::HeaderMap, name: reqwest::header::HeaderName) -> Option<String> {
+    headers.get(name).and_then(|v| v.to_str().ok()).map(|v| v.to_string())
+}
+
+/// Resource size of a probe response: the total of a Content-Range ("bytes 0-0/12345"),
+/// else Content-Length
+fn probe_content_length(headers: &reqwest::header::HeaderMap) -> Option<u64> {
+    if let Some(range) = header_string(headers, reqwest::header::CONTENT_RANGE) {
+        return range.rsplit('/').next().and_then(|total| total.trim().parse().ok());
+    }
+    header_string(headers, reqwest::header::CONTENT_LENGTH).and_then(|len| len.trim().parse().ok())
+}
+
+/// Probe a URL for status and validators without downloading the body: HEAD first,
+/// then a one-byte range GET if the server rejects HEAD. Identity encoding keeps the
+/// reported length the resource size.
+async fn probe_url(client: &reqwest::Client, url: String, start: std::time::Instant) -> CrawlResult {
+    use reqwest::header::{ACCEPT_ENCODING, RANGE};
+
+    let mut sent = client.head(&url).header(ACCEPT_ENCODING, "identity").send().await;
+    if matches!(&sent, Ok(response) if head_rejected(response.status())) {
+        sent = client
+            .get(&url)
+            .header(ACCEPT_ENCODING, "identity")
+            .header(RANGE, "bytes=0-0")
+            .send()
+            .await;
+    }
+
+    match sent {
+        // The response is dropped unread: at most one body byte is transferred
+        Ok(response) => {
+            let headers = response.headers();
+            // 206 only answers our range request; the resource itself is fine
+            let status = match response.status().as_u16() {
+                206 => 200,
+                code => code as i32,
+            };
+            CrawlResult {
+                url,
+                status,
+                content_type: header_string(headers, reqwest::header::CONTENT_TYPE).unwrap_or_default(),
+                body: String::new(),
+                error: None,
+                extracted: None,
+                response_time_ms: start.elapsed().as_millis() as u64,
+                content_encoding: None,
+                compressed_body: None,
+                content_length: probe_content_length(headers),
+                transfer_size: None,
+                etag: header_string(headers, reqwest::header::ETAG),
+                last_modified: header_string(headers, reqwest::header::LAST_MODIFIED),
+                facets: None,
+                links: None,
+            }
+        }
+        Err(e) => CrawlResult {
+            url,
+            status: 0,
+            content_type: String::new(),
+            body: String::new(),
+            error: Some(e.to_string()),
+            extracted: None,
+            response_time_ms: start.elapsed().as_millis() as u64,
+            content_encoding: None,
+            compressed_body: None,
+            content_length: None,
+            transfer_size: None,
+            etag: None,
+            last_modified: None,
+            facets: None,
+            links: None,
+        },
+    }
+}
+
+/// A response body after decoding and extraction
+struct ProcessedBody {
+    body: String,
+    error: Option<String>,
+    extracted: Option<serde_json::Value>,
+    facets: Option<PageFacets>,
+    links: Option<Vec<String>>,
+    content_encoding: Option<String>,
+    compressed_body: Option<String>,
+}
+
+/// The CPU-bound half of a fetch: decompress, decode to UTF-8 and extract
+fn process_body(
+    url: &str,
+    bytes: Vec<u8>,
+    content_type: &str,
+    content_encoding: String,
+    store_compressed: StoreCompressed,
+    extraction: Option<&ExtractionRequest>,
+) -> ProcessedBody {
+    let mut error = None;
+    let mut compressed = None;
+    let keep_raw = store_compressed != StoreCompressed::Off && !compression::is_identity(&content_encoding);
+    let body = if compression::is_identity(&content_encoding) {
+        decode_body(bytes, content_type)
+    } else if !keep_raw {
+        // The client never inflates, so undo the coding here
+        match compression::decompress(&content_encoding, &bytes) {
+            Ok(inflated) => decode_body(inflated, content_type),
+            Err(e) => {
+                error = Some(format!("Decompression error: {}", e));
+                String::new()
+            }
+        }
+    } else {
+        // Raw mode: keep the body as received
+        let text = match store_compressed {
+            StoreCompressed::Only => String::new(),
+            _ => match compression::decompress(&content_encoding, &bytes) {
+                Ok(inflated) => decode_body(inflated, content_type),
+                Err(e) => {
+                    error = Some(format!("Decompression error: {}", e));
+                    String::new()
+                }
+            },
+        };
+        let raw = base64::engine::general_purpose::STANDARD.encode(&bytes);
+        compressed = Some((content_encoding, raw));
+        text
+    };
+
+    // Archived-only bodies are not decoded, so there is nothing to extract from
+    let archived_only = compressed.is_some() && store_compressed == StoreCompressed::Only;
+    let page = match extraction {
+        Some(req) if !archived_only && error.is_none() => extract_page(&body, content_type, url, req),
+        _ => Default::default(),
+    };
+    // Convert HashMap to JSON Value
+    let extracted = page.values.and_then(|values| serde_json::to_value(&values).ok());
+    let (content_encoding, compressed_body) = compressed.unzip();
+
+    ProcessedBody {
+        body,
+        error,
+        extracted,
+        facets: page.facets,
+        links: page.links,
+        content_encoding,
+        compressed_body,
+    }
+}
+
+/// GET for a URL. Head-only fetches ask for an uncompressed body, which the head scanner
+/// can read as it arrives; compression would save little on the few KB read anyway.
+fn get_request(client: &reqwest::Client, url: &str, head_only: bool, store_compressed: StoreCompressed) -> reqwest::RequestBuilder {
+    let request = client.get(url);
+    if head_only && store_compressed == StoreCompressed::Off {
+        request.header(reqwest::header::ACCEPT_ENCODING, "identity")
+    } else {
+        request
+    }
+}
+
+/// True if a body is cheap enough to process on the I/O worker. Sized on the text that
+/// will be decoded: a small compressed transfer can inflate to a large body.
+fn process_inline(bytes: &[u8], content_encoding: &str, store_compressed: StoreCompressed) -> bool {
+    if bytes.len() >= compute_pool::INLINE_MAX_BYTES {
+        return false;
+    }
+    if store_compressed == StoreCompressed::Only || compression::is_identity(content_encoding) {
+        return true;
+    }
+    matches!(compression::inflated_len_hint(content_encoding, bytes), Some(n) if n < compute_pool::INLINE_MAX_BYTES)
+}
+
 /// Fetch a single URL with rate limiting and optional extraction
 async fn fetch_and_extract(
     client: &reqwest::Client,
     url: String,
-    extraction: &Option<ExtractionRequest>,
+    extraction: Option<Arc<ExtractionRequest>>,
     rate_limiter: &DomainRateLimiter,
+    compute: &ComputeLimiter,
     delay_ms: u64,
+    store_compressed: StoreCompressed,
+    probe: bool,
+    head_only: bool,
 ) -> CrawlResult {
     let start = std::time::Instant::now();
 
@@ -677,7 +1133,11 @@ async fn fetch_and_extract(
         }
     }
 
-    match client.get(&url).send().await {
+    if probe {
+        return probe_url(client, url, start).await;
+    }
+
+    match get_request(client, &url, head_only, store_compressed).send().await {
         Ok(response) => {
             let status = response.status().as_u16() as i32;
             let content_type = response
@@ -687,24 +1147,77 @@ async fn fetch_and_extract(
                 .unwrap_or("")
                 .to_string();
 
-            match response.text().await {
-                Ok(body) => {
-                    let extracted = if let Some(req) = extraction {
-                        let result = extract_all(&body, req);
-                        // Convert HashMap to JSON Value
-                        serde_json::to_value(&result.values).ok()
+            let content_encoding = response
+                .headers()
+                .get("content-encoding")
+                .and_then(|v| v.to_str().ok())
+                .unwrap_or("")
+                .to_string();
+
+            // Head-only: stop at </head> so the body never crosses the wire. Compressed
+            // bodies (a server ignoring identity) have nothing to scan.
+            let read = if head_only
+                && store_compressed == StoreCompressed::Off
+                && compression::is_identity(&content_encoding)
+                && content_type.contains("html")
+            {
+                crate::head_scan::read_head(response).await
+            } else {
+                response.bytes().await.map(Vec::from)
+            };
+
+            match read {
+                Ok(bytes) => {
+                    let transfer_size = Some(bytes.len() as u64);
+                    // Large bodies and extraction go to the compute pool, so this worker
+                    // keeps driving its other connections meanwhile
+                    let processed = if extraction.is_some() || !process_inline(&bytes, &content_encoding, store_compressed) {
+                        let url = url.clone();
+                        let content_type = content_type.clone();
+                        compute
+                            .run(move || {
+                                process_body(&url, bytes, &content_type, content_encoding, store_compressed, extraction.as_deref())
+                            })
+                            .await
                     } else {
-                        None
+                        Ok(process_body(&url, bytes, &content_type, content_encoding, store_compressed, None))
                     };
 
-                    CrawlResult {
-                        url,
-                        status,
-                        content_type,
-                        body,
-                        error: None,
-                        extracted,
-                        response_time_ms: start.elapsed().as_millis() as u64,
+                    match processed {
+                        Ok(processed) => CrawlResult {
+                            url,
+                            status,
+                            content_type,
+                            body: processed.body,
+                            error: processed.error,
+                            extracted: processed.extracted,
+                            response_time_ms: start.elapsed().as_millis() as u64,
+                            content_encoding: processed.content_encoding,
+                            compressed_body: processed.compressed_body,
+                            content_length: None,
+                            transfer_size,
+                            etag: None,
+                            last_modified: None,
+                            facets: processed.facets,
+                            links: processed.links,
+                        },
+                        Err(e) => CrawlResult {
+                            url,
+                            status,
+                            content_type,
+                            body: String::new(),
+                            error: Some(format!("Processing error: {}", e)),
+                            extracted: None,
+                            response_time_ms: start.elapsed().as_millis() as u64,
+                            content_encoding: None,
+                            compressed_body: None,
+                            content_length: None,
+                            transfer_size,
+                            etag: None,
+                            last_modified: None,
+                            facets: None,
+                            links: None,
+                        },
                     }
                 }
                 Err(e) => CrawlResult {
@@ -715,6 +1228,14 @@ async fn fetch_and_extract(
                     error: Some(format!("Body read error: {}", e)),
                     extracted: None,
                     response_time_ms: start.elapsed().as_millis() as u64,
+                    content_encoding: None,
+                    compressed_body: None,
+                    content_length: None,
+                    transfer_size: None,
+                    etag: None,
+                    last_modified: None,
+                    facets: None,
+                    links: None,
                 },
             }
         }
@@ -726,6 +1247,14 @@ async fn fetch_and_extract(
             error: Some(e.to_string()),
             extracted: None,
             response_time_ms: start.elapsed().as_millis() as u64,
+            content_encoding: None,
+            compressed_body: None,
+            content_length: None,
+            transfer_size: None,
+            etag: None,
+            last_modified: None,
+            facets: None,
+            links: None,
         },
     }
 }
@@ -740,6 +1269,28 @@ async fn fetch_and_extract(
 #[no_mangle]
 pub unsafe extern "C" fn crawl_batch_ffi(
     request_json: *const c_char,
+) -> ExtractionResultFFI {
+    crawl_batch_impl(request_json, None)
+}
+
+/// Batch crawl URLs, stopping as soon as `token` is cancelled
+///
+/// In-flight requests are dropped (and their connections aborted) on cancellation;
+/// results completed so far are still returned.
+///
+/// # Safety
+/// `token` must be null or a live pointer from cancel_token_new
+#[no_mangle]
+pub unsafe extern "C" fn crawl_batch_cancellable_ffi(
+    request_json: *const c_char,
+    token: *const CancelToken,
+) -> ExtractionResultFFI {
+    crawl_batch_impl(request_json, token.as_ref())
+}
+
+unsafe fn crawl_batch_impl(
+    request_json: *const c_char,
+    token: Option<&CancelToken>,
 ) -> ExtractionResultFFI {
     let request_str = match CStr::from_ptr(request_json).to_str() {
         Ok(s) => s,
@@ -777,9 +1328,17 @@ pub unsafe extern "C" fn crawl_batch_ffi(
         }
     }
 
+    // Negotiate the encodings ourselves: bodies arrive exactly as transferred, so crawl
+    // budgets charge wire bytes, and raw mode can keep them as received
+    let mut header_map = reqwest::header::HeaderMap::new();
+    client_builder = client_builder.no_gzip().no_brotli().no_zstd().no_deflate();
+    header_map.insert(
+        reqwest::header::ACCEPT_ENCODING,
+        reqwest::header::HeaderValue::from_static(compression::ACCEPT_ENCODING),
+    );
+
     // Add extra headers if provided
     if let Some(ref headers) = request.extra_headers {
-        let mut header_map = reqwest::header::HeaderMap::new();
         for (key, value) in headers {
             if let (Ok(name), Ok(val)) = (
                 reqwest::header::HeaderName::from_bytes(key.as_bytes()),
@@ -788,6 +1347,8 @@ pub unsafe extern "C" fn crawl_batch_ffi(
                 header_map.insert(name, val);
             }
         }
+    }
+    if !header_map.is_empty() {
         client_builder = client_builder.default_headers(header_map);
     }
 
@@ -816,8 +1377,12 @@ pub unsafe extern "C" fn crawl_batch_ffi(
         use futures::stream::{self, StreamExt};
 
         let concurrency = request.concurrency.max(1).min(32);
-        let extraction = request.extraction.clone();
+        let extraction = request.extraction.clone().map(Arc::new);
+        let compute = ComputeLimiter::new(request.compute_threads);
         let delay_ms = request.delay_ms;
+        let store_compressed = request.store_compressed;
+        let probe = request.probe;
+        let head_only = request.head_only;
         let respect_robots = request.respect_robots;
         let user_agent = request.user_agent.clone();
         let rate_limiter: DomainRateLimiter = Arc::new(Mutex::new(HashMap::new()));
@@ -833,6 +1398,9 @@ pub unsafe extern "C" fn crawl_batch_ffi(
             request.urls
                 .into_iter()
                 .filter(|url| {
+                    if token.map_or(false, |t| t.is_cancelled()) {
+                        return false;
+                    }
                     let check = robots_cache.check_blocking(&blocking_agent, url, &user_agent);
                     check.allowed
                 })
@@ -848,11 +1416,34 @@ pub unsafe extern "C" fn crawl_batch_ffi(
                 let client = client.clone();
                 let extraction = extraction.clone();
                 let rate_limiter = rate_limiter.clone();
-                async move { fetch_and_extract(&client, url, &extraction, &rate_limiter, delay_ms).await }
+                let compute = &compute;
+                async move {
+                    fetch_and_extract(
+                        &client,
+                        url,
+                        extraction,
+                        &rate_limiter,
+                        compute,
+                        delay_ms,
+                        store_compressed,
+                        probe,
+                        head_only,
+                    )
+                    .await
+                }
             })
             .buffer_unordered(concurrency);
 
-        while let Some(result) = url_stream.next().await {
+        loop {
+            let next = match token {
+                // Dropping the stream on cancellation aborts the requests still in flight
+                Some(token) => tokio::select! {
+                    result = url_stream.next() => result,
+                    _ = token.cancelled() => None,
+                },
+                None => url_stream.next().await,
+            };
+            let Some(result) = next else { break };
             results.push(result);
             // Check for interrupt after each result
             if INTERRUPTED.load(Ordering::SeqCst) {
@@ -876,6 +1467,44 @@ pub unsafe extern "C" fn crawl_batch_ffi(
     }
 }
 
+// ============================================================================
+// Lazy Decompression of stored bodies
+// ============================================================================
+
+/// Decompress a body kept with store_compressed and decode it to UTF-8 text
+///
+/// # Arguments
+/// * `data_ptr`, `data_len` - The body exactly as received
+/// * `content_encoding` - Its Content-Encoding header value
+/// * `content_type` - Content-Type header value, used for charset detection (may be empty)
+#[no_mangle]
+pub unsafe extern "C" fn decompress_body_ffi(
+    data_ptr: *const u8,
+    data_len: usize,
+    content_encoding: *const c_char,
+    content_type: *const c_char,
+) -> ExtractionResultFFI {
+    let data = if data_len == 0 { &[][..] } else { std::slice::from_raw_parts(data_ptr, data_len) };
+    let content_encoding = CStr::from_ptr(content_encoding).to_string_lossy();
+    let content_type = CStr::from_ptr(content_type).to_string_lossy();
+
+    match compression::decompress(&content_encoding, data) {
+        Ok(inflated) => {
+            let json_ptr = string_to_ptr(decode_body(inflated, &content_type));
+            let error_ptr = if json_ptr.is_null() {
+                string_to_ptr("Body contains NUL bytes".to_string())
+            } else {
+                ptr::null_mut()
+            };
+            ExtractionResultFFI { json_ptr, error_ptr }
+        }
+        Err(e) => ExtractionResultFFI {
+            json_ptr: ptr::null_mut(),
+            error_ptr: string_to_ptr(e),
+        },
+    }
+}
+
 // ============================================================================
 // Sitemap Fetching
 // ============================================================================
@@ -1092,3 +1721,80 @@ unsafe fn check_robots_ffi_inner(request_json: *const c_char) -> ExtractionResul
         },
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::io::Write;
+
+    const HTML: &str = "<html><head><title>Hi</title></head><body>compressed</body></html>";
+
+    fn gzip(data: &[u8]) -> Vec<u8> {
+        let mut gz = flate2::write::GzEncoder::new(Vec::new(), flate2::Compression::default());
+        gz.write_all(data).unwrap();
+        gz.finish().unwrap()
+    }
+
+    #[test]
+    fn test_process_body_inflates_when_not_stored() {
+        let processed = process_body("https://a.test/", gzip(HTML.as_bytes()), "text/html", "gzip".into(), StoreCompressed::Off, None);
+        assert_eq!(processed.body, HTML);
+        assert!(processed.error.is_none());
+        assert!(processed.content_encoding.is_none());
+        assert!(processed.compressed_body.is_none());
+
+        let bad = process_body("https://a.test/", b"not gzip".to_vec(), "text/html", "gzip".into(), StoreCompressed::Off, None);
+        assert!(bad.body.is_empty());
+        assert!(bad.error.unwrap().starts_with("Decompression error"));
+    }
+
+    #[test]
+    fn test_process_body_keeps_raw_bytes() {
+        let gz = gzip(HTML.as_bytes());
+        let alongside = process_body("https://a.test/", gz.clone(), "text/html", "gzip".into(), StoreCompressed::Alongside, None);
+        assert_eq!(alongside.body, HTML);
+        assert_eq!(alongside.content_encoding.as_deref(), Some("gzip"));
+        let raw = base64::engine::general_purpose::STANDARD.decode(alongside.compressed_body.unwrap()).unwrap();
+        assert_eq!(raw, gz);
+
+        let only = process_body("https://a.test/", gz, "text/html", "gzip".into(), StoreCompressed::Only, None);
+        assert!(only.body.is_empty());
+        assert!(only.compressed_body.is_some());
+
+        // Identity bodies have nothing to keep
+        let plain = process_body("https://a.test/", HTML.as_bytes().to_vec(), "text/html", String::new(), StoreCompressed::Only, None);
+        assert_eq!(plain.body, HTML);
+        assert!(plain.compressed_body.is_none());
+    }
+
+    #[test]
+    fn test_head_only_requests_identity() {
+        let client = reqwest::Client::new();
+        let accept = |head_only, store| {
+            let request = get_request(&client, "https://a.test/", head_only, store).build().unwrap();
+            request.headers().get(reqwest::header::ACCEPT_ENCODING).map(|v| v.to_str().unwrap().to_string())
+        };
+        assert_eq!(accept(true, StoreCompressed::Off).as_deref(), Some("identity"));
+        // Other fetches keep the client's default Accept-Encoding
+        assert_eq!(accept(false, StoreCompressed::Off), None);
+        assert_eq!(accept(true, StoreCompressed::Alongside), None);
+    }
+
+    #[test]
+    fn test_process_inline_sizes_on_inflated_length() {
+        assert!(process_inline(HTML.as_bytes(), "", StoreCompressed::Off));
+        assert!(process_inline(&gzip(HTML.as_bytes()), "gzip", StoreCompressed::Off));
+
+        // A few hundred bytes on the wire, a megabyte once inflated
+        let bomb = gzip(&vec![b'a'; 1 << 20]);
+        assert!(bomb.len() < compute_pool::INLINE_MAX_BYTES);
+        assert!(!process_inline(&bomb, "gzip", StoreCompressed::Off));
+        assert!(!process_inline(&bomb, "gzip", StoreCompressed::Alongside));
+        // Archived-only bodies are never inflated
+        assert!(process_inline(&bomb, "gzip", StoreCompressed::Only));
+
+        // Unknown inflated size goes to the pool
+        assert!(!process_inline(b"brotli", "br", StoreCompressed::Off));
+        assert!(!process_inline(&vec![0; compute_pool::INLINE_MAX_BYTES], "", StoreCompressed::Off));
+    }
+}
@@ -0,0 +1,286 @@
+//! Incremental detection of the end of an HTML document's `<head>`
+//!
+//! Title, meta tags, OpenGraph, canonical links and most JSON-LD live in `<head>`.
+//! When only those are needed the body can stay on the wire: `HeadScanner` is fed
+//! the response chunk by chunk and reports the offset where the head ends, so the
+//! fetch can stop reading and drop the connection.
+//!
+//! The head ends at `</head>`, at `<body>`, or at the first start tag that cannot
+//! appear in a head (the HTML spec implies `<body>` there). Comments, quoted attribute
+//! values and the contents of script, style, title and noscript are skipped, so markup
+//! inside them does not end the head early.
+
+/// Start tags that keep the parser in the head
+const HEAD_TAGS: &[&[u8]] = &[
+    b"html", b"head", b"meta", b"link", b"title", b"style", b"script", b"base", b"noscript", b"template",
+    b"basefont", b"bgsound",
+];
+
+/// Longest tag name worth remembering; anything longer is not a head tag
+const MAX_TAG_NAME: usize = 16;
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum State {
+    Data,
+    TagOpen,
+    TagName,
+    /// Inside a tag after its name, until `>`
+    Attributes,
+    /// After `<!`: a comment if two dashes follow, else a doctype or bogus comment
+    MarkupDeclaration,
+    Comment,
+    Bogus,
+    /// Contents of script/style/title/noscript, until the matching end tag
+    RawText,
+}
+
+/// Streaming scanner for the end of `<head>`
+pub struct HeadScanner {
+    state: State,
+    /// Bytes consumed so far, across all chunks
+    pos: usize,
+    /// Offset of the `<` that opened the current tag
+    tag_start: usize,
+    end_tag: bool,
+    name: Vec<u8>,
+    /// `</script` etc. while a raw text element is open
+    raw_end: Vec<u8>,
+    raw_matched: usize,
+    quote: Option<u8>,
+    after_equals: bool,
+    dashes: usize,
+    head_end: Option<usize>,
+}
+
+impl Default for HeadScanner {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl HeadScanner {
+    pub fn new() -> Self {
+        HeadScanner {
+            state: State::Data,
+            pos: 0,
+            tag_start: 0,
+            end_tag: false,
+            name: Vec::new(),
+            raw_end: Vec::new(),
+            raw_matched: 0,
+            quote: None,
+            after_equals: false,
+            dashes: 0,
+            head_end: None,
+        }
+    }
+
+    /// Feed the next chunk. Returns the offset (from the start of the document) where
+    /// the head ends, once it has been seen; the tag at that offset is not part of it.
+    pub fn feed(&mut self, chunk: &[u8]) -> Option<usize> {
+        for &byte in chunk {
+            if self.head_end.is_some() {
+                break;
+            }
+            self.step(byte);
+            self.pos += 1;
+        }
+        self.head_end
+    }
+
+    fn step(&mut self, byte: u8) {
+        match self.state {
+            State::Data => {
+                if byte == b'<' {
+                    self.tag_start = self.pos;
+                    self.state = State::TagOpen;
+                }
+            }
+            State::TagOpen => match byte {
+                b'/' => {
+                    self.end_tag = true;
+                    self.name.clear();
+                    self.state = State::TagName;
+                }
+                b'!' => {
+                    self.dashes = 0;
+                    self.state = State::MarkupDeclaration;
+                }
+                b'?' => self.state = State::Bogus,
+                b if b.is_ascii_alphabetic() => {
+                    self.end_tag = false;
+                    self.name.clear();
+                    self.name.push(b.to_ascii_lowercase());
+                    self.state = State::TagName;
+                }
+                // A literal '<' in text
+                b'<' => self.tag_start = self.pos,
+                _ => self.state = State::Data,
+            },
+            State::TagName => {
+                if byte.is_ascii_whitespace() || byte == b'/' || byte == b'>' {
+                    self.end_of_tag_name();
+                    if self.head_end.is_none() {
+                        self.quote = None;
+                        self.after_equals = false;
+                        self.state = State::Attributes;
+                        self.step(byte);
+                    }
+                } else if self.name.len() <= MAX_TAG_NAME {
+                    self.name.push(byte.to_ascii_lowercase());
+                }
+            }
+            State::Attributes => match self.quote {
+                Some(quote) => {
+                    if byte == quote {
+                        self.quote = None;
+                    }
+                }
+                None => match byte {
+                    b'"' | b'\'' if self.after_equals => self.quote = Some(byte),
+                    b'>' => {
+                        self.state = if self.raw_end.is_empty() { State::Data } else { State::RawText };
+                    }
+                    b'=' => self.after_equals = true,
+                    b if b.is_ascii_whitespace() => {}
+                    _ => self.after_equals = false,
+                },
+            },
+            State::MarkupDeclaration => match byte {
+                b'-' if self.dashes == 0 => self.dashes = 1,
+                b'-' => {
+                    self.dashes = 0;
+                    self.state = State::Comment;
+                }
+                b'>' => self.state = State::Data,
+                _ => self.state = State::Bogus,
+            },
+            State::Comment => match byte {
+                b'-' => self.dashes += 1,
+                b'>' if self.dashes >= 2 => self.state = State::Data,
+                _ => self.dashes = 0,
+            },
+            State::Bogus => {
+                if byte == b'>' {
+                    self.state = State::Data;
+                }
+            }
+            State::RawText => {
+                if byte.to_ascii_lowercase() == self.raw_end[self.raw_matched] {
+                    self.raw_matched += 1;
+                    if self.raw_matched == self.raw_end.len() {
+                        // The end tag's own attributes/whitespace run to '>'
+                        self.raw_end.clear();
+                        self.raw_matched = 0;
+                        self.quote = None;
+                        self.after_equals = false;
+                        self.state = State::Attributes;
+                    }
+                } else {
+                    self.raw_matched = usize::from(byte == b'<');
+                }
+            }
+        }
+    }
+
+    fn end_of_tag_name(&mut self) {
+        let name = self.name.as_slice();
+        if self.end_tag {
+            if matches!(name, b"head" | b"body" | b"html") {
+                self.head_end = Some(self.tag_start);
+            }
+            return;
+        }
+        if !HEAD_TAGS.contains(&name) {
+            // <body>, or content that implies it
+            self.head_end = Some(self.tag_start);
+            return;
+        }
+        if matches!(name, b"script" | b"style" | b"title" | b"noscript") {
+            self.raw_end.clear();
+            self.raw_end.extend_from_slice(b"</");
+            self.raw_end.extend_from_slice(name);
+            self.raw_matched = 0;
+        }
+    }
+}
+
+/// Read a response only up to the end of its `<head>`, then drop the connection.
+/// Documents without a recognizable head end are read in full.
+pub async fn read_head(mut response: reqwest::Response) -> Result<Vec<u8>, reqwest::Error> {
+    let mut scanner = HeadScanner::new();
+    let mut bytes = Vec::new();
+    while let Some(chunk) = response.chunk().await? {
+        bytes.extend_from_slice(&chunk);
+        if let Some(end) = scanner.feed(&chunk) {
+            bytes.truncate(end);
+            break;
+        }
+    }
+    Ok(bytes)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn head_end(html: &str) -> Option<usize> {
+        HeadScanner::new().feed(html.as_bytes())
+    }
+
+    fn head_of(html: &str) -> &str {
+        &html[..head_end(html).unwrap_or(html.len())]
+    }
+
+    #[test]
+    fn test_head_end_tags() {
+        let html = "<!DOCTYPE html><html><head><title>T</title></head><body><p>x</p></body></html>";
+        assert_eq!(head_of(html), "<!DOCTYPE html><html><head><title>T</title>");
+
+        // No </head>: <body> ends it
+        assert_eq!(head_of("<head><meta charset=utf-8><BODY class=x>"), "<head><meta charset=utf-8>");
+
+        // No <body> either: the first body-only element implies it
+        assert_eq!(head_of("<title>T</title><link rel=canonical href=/a><div>"), "<title>T</title><link rel=canonical href=/a>");
+
+        // A document that never leaves the head
+        assert_eq!(head_end("<head><title>T</title>"), None);
+    }
+
+    #[test]
+    fn test_skips_raw_text_comments_and_quotes() {
+        let html = concat!(
+            "<head><script>if (a<b) document.write('<body><div>')</script>",
+            "<!-- <body> --><style>p::before{content:'</head>'}</style>",
+            "<title>a <b>bold</b> title</title>",
+            "<meta content=\"x > <body>\" name='d'>",
+            "<noscript><img src=x></noscript></head><body>"
+        );
+        assert_eq!(head_of(html), &html[..html.len() - "</head><body>".len()]);
+
+        // An unquoted value containing a quote does not open a quoted string
+        assert_eq!(head_of("<meta name=it's><body>"), "<meta name=it's>");
+    }
+
+    #[test]
+    fn test_split_across_chunks() {
+        let html = "<head><script>x</script><!-- c --><title>x</title></head><body>";
+        let mut scanner = HeadScanner::new();
+        let mut result = None;
+        for chunk in html.as_bytes().chunks(3) {
+            result = scanner.feed(chunk);
+            if result.is_some() {
+                break;
+            }
+        }
+        assert_eq!(result, Some(html.find("</head>").unwrap()));
+
+        let html = "<head><script>var s = '</scr' + 'ipt>';</script><meta a=b></head>";
+        let mut scanner = HeadScanner::new();
+        let mut result = None;
+        for chunk in html.as_bytes().chunks(1) {
+            result = result.or(scanner.feed(chunk));
+        }
+        assert_eq!(result, Some(html.find("</head>").unwrap()));
+    }
+}
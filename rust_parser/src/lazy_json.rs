@@ -0,0 +1,225 @@
+//! On-demand path evaluation over raw JSON text
+//!
+//! Hydration blobs (`__NEXT_DATA__`, `window.__NUXT__ = {...}`) can be megabytes, while
+//! a query usually wants two fields from them. Instead of building a `Value` for the
+//! whole document, `select` streams through the text: siblings of the requested path are
+//! skipped without allocating, only the target is materialized, and parsing stops as
+//! soon as it has been read.
+
+use serde::de::{self, DeserializeSeed, Deserializer, IgnoredAny, MapAccess, SeqAccess, Visitor};
+use serde::Deserialize;
+use serde_json::Value;
+use std::fmt;
+
+/// Error used to abandon the parse once the target has been read
+const FOUND: &str = "lazy_json: target found";
+
+/// The value at `path` inside `json`, or None if the path does not exist. A segment
+/// is an object key, or an array index when the container is an array. Text after the
+/// target is not read (nor validated).
+pub fn select<S: AsRef<str>>(json: &str, path: &[S]) -> Option<Value> {
+    let mut found = None;
+    let mut deserializer = serde_json::Deserializer::from_str(json);
+    let _ = PathSeed { path, found: &mut found }.deserialize(&mut deserializer);
+    found
+}
+
+/// Whether `json` is one valid JSON value (checked without building it)
+pub fn is_valid(json: &str) -> bool {
+    serde_json::from_str::<IgnoredAny>(json).is_ok()
+}
+
+/// Split a `->'key'->>[0]->name` path (the JSON operators of extract specs) into
+/// segments. None if it is malformed.
+pub fn arrow_path_segments(path: &str) -> Option<Vec<String>> {
+    let mut segments = Vec::new();
+    let mut remaining = path.trim();
+
+    while !remaining.is_empty() {
+        if let Some(rest) = remaining.strip_prefix("->>") {
+            remaining = rest;
+        } else if let Some(rest) = remaining.strip_prefix("->") {
+            remaining = rest;
+        } else {
+            break;
+        }
+        remaining = remaining.trim_start();
+
+        let segment = if let Some(rest) = remaining.strip_prefix('\'') {
+            let end = rest.find('\'')?;
+            remaining = &rest[end + 1..];
+            &rest[..end]
+        } else if let Some(rest) = remaining.strip_prefix('"') {
+            let end = rest.find('"')?;
+            remaining = &rest[end + 1..];
+            &rest[..end]
+        } else if let Some(rest) = remaining.strip_prefix('[') {
+            let end = rest.find(']')?;
+            remaining = &rest[end + 1..];
+            &rest[..end]
+        } else {
+            let end = remaining.find("->").unwrap_or(remaining.len());
+            let segment = remaining[..end].trim();
+            remaining = &remaining[end..];
+            segment
+        };
+        segments.push(segment.to_string());
+    }
+
+    Some(segments)
+}
+
+/// Reads the value at `path` into `found`, then fails with `FOUND` to stop the parse
+struct PathSeed<'a, S> {
+    path: &'a [S],
+    found: &'a mut Option<Value>,
+}
+
+impl<'de, 'a, S: AsRef<str>> DeserializeSeed<'de> for PathSeed<'a, S> {
+    type Value = ();
+
+    fn deserialize<D: Deserializer<'de>>(self, deserializer: D) -> Result<(), D::Error> {
+        match self.path.split_first() {
+            None => {
+                *self.found = Some(Value::deserialize(deserializer)?);
+                Err(de::Error::custom(FOUND))
+            }
+            Some((segment, rest)) => deserializer.deserialize_any(StepVisitor {
+                segment: segment.as_ref(),
+                rest,
+                found: self.found,
+            }),
+        }
+    }
+}
+
+/// Looks for one segment in an object or array; scalars end the path unmatched
+struct StepVisitor<'a, S> {
+    segment: &'a str,
+    rest: &'a [S],
+    found: &'a mut Option<Value>,
+}
+
+impl<'de, 'a, S: AsRef<str>> Visitor<'de> for StepVisitor<'a, S> {
+    type Value = ();
+
+    fn expecting(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        f.write_str("a JSON value")
+    }
+
+    fn visit_map<A: MapAccess<'de>>(self, mut map: A) -> Result<(), A::Error> {
+        while let Some(matches) = map.next_key_seed(KeyMatches(self.segment))? {
+            if matches {
+                return map.next_value_seed(PathSeed { path: self.rest, found: self.found });
+            }
+            map.next_value::<IgnoredAny>()?;
+        }
+        Ok(())
+    }
+
+    fn visit_seq<A: SeqAccess<'de>>(self, mut seq: A) -> Result<(), A::Error> {
+        let index = match self.segment.parse::<usize>() {
+            Ok(index) => index,
+            Err(_) => {
+                while seq.next_element::<IgnoredAny>()?.is_some() {}
+                return Ok(());
+            }
+        };
+        for _ in 0..index {
+            if seq.next_element::<IgnoredAny>()?.is_none() {
+                return Ok(());
+            }
+        }
+        seq.next_element_seed(PathSeed { path: self.rest, found: self.found })?;
+        Ok(())
+    }
+
+    fn visit_bool<E: de::Error>(self, _: bool) -> Result<(), E> {
+        Ok(())
+    }
+
+    fn visit_i64<E: de::Error>(self, _: i64) -> Result<(), E> {
+        Ok(())
+    }
+
+    fn visit_u64<E: de::Error>(self, _: u64) -> Result<(), E> {
+        Ok(())
+    }
+
+    fn visit_f64<E: de::Error>(self, _: f64) -> Result<(), E> {
+        Ok(())
+    }
+
+    fn visit_str<E: de::Error>(self, _: &str) -> Result<(), E> {
+        Ok(())
+    }
+
+    fn visit_unit<E: de::Error>(self) -> Result<(), E> {
+        Ok(())
+    }
+}
+
+/// Compares an object key with a segment without allocating it
+struct KeyMatches<'a>(&'a str);
+
+impl<'de, 'a> DeserializeSeed<'de> for KeyMatches<'a> {
+    type Value = bool;
+
+    fn deserialize<D: Deserializer<'de>>(self, deserializer: D) -> Result<bool, D::Error> {
+        deserializer.deserialize_str(self)
+    }
+}
+
+impl<'de, 'a> Visitor<'de> for KeyMatches<'a> {
+    type Value = bool;
+
+    fn expecting(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        f.write_str("an object key")
+    }
+
+    fn visit_str<E: de::Error>(self, key: &str) -> Result<bool, E> {
+        Ok(key == self.0)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const DOC: &str = r#"{"props": {"pageProps": {"items": [{"id": 1}, {"id": 2, "name": "two"}], "title": "T\"x"}},
+                          "buildId": "abc", "big": [1, 2, 3]}"#;
+
+    #[test]
+    fn test_select_paths() {
+        assert_eq!(select(DOC, &["buildId"]), Some(Value::from("abc")));
+        assert_eq!(select(DOC, &["props", "pageProps", "items", "1", "name"]), Some(Value::from("two")));
+        assert_eq!(select(DOC, &["props", "pageProps", "title"]), Some(Value::from("T\"x")));
+        assert_eq!(select(DOC, &["big"]), Some(serde_json::json!([1, 2, 3])));
+        let empty: [&str; 0] = [];
+        assert_eq!(select("[1]", &empty), Some(serde_json::json!([1])));
+
+        // Missing keys, out-of-range indexes and paths through scalars
+        assert_eq!(select(DOC, &["nope"]), None);
+        assert_eq!(select(DOC, &["big", "7"]), None);
+        assert_eq!(select(DOC, &["buildId", "x"]), None);
+        assert_eq!(select(DOC, &["big", "x"]), None);
+    }
+
+    #[test]
+    fn test_stops_after_target() {
+        // Text after the target is never read, so it does not have to be valid
+        assert_eq!(select(r#"{"a": 1, "b": <garbage>"#, &["a"]), Some(Value::from(1)));
+        assert_eq!(select(r#"{"a": 1, "b": <garbage>"#, &["b"]), None);
+    }
+
+    #[test]
+    fn test_arrow_path_segments() {
+        assert_eq!(
+            arrow_path_segments("->'items'->[0]->>\"name\"").unwrap(),
+            vec!["items".to_string(), "0".to_string(), "name".to_string()]
+        );
+        assert_eq!(arrow_path_segments("->items->>id").unwrap(), vec!["items".to_string(), "id".to_string()]);
+        assert!(arrow_path_segments("->'unterminated").is_none());
+        assert!(is_valid(DOC) && !is_valid("{\"a\":"));
+    }
+}
@@ -8,9 +8,17 @@
 //! - CSS selectors (jQuery-like syntax)
 //! - robots.txt parsing
 //! - Sitemap XML parsing
+//! - Charset detection and decoding of fetched bodies
+//! - Content-Encoding passthrough and lazy decompression
+//! - Lazy path evaluation over large JS and hydration JSON
 
+mod charset;
+mod compression;
+mod compute_pool;
 mod extractors;
 mod ffi;
+mod head_scan;
+mod lazy_json;
 pub mod robots;
 pub mod sitemap;
 
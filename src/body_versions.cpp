@@ -0,0 +1,229 @@
+#include "body_versions.hpp"
+#include "crawler_utils.hpp"
+
+#include <cstring>
+#include <unordered_map>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Delta Codec
+//===--------------------------------------------------------------------===//
+// Layout: varint target_size, then ops. Each op starts with varint (length << 1 | kind):
+//   kind 0 (literal): `length` raw bytes follow
+//   kind 1 (copy):    varint base offset follows; copies `length` bytes of the base
+
+static constexpr idx_t DELTA_BLOCK_SIZE = 16;
+
+static void PutVarint(string &out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+static bool GetVarint(const string &in, idx_t &pos, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) return false;
+        auto byte = static_cast<uint8_t>(in[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint64_t BlockHash(const char *data) {
+    uint64_t a, b;
+    memcpy(&a, data, 8);
+    memcpy(&b, data + 8, 8);
+    uint64_t h = a * 0x9E3779B185EBCA87ULL ^ (b * 0xC2B2AE3D27D4EB4FULL);
+    return h ^ (h >> 29);
+}
+
+static void PutLiteral(string &out, const string &target, idx_t start, idx_t end) {
+    if (end <= start) return;
+    PutVarint(out, static_cast<uint64_t>(end - start) << 1);
+    out.append(target, start, end - start);
+}
+
+string EncodeBodyDelta(const string &base, const string &target) {
+    string delta;
+    PutVarint(delta, target.size());
+
+    // Index base blocks at block-aligned offsets (first occurrence wins)
+    std::unordered_map<uint64_t, idx_t> blocks;
+    if (base.size() >= DELTA_BLOCK_SIZE) {
+        blocks.reserve(base.size() / DELTA_BLOCK_SIZE);
+        for (idx_t pos = 0; pos + DELTA_BLOCK_SIZE <= base.size(); pos += DELTA_BLOCK_SIZE) {
+            blocks.emplace(BlockHash(base.data() + pos), pos);
+        }
+    }
+
+    // Greedy scan: at every target position, try to extend a block match in both directions
+    idx_t literal_start = 0;
+    idx_t i = 0;
+    while (!blocks.empty() && i + DELTA_BLOCK_SIZE <= target.size()) {
+        auto it = blocks.find(BlockHash(target.data() + i));
+        if (it == blocks.end() || memcmp(base.data() + it->second, target.data() + i, DELTA_BLOCK_SIZE) != 0) {
+            i++;
+            continue;
+        }
+        idx_t base_pos = it->second;
+        while (i > literal_start && base_pos > 0 && base[base_pos - 1] == target[i - 1]) {
+            i--;
+            base_pos--;
+        }
+        idx_t length = 0;
+        while (base_pos + length < base.size() && i + length < target.size() &&
+               base[base_pos + length] == target[i + length]) {
+            length++;
+        }
+        PutLiteral(delta, target, literal_start, i);
+        PutVarint(delta, (static_cast<uint64_t>(length) << 1) | 1);
+        PutVarint(delta, base_pos);
+        i += length;
+        literal_start = i;
+    }
+    PutLiteral(delta, target, literal_start, target.size());
+    return delta;
+}
+
+bool ApplyBodyDelta(const string &base, const string &delta, string &target) {
+    idx_t pos = 0;
+    uint64_t target_size;
+    if (!GetVarint(delta, pos, target_size)) {
+        return false;
+    }
+    target.clear();
+    target.reserve(MinValue<uint64_t>(target_size, base.size() + delta.size()));
+
+    while (pos < delta.size()) {
+        uint64_t header;
+        if (!GetVarint(delta, pos, header)) return false;
+        uint64_t length = header >> 1;
+        if (target.size() + length > target_size) return false;
+        if (header & 1) {
+            uint64_t offset;
+            if (!GetVarint(delta, pos, offset) || offset > base.size() || length > base.size() - offset) {
+                return false;
+            }
+            target.append(base, offset, length);
+        } else {
+            if (length > delta.size() - pos) return false;
+            target.append(delta, pos, length);
+            pos += length;
+        }
+    }
+    return target.size() == target_size;
+}
+
+//===--------------------------------------------------------------------===//
+// Version Storage
+//===--------------------------------------------------------------------===//
+
+void EnsureVersionsTable(Connection &conn) {
+    conn.Query("CREATE TABLE IF NOT EXISTS " + string(VERSIONS_TABLE_NAME) + " ("
+               "surt_key VARCHAR, "
+               "version BIGINT, "
+               "url VARCHAR, "
+               "crawled_at TIMESTAMP DEFAULT current_timestamp, "
+               "keyframe BOOLEAN, "
+               "body_size BIGINT, "
+               "content_hash VARCHAR, "
+               "data BLOB, "
+               "PRIMARY KEY (surt_key, version))");
+}
+
+bool IsBodyVersioningEnabled(ClientContext &context) {
+    Value setting_value;
+    return context.TryGetCurrentSetting("crawler_body_versions", setting_value) && !setting_value.IsNull() &&
+           setting_value.GetValue<bool>();
+}
+
+int64_t GetKeyframeInterval(ClientContext &context) {
+    Value setting_value;
+    if (context.TryGetCurrentSetting("crawler_version_keyframe_interval", setting_value) && !setting_value.IsNull()) {
+        return MaxValue<int64_t>(setting_value.GetValue<int64_t>(), 1);
+    }
+    return DEFAULT_KEYFRAME_INTERVAL;
+}
+
+int64_t RecordBodyVersion(Connection &conn, const string &url, const string &body, const string &content_hash,
+                          int64_t keyframe_interval) {
+    EnsureVersionsTable(conn);
+    string surt_key = GenerateSurtKey(url);
+
+    // Chain from the latest keyframe to the latest version
+    auto result = conn.Query("SELECT version, keyframe, data, content_hash FROM " + string(VERSIONS_TABLE_NAME) +
+                             " WHERE surt_key = $1 AND version >= (SELECT coalesce(max(version), 0) FROM " +
+                             string(VERSIONS_TABLE_NAME) + " WHERE surt_key = $1 AND keyframe) ORDER BY version",
+                             surt_key);
+    if (result->HasError()) {
+        return 0;
+    }
+
+    int64_t latest_version = 0;
+    int64_t chain_length = 0;
+    string latest_hash;
+    string previous;
+    bool chain_ok = true;
+    while (auto chunk = result->Fetch()) {
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            latest_version = chunk->GetValue(0, row).GetValue<int64_t>();
+            bool keyframe = chunk->GetValue(1, row).GetValue<bool>();
+            string data = StringValue::Get(chunk->GetValue(2, row));
+            latest_hash = chunk->GetValue(3, row).IsNull() ? "" : chunk->GetValue(3, row).ToString();
+            chain_length++;
+            if (keyframe) {
+                previous = std::move(data);
+            } else {
+                string next;
+                chain_ok = chain_ok && ApplyBodyDelta(previous, data, next);
+                previous = std::move(next);
+            }
+        }
+    }
+
+    if (latest_version > 0 && latest_hash == content_hash) {
+        return 0;  // Unchanged since the latest version
+    }
+
+    bool keyframe = latest_version == 0 || !chain_ok || chain_length >= keyframe_interval;
+    string data;
+    if (!keyframe) {
+        data = EncodeBodyDelta(previous, body);
+        if (data.size() * 2 >= body.size()) {
+            keyframe = true;
+        }
+    }
+    if (keyframe) {
+        data = body;
+    }
+
+    // A concurrent writer may have taken this version number; its body wins
+    auto inserted = conn.Query("INSERT OR IGNORE INTO " + string(VERSIONS_TABLE_NAME) +
+                                   " (surt_key, version, url, crawled_at, keyframe, body_size, content_hash, data) "
+                                   "VALUES ($1, $2, $3, current_timestamp, $4, $5, $6, $7)",
+                               surt_key, Value::BIGINT(latest_version + 1), url, Value::BOOLEAN(keyframe),
+                               Value::BIGINT(static_cast<int64_t>(body.size())), content_hash,
+                               Value::BLOB(const_data_ptr_cast(data.data()), data.size()));
+    if (inserted->HasError()) {
+        return 0;
+    }
+    auto chunk = inserted->Fetch();
+    bool written = chunk && chunk->size() > 0 && chunk->GetValue(0, 0).GetValue<int64_t>() > 0;
+    return written ? latest_version + 1 : 0;
+}
+
+void MaybeRecordBodyVersion(ClientContext &context, const string &url, int status_code, const string &body,
+                            const string &content_hash) {
+    if (body.empty() || status_code < 200 || status_code >= 300 || !IsBodyVersioningEnabled(context)) {
+        return;
+    }
+    Connection conn(*context.db);
+    RecordBodyVersion(conn, url, body, content_hash, GetKeyframeInterval(context));
+}
+
+} // namespace duckdb
@@ -0,0 +1,237 @@
+// crawl_body_versions() - read the version history of a crawled URL
+//
+// Usage:
+//   SELECT version, crawled_at, length(body) FROM crawl_body_versions('https://shop.example.com/item');
+//   SELECT body FROM crawl_body_versions('https://shop.example.com/item', as_of := TIMESTAMP '2025-01-01');
+//
+// Bodies are rebuilt from the nearest keyframe and the deltas that follow it.
+// Versions are recorded when crawler_body_versions is enabled, or explicitly (e.g. for
+// bodies fetched elsewhere) with:
+//   SELECT * FROM crawl_record_body_version('https://shop.example.com/item', body);
+
+#include "body_versions_function.hpp"
+#include "body_versions.hpp"
+#include "crawler_utils.hpp"
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Bind Data
+//===--------------------------------------------------------------------===//
+
+struct BodyVersionsBindData : public TableFunctionData {
+    string url;
+    Value as_of;  // NULL = all versions
+};
+
+//===--------------------------------------------------------------------===//
+// Global State
+//===--------------------------------------------------------------------===//
+
+struct StoredVersion {
+    int64_t version = 0;
+    Value crawled_at;
+    bool keyframe = false;
+    string data;
+};
+
+struct BodyVersionsGlobalState : public GlobalTableFunctionState {
+    vector<StoredVersion> versions;  // Keyframe-first chain(s), in version order
+    idx_t next_idx = 0;
+    idx_t emit_from = 0;             // Versions before this only feed the reconstruction
+    string body;                     // Body of the last reconstructed version
+    bool body_valid = false;
+    bool loaded = false;
+
+    idx_t MaxThreads() const override { return 1; }
+};
+
+//===--------------------------------------------------------------------===//
+// Bind Function
+//===--------------------------------------------------------------------===//
+
+static unique_ptr<FunctionData> BodyVersionsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<BodyVersionsBindData>();
+    if (input.inputs[0].IsNull()) {
+        throw BinderException("crawl_body_versions(): url must not be NULL");
+    }
+    bind_data->url = StringValue::Get(input.inputs[0]);
+
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "as_of") {
+            bind_data->as_of = kv.second;
+        }
+    }
+
+    return_types = {LogicalType::VARCHAR, LogicalType::BIGINT, LogicalType::TIMESTAMP, LogicalType::BOOLEAN,
+                    LogicalType::BIGINT, LogicalType::VARCHAR};
+    names = {"url", "version", "crawled_at", "keyframe", "stored_bytes", "body"};
+    return std::move(bind_data);
+}
+
+//===--------------------------------------------------------------------===//
+// Init Global
+//===--------------------------------------------------------------------===//
+
+static unique_ptr<GlobalTableFunctionState> BodyVersionsInitGlobal(ClientContext &context,
+                                                                   TableFunctionInitInput &input) {
+    return make_uniq<BodyVersionsGlobalState>();
+}
+
+// Load the stored versions needed to answer the query
+static void LoadVersions(ClientContext &context, const BodyVersionsBindData &bind_data,
+                         BodyVersionsGlobalState &state) {
+    Connection conn(*context.db);
+    EnsureVersionsTable(conn);
+    string table(VERSIONS_TABLE_NAME);
+    string surt_key = GenerateSurtKey(bind_data.url);
+
+    unique_ptr<QueryResult> result;
+    if (bind_data.as_of.IsNull()) {
+        result = conn.Query("SELECT version, crawled_at, keyframe, data FROM " + table +
+                                " WHERE surt_key = $1 ORDER BY version",
+                            surt_key);
+    } else {
+        // Latest version crawled at or before as_of, plus its chain back to a keyframe
+        result = conn.Query("WITH target AS (SELECT max(version) AS v FROM " + table +
+                                " WHERE surt_key = $1 AND crawled_at <= $2::TIMESTAMP), "
+                                "base AS (SELECT max(version) AS v FROM " + table +
+                                " WHERE surt_key = $1 AND keyframe AND version <= (SELECT v FROM target)) "
+                                "SELECT version, crawled_at, keyframe, data FROM " + table +
+                                " WHERE surt_key = $1 AND version BETWEEN (SELECT v FROM base) AND (SELECT v FROM target) "
+                                "ORDER BY version",
+                            surt_key, bind_data.as_of);
+    }
+    if (result->HasError()) {
+        throw IOException("crawl_body_versions(): %s", result->GetError());
+    }
+
+    while (auto chunk = result->Fetch()) {
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            StoredVersion version;
+            version.version = chunk->GetValue(0, row).GetValue<int64_t>();
+            version.crawled_at = chunk->GetValue(1, row);
+            version.keyframe = chunk->GetValue(2, row).GetValue<bool>();
+            version.data = StringValue::Get(chunk->GetValue(3, row));
+            state.versions.push_back(std::move(version));
+        }
+    }
+
+    // as_of returns only the target version; the chain before it is replayed silently
+    if (!bind_data.as_of.IsNull() && !state.versions.empty()) {
+        state.emit_from = state.versions.size() - 1;
+    }
+}
+
+//===--------------------------------------------------------------------===//
+// Table Function
+//===--------------------------------------------------------------------===//
+
+static void BodyVersionsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &bind_data = data.bind_data->Cast<BodyVersionsBindData>();
+    auto &state = data.global_state->Cast<BodyVersionsGlobalState>();
+
+    if (!state.loaded) {
+        state.loaded = true;
+        LoadVersions(context, bind_data, state);
+    }
+
+    idx_t count = 0;
+    while (state.next_idx < state.versions.size() && count < STANDARD_VECTOR_SIZE) {
+        auto &version = state.versions[state.next_idx++];
+        if (version.keyframe) {
+            state.body = version.data;
+            state.body_valid = true;
+        } else if (state.body_valid) {
+            string next;
+            state.body_valid = ApplyBodyDelta(state.body, version.data, next);
+            state.body = std::move(next);
+        }
+        if (state.next_idx <= state.emit_from) {
+            continue;
+        }
+
+        output.SetValue(0, count, Value(bind_data.url));
+        output.SetValue(1, count, Value::BIGINT(version.version));
+        output.SetValue(2, count, version.crawled_at);
+        output.SetValue(3, count, Value::BOOLEAN(version.keyframe));
+        output.SetValue(4, count, Value::BIGINT(static_cast<int64_t>(version.data.size())));
+        output.SetValue(5, count, state.body_valid ? Value(state.body) : Value());
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// crawl_record_body_version()
+//===--------------------------------------------------------------------===//
+
+struct RecordBodyVersionBindData : public TableFunctionData {
+    string url;
+    string body;
+};
+
+struct RecordBodyVersionGlobalState : public GlobalTableFunctionState {
+    bool done = false;
+
+    idx_t MaxThreads() const override { return 1; }
+};
+
+static unique_ptr<FunctionData> RecordBodyVersionBind(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<RecordBodyVersionBindData>();
+    if (input.inputs[0].IsNull() || input.inputs[1].IsNull()) {
+        throw BinderException("crawl_record_body_version(): url and body must not be NULL");
+    }
+    bind_data->url = StringValue::Get(input.inputs[0]);
+    bind_data->body = StringValue::Get(input.inputs[1]);
+
+    return_types = {LogicalType::VARCHAR, LogicalType::BIGINT};
+    names = {"url", "version"};
+    return std::move(bind_data);
+}
+
+static unique_ptr<GlobalTableFunctionState> RecordBodyVersionInitGlobal(ClientContext &context,
+                                                                        TableFunctionInitInput &input) {
+    return make_uniq<RecordBodyVersionGlobalState>();
+}
+
+// One row: the version written, NULL if the body equals the latest version
+static void RecordBodyVersionFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &bind_data = data.bind_data->Cast<RecordBodyVersionBindData>();
+    auto &state = data.global_state->Cast<RecordBodyVersionGlobalState>();
+
+    if (state.done) {
+        output.SetCardinality(0);
+        return;
+    }
+    state.done = true;
+
+    Connection conn(*context.db);
+    auto version = RecordBodyVersion(conn, bind_data.url, bind_data.body, GenerateContentHash(bind_data.body),
+                                     GetKeyframeInterval(context));
+
+    output.SetValue(0, 0, Value(bind_data.url));
+    output.SetValue(1, 0, version > 0 ? Value::BIGINT(version) : Value(LogicalType::BIGINT));
+    output.SetCardinality(1);
+}
+
+//===--------------------------------------------------------------------===//
+// Register Function
+//===--------------------------------------------------------------------===//
+
+void RegisterBodyVersionsFunction(ExtensionLoader &loader) {
+    TableFunction func("crawl_body_versions", {LogicalType::VARCHAR}, BodyVersionsFunction, BodyVersionsBind,
+                       BodyVersionsInitGlobal);
+    func.named_parameters["as_of"] = LogicalType::TIMESTAMP;
+    loader.RegisterFunction(func);
+
+    TableFunction record_func("crawl_record_body_version", {LogicalType::VARCHAR, LogicalType::VARCHAR},
+                              RecordBodyVersionFunction, RecordBodyVersionBind, RecordBodyVersionInitGlobal);
+    loader.RegisterFunction(record_func);
+}
+
+} // namespace duckdb
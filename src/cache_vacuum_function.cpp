@@ -0,0 +1,126 @@
+// crawler_cache_vacuum() - __crawler_cache maintenance
+//
+// Usage:
+//   SELECT * FROM crawler_cache_vacuum();
+//   SELECT * FROM crawler_cache_vacuum(max_age_hours := 24, max_bytes := 1073741824);
+//
+// Deletes rows older than max_age_hours, then evicts the oldest rows until the table fits
+// in max_bytes. Defaults come from crawler_cache_max_age_hours / crawler_cache_max_bytes.
+// Extracted facets (__crawler_facets) older than max_age_hours or written by other
+// extractor versions are deleted too.
+
+#include "cache_vacuum_function.hpp"
+#include "response_cache.hpp"
+#include "facet_cache.hpp"
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Bind Data
+//===--------------------------------------------------------------------===//
+
+struct CacheVacuumBindData : public TableFunctionData {
+    int64_t max_age_hours = 0;
+    int64_t max_bytes = 0;
+    idx_t batch_size = DEFAULT_VACUUM_BATCH_SIZE;
+};
+
+//===--------------------------------------------------------------------===//
+// Global State
+//===--------------------------------------------------------------------===//
+
+struct CacheVacuumGlobalState : public GlobalTableFunctionState {
+    bool done = false;
+
+    idx_t MaxThreads() const override { return 1; }
+};
+
+//===--------------------------------------------------------------------===//
+// Bind Function
+//===--------------------------------------------------------------------===//
+
+static unique_ptr<FunctionData> CacheVacuumBind(ClientContext &context, TableFunctionBindInput &input,
+                                                vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<CacheVacuumBindData>();
+    bind_data->max_age_hours = GetCacheMaxAgeHours(context);
+    bind_data->max_bytes = GetCacheMaxBytes(context);
+
+    for (auto &kv : input.named_parameters) {
+        if (kv.second.IsNull()) continue;
+        if (kv.first == "max_age_hours") {
+            bind_data->max_age_hours = kv.second.GetValue<int64_t>();
+        } else if (kv.first == "max_bytes") {
+            bind_data->max_bytes = kv.second.GetValue<int64_t>();
+        } else if (kv.first == "batch_size") {
+            auto batch_size = kv.second.GetValue<int64_t>();
+            if (batch_size < 1) {
+                throw BinderException("crawler_cache_vacuum(): batch_size must be at least 1");
+            }
+            bind_data->batch_size = static_cast<idx_t>(batch_size);
+        }
+    }
+
+    return_types = {LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT};
+    names = {"expired", "evicted", "remaining_rows", "remaining_bytes"};
+    return std::move(bind_data);
+}
+
+//===--------------------------------------------------------------------===//
+// Init Global
+//===--------------------------------------------------------------------===//
+
+static unique_ptr<GlobalTableFunctionState> CacheVacuumInitGlobal(ClientContext &context,
+                                                                  TableFunctionInitInput &input) {
+    return make_uniq<CacheVacuumGlobalState>();
+}
+
+//===--------------------------------------------------------------------===//
+// Table Function
+//===--------------------------------------------------------------------===//
+
+static void CacheVacuumFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &bind_data = data.bind_data->Cast<CacheVacuumBindData>();
+    auto &state = data.global_state->Cast<CacheVacuumGlobalState>();
+
+    if (state.done) {
+        output.SetCardinality(0);
+        return;
+    }
+    state.done = true;
+
+    Connection conn(*context.db);
+    auto stats = VacuumCacheTable(conn, bind_data.max_age_hours, bind_data.max_bytes, bind_data.batch_size);
+
+    // Evicted rows must not be served from the memory tier either
+    if (stats.expired > 0 || stats.evicted > 0) {
+        ResponseCache::Get(context)->Clear();
+    }
+
+    if (PruneFacetTable(conn, bind_data.max_age_hours) > 0) {
+        if (auto facet_cache = FacetCache::Get(context)) {
+            facet_cache->Clear();
+        }
+    }
+
+    output.SetValue(0, 0, Value::BIGINT(stats.expired));
+    output.SetValue(1, 0, Value::BIGINT(stats.evicted));
+    output.SetValue(2, 0, Value::BIGINT(stats.remaining_rows));
+    output.SetValue(3, 0, Value::BIGINT(stats.remaining_bytes));
+    output.SetCardinality(1);
+}
+
+//===--------------------------------------------------------------------===//
+// Register Function
+//===--------------------------------------------------------------------===//
+
+void RegisterCacheVacuumFunction(ExtensionLoader &loader) {
+    TableFunction func("crawler_cache_vacuum", {}, CacheVacuumFunction, CacheVacuumBind, CacheVacuumInitGlobal);
+    func.named_parameters["max_age_hours"] = LogicalType::BIGINT;
+    func.named_parameters["max_bytes"] = LogicalType::BIGINT;
+    func.named_parameters["batch_size"] = LogicalType::BIGINT;
+    loader.RegisterFunction(func);
+}
+
+} // namespace duckdb
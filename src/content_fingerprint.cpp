@@ -0,0 +1,504 @@
+#include "content_fingerprint.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// XXH3-128 (seed 0, default secret)
+//===--------------------------------------------------------------------===//
+// Scalar port of the reference algorithm; the 64-byte stripe loop is written so that
+// compilers auto-vectorize it (SSE2/AVX2/NEON) without intrinsics.
+
+static constexpr uint32_t PRIME32_1 = 0x9E3779B1U;
+static constexpr uint32_t PRIME32_2 = 0x85EBCA77U;
+static constexpr uint32_t PRIME32_3 = 0xC2B2AE3DU;
+static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static constexpr size_t STRIPE_LEN = 64;
+static constexpr size_t SECRET_CONSUME_RATE = 8;
+static constexpr size_t ACC_NB = STRIPE_LEN / sizeof(uint64_t);
+static constexpr size_t SECRET_MERGEACCS_START = 11;
+static constexpr size_t SECRET_LASTACC_START = 7;
+static constexpr size_t SECRET_SIZE_MIN = 136;
+static constexpr size_t MID_SIZE_MAX = 240;
+static constexpr size_t SECRET_SIZE = 192;
+
+static const uint8_t DEFAULT_SECRET[SECRET_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+static inline uint32_t ByteSwap32(uint32_t x) {
+	return ((x << 24) & 0xff000000U) | ((x << 8) & 0x00ff0000U) | ((x >> 8) & 0x0000ff00U) |
+	       ((x >> 24) & 0x000000ffU);
+}
+
+static inline uint64_t ByteSwap64(uint64_t x) {
+	return (static_cast<uint64_t>(ByteSwap32(static_cast<uint32_t>(x))) << 32) |
+	       ByteSwap32(static_cast<uint32_t>(x >> 32));
+}
+
+static inline uint32_t ReadLE32(const uint8_t *ptr) {
+	uint32_t value;
+	memcpy(&value, ptr, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	value = ByteSwap32(value);
+#endif
+	return value;
+}
+
+static inline uint64_t ReadLE64(const uint8_t *ptr) {
+	uint64_t value;
+	memcpy(&value, ptr, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	value = ByteSwap64(value);
+#endif
+	return value;
+}
+
+static inline uint32_t Rotl32(uint32_t x, int r) {
+	return (x << r) | (x >> (32 - r));
+}
+
+static inline uint64_t Rotl64(uint64_t x, int r) {
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline void Mul64To128(uint64_t a, uint64_t b, uint64_t &low, uint64_t &high) {
+#if defined(__SIZEOF_INT128__)
+	__uint128_t product = static_cast<__uint128_t>(a) * b;
+	low = static_cast<uint64_t>(product);
+	high = static_cast<uint64_t>(product >> 64);
+#else
+	uint64_t lo_lo = (a & 0xFFFFFFFFULL) * (b & 0xFFFFFFFFULL);
+	uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFFULL);
+	uint64_t lo_hi = (a & 0xFFFFFFFFULL) * (b >> 32);
+	uint64_t hi_hi = (a >> 32) * (b >> 32);
+	uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+	high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+	low = (cross << 32) | (lo_lo & 0xFFFFFFFFULL);
+#endif
+}
+
+static inline uint64_t Mul128Fold64(uint64_t a, uint64_t b) {
+	uint64_t low, high;
+	Mul64To128(a, b, low, high);
+	return low ^ high;
+}
+
+static inline uint64_t XorShift64(uint64_t value, int shift) {
+	return value ^ (value >> shift);
+}
+
+static inline uint64_t XXH64Avalanche(uint64_t h) {
+	h ^= h >> 33;
+	h *= PRIME64_2;
+	h ^= h >> 29;
+	h *= PRIME64_3;
+	h ^= h >> 32;
+	return h;
+}
+
+static inline uint64_t XXH3Avalanche(uint64_t h) {
+	h = XorShift64(h, 37);
+	h *= 0x165667919E3779F9ULL;
+	return XorShift64(h, 32);
+}
+
+static inline uint64_t Mix16B(const uint8_t *input, const uint8_t *secret) {
+	return Mul128Fold64(ReadLE64(input) ^ ReadLE64(secret), ReadLE64(input + 8) ^ ReadLE64(secret + 8));
+}
+
+static inline void Mix32B(uint64_t &low, uint64_t &high, const uint8_t *input_1, const uint8_t *input_2,
+                          const uint8_t *secret) {
+	low += Mix16B(input_1, secret);
+	low ^= ReadLE64(input_2) + ReadLE64(input_2 + 8);
+	high += Mix16B(input_2, secret + 16);
+	high ^= ReadLE64(input_1) + ReadLE64(input_1 + 8);
+}
+
+static ContentHash128 Hash1To3(const uint8_t *input, size_t len) {
+	uint8_t c1 = input[0];
+	uint8_t c2 = input[len >> 1];
+	uint8_t c3 = input[len - 1];
+	uint32_t combined_low = (static_cast<uint32_t>(c1) << 16) | (static_cast<uint32_t>(c2) << 24) |
+	                        static_cast<uint32_t>(c3) | (static_cast<uint32_t>(len) << 8);
+	uint32_t combined_high = Rotl32(ByteSwap32(combined_low), 13);
+	uint64_t flip_low = static_cast<uint64_t>(ReadLE32(DEFAULT_SECRET) ^ ReadLE32(DEFAULT_SECRET + 4));
+	uint64_t flip_high = static_cast<uint64_t>(ReadLE32(DEFAULT_SECRET + 8) ^ ReadLE32(DEFAULT_SECRET + 12));
+
+	ContentHash128 result;
+	result.low = XXH64Avalanche(combined_low ^ flip_low);
+	result.high = XXH64Avalanche(combined_high ^ flip_high);
+	return result;
+}
+
+static ContentHash128 Hash4To8(const uint8_t *input, size_t len) {
+	uint32_t input_low = ReadLE32(input);
+	uint32_t input_high = ReadLE32(input + len - 4);
+	uint64_t input_64 = input_low + (static_cast<uint64_t>(input_high) << 32);
+	uint64_t flip = ReadLE64(DEFAULT_SECRET + 16) ^ ReadLE64(DEFAULT_SECRET + 24);
+	uint64_t keyed = input_64 ^ flip;
+
+	uint64_t low, high;
+	Mul64To128(keyed, PRIME64_1 + (static_cast<uint64_t>(len) << 2), low, high);
+	high += low << 1;
+	low ^= high >> 3;
+	low = XorShift64(low, 35) * 0x9FB21C651E98DF25ULL;
+	low = XorShift64(low, 28);
+
+	ContentHash128 result;
+	result.low = low;
+	result.high = XXH3Avalanche(high);
+	return result;
+}
+
+static ContentHash128 Hash9To16(const uint8_t *input, size_t len) {
+	uint64_t flip_low = ReadLE64(DEFAULT_SECRET + 32) ^ ReadLE64(DEFAULT_SECRET + 40);
+	uint64_t flip_high = ReadLE64(DEFAULT_SECRET + 48) ^ ReadLE64(DEFAULT_SECRET + 56);
+	uint64_t input_low = ReadLE64(input);
+	uint64_t input_high = ReadLE64(input + len - 8);
+
+	uint64_t mul_low, mul_high;
+	Mul64To128(input_low ^ input_high ^ flip_low, PRIME64_1, mul_low, mul_high);
+	mul_low += static_cast<uint64_t>(len - 1) << 54;
+	input_high ^= flip_high;
+	mul_high += input_high + static_cast<uint64_t>(static_cast<uint32_t>(input_high)) * (PRIME32_2 - 1);
+	mul_low ^= ByteSwap64(mul_high);
+
+	uint64_t result_low, result_high;
+	Mul64To128(mul_low, PRIME64_2, result_low, result_high);
+	result_high += mul_high * PRIME64_2;
+
+	ContentHash128 result;
+	result.low = XXH3Avalanche(result_low);
+	result.high = XXH3Avalanche(result_high);
+	return result;
+}
+
+static ContentHash128 FinalizeMid(uint64_t low, uint64_t high, size_t len) {
+	ContentHash128 result;
+	result.low = XXH3Avalanche(low + high);
+	result.high = 0ULL - XXH3Avalanche(low * PRIME64_1 + high * PRIME64_4 + static_cast<uint64_t>(len) * PRIME64_2);
+	return result;
+}
+
+static ContentHash128 Hash17To128(const uint8_t *input, size_t len) {
+	uint64_t low = static_cast<uint64_t>(len) * PRIME64_1;
+	uint64_t high = 0;
+	if (len > 32) {
+		if (len > 64) {
+			if (len > 96) {
+				Mix32B(low, high, input + 48, input + len - 64, DEFAULT_SECRET + 96);
+			}
+			Mix32B(low, high, input + 32, input + len - 48, DEFAULT_SECRET + 64);
+		}
+		Mix32B(low, high, input + 16, input + len - 32, DEFAULT_SECRET + 32);
+	}
+	Mix32B(low, high, input, input + len - 16, DEFAULT_SECRET);
+	return FinalizeMid(low, high, len);
+}
+
+static ContentHash128 Hash129To240(const uint8_t *input, size_t len) {
+	static constexpr size_t START_OFFSET = 3;
+	static constexpr size_t LAST_OFFSET = 17;
+	size_t num_rounds = len / 32;
+
+	uint64_t low = static_cast<uint64_t>(len) * PRIME64_1;
+	uint64_t high = 0;
+	size_t i = 0;
+	for (; i < 4; i++) {
+		Mix32B(low, high, input + 32 * i, input + 32 * i + 16, DEFAULT_SECRET + 32 * i);
+	}
+	low = XXH3Avalanche(low);
+	high = XXH3Avalanche(high);
+	for (; i < num_rounds; i++) {
+		Mix32B(low, high, input + 32 * i, input + 32 * i + 16, DEFAULT_SECRET + START_OFFSET + 32 * (i - 4));
+	}
+	Mix32B(low, high, input + len - 16, input + len - 32, DEFAULT_SECRET + SECRET_SIZE_MIN - LAST_OFFSET - 16);
+	return FinalizeMid(low, high, len);
+}
+
+static inline void Accumulate512(uint64_t *acc, const uint8_t *input, const uint8_t *secret) {
+	for (size_t i = 0; i < ACC_NB; i++) {
+		uint64_t data_val = ReadLE64(input + 8 * i);
+		uint64_t data_key = data_val ^ ReadLE64(secret + 8 * i);
+		acc[i ^ 1] += data_val;
+		acc[i] += (data_key & 0xFFFFFFFFULL) * (data_key >> 32);
+	}
+}
+
+static inline void ScrambleAcc(uint64_t *acc, const uint8_t *secret) {
+	for (size_t i = 0; i < ACC_NB; i++) {
+		uint64_t value = XorShift64(acc[i], 47) ^ ReadLE64(secret + 8 * i);
+		acc[i] = value * PRIME32_1;
+	}
+}
+
+static uint64_t MergeAccs(const uint64_t *acc, const uint8_t *secret, uint64_t start) {
+	uint64_t result = start;
+	for (size_t i = 0; i < 4; i++) {
+		result += Mul128Fold64(acc[2 * i] ^ ReadLE64(secret + 16 * i), acc[2 * i + 1] ^ ReadLE64(secret + 16 * i + 8));
+	}
+	return XXH3Avalanche(result);
+}
+
+static ContentHash128 HashLong(const uint8_t *input, size_t len) {
+	uint64_t acc[ACC_NB] = {PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+
+	const size_t stripes_per_block = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+	const size_t block_len = STRIPE_LEN * stripes_per_block;
+	const size_t num_blocks = (len - 1) / block_len;
+
+	for (size_t block = 0; block < num_blocks; block++) {
+		for (size_t stripe = 0; stripe < stripes_per_block; stripe++) {
+			Accumulate512(acc, input + block * block_len + stripe * STRIPE_LEN,
+			              DEFAULT_SECRET + stripe * SECRET_CONSUME_RATE);
+		}
+		ScrambleAcc(acc, DEFAULT_SECRET + SECRET_SIZE - STRIPE_LEN);
+	}
+
+	// Last partial block, then the last stripe (which may overlap the previous one)
+	const size_t last_stripes = ((len - 1) - block_len * num_blocks) / STRIPE_LEN;
+	for (size_t stripe = 0; stripe < last_stripes; stripe++) {
+		Accumulate512(acc, input + num_blocks * block_len + stripe * STRIPE_LEN,
+		              DEFAULT_SECRET + stripe * SECRET_CONSUME_RATE);
+	}
+	Accumulate512(acc, input + len - STRIPE_LEN, DEFAULT_SECRET + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START);
+
+	ContentHash128 result;
+	result.low = MergeAccs(acc, DEFAULT_SECRET + SECRET_MERGEACCS_START, static_cast<uint64_t>(len) * PRIME64_1);
+	result.high = MergeAccs(acc, DEFAULT_SECRET + SECRET_SIZE - sizeof(acc) - SECRET_MERGEACCS_START,
+	                        ~(static_cast<uint64_t>(len) * PRIME64_2));
+	return result;
+}
+
+ContentHash128 HashContent128(const char *data, size_t len) {
+	auto input = reinterpret_cast<const uint8_t *>(data);
+	if (len == 0) {
+		ContentHash128 result;
+		result.low = XXH64Avalanche(ReadLE64(DEFAULT_SECRET + 64) ^ ReadLE64(DEFAULT_SECRET + 72));
+		result.high = XXH64Avalanche(ReadLE64(DEFAULT_SECRET + 80) ^ ReadLE64(DEFAULT_SECRET + 88));
+		return result;
+	}
+	if (len <= 3) {
+		return Hash1To3(input, len);
+	}
+	if (len <= 8) {
+		return Hash4To8(input, len);
+	}
+	if (len <= 16) {
+		return Hash9To16(input, len);
+	}
+	if (len <= 128) {
+		return Hash17To128(input, len);
+	}
+	if (len <= MID_SIZE_MAX) {
+		return Hash129To240(input, len);
+	}
+	return HashLong(input, len);
+}
+
+std::string ContentHash128::ToHex() const {
+	char buf[33];
+	snprintf(buf, sizeof(buf), "%016llx%016llx", static_cast<unsigned long long>(high),
+	         static_cast<unsigned long long>(low));
+	return std::string(buf, 32);
+}
+
+//===--------------------------------------------------------------------===//
+// SimHash over visible text
+//===--------------------------------------------------------------------===//
+
+static bool IsWordByte(unsigned char c) {
+	return std::isalnum(c) || c >= 0x80;  // UTF-8 sequences are kept inside words
+}
+
+// Elements whose content is not visible text
+static bool IsRawTextElement(const std::string &name) {
+	return name == "script" || name == "style" || name == "noscript" || name == "template" || name == "svg";
+}
+
+// Position after the closing tag </name> (case-insensitive), or npos
+static size_t SkipPastClosingTag(const std::string &html, size_t pos, const std::string &name) {
+	while ((pos = html.find("</", pos)) != std::string::npos) {
+		size_t i = 0;
+		while (i < name.size() && pos + 2 + i < html.size() &&
+		       std::tolower(static_cast<unsigned char>(html[pos + 2 + i])) == name[i]) {
+			i++;
+		}
+		if (i == name.size()) {
+			size_t gt = html.find('>', pos + 2 + i);
+			return gt == std::string::npos ? gt : gt + 1;
+		}
+		pos += 2;
+	}
+	return std::string::npos;
+}
+
+bool SimHashFingerprint(const std::string &html, uint64_t &fingerprint) {
+	int32_t weights[64] = {0};
+	uint64_t window[3] = {0, 0, 0};  // Hashes of the last three words
+	size_t num_words = 0;
+	size_t num_shingles = 0;
+	std::string word;
+
+	auto end_word = [&]() {
+		if (word.empty()) {
+			return;
+		}
+		window[0] = window[1];
+		window[1] = window[2];
+		window[2] = HashContent128(word.data(), word.size()).low;
+		word.clear();
+		if (++num_words < 3) {
+			return;
+		}
+		uint64_t shingle = XXH64Avalanche(window[0] ^ Rotl64(window[1], 21) ^ Rotl64(window[2], 42));
+		for (int bit = 0; bit < 64; bit++) {
+			weights[bit] += static_cast<int32_t>((shingle >> bit) & 1) * 2 - 1;
+		}
+		num_shingles++;
+	};
+
+	const size_t n = html.size();
+	size_t i = 0;
+	while (i < n) {
+		unsigned char c = static_cast<unsigned char>(html[i]);
+		if (c == '<') {
+			end_word();
+			if (html.compare(i, 4, "<!--") == 0) {
+				size_t close = html.find("-->", i + 4);
+				i = close == std::string::npos ? n : close + 3;
+				continue;
+			}
+			size_t j = i + 1;
+			bool closing = j < n && html[j] == '/';
+			if (closing) {
+				j++;
+			}
+			std::string name;
+			while (j < n && std::isalnum(static_cast<unsigned char>(html[j])) && name.size() < 16) {
+				name += static_cast<char>(std::tolower(static_cast<unsigned char>(html[j])));
+				j++;
+			}
+			size_t gt = html.find('>', j);
+			if (gt == std::string::npos) {
+				break;
+			}
+			i = gt + 1;
+			if (!closing && html[gt - 1] != '/' && IsRawTextElement(name)) {
+				i = SkipPastClosingTag(html, i, name);
+				if (i == std::string::npos) {
+					break;
+				}
+			}
+			continue;
+		}
+		if (c == '&') {
+			// Entities separate words; skip the reference itself
+			end_word();
+			size_t semicolon = html.find(';', i);
+			i = (semicolon != std::string::npos && semicolon - i <= 10) ? semicolon + 1 : i + 1;
+			continue;
+		}
+		if (IsWordByte(c)) {
+			word += static_cast<char>(std::tolower(c));
+		} else {
+			end_word();
+		}
+		i++;
+	}
+	end_word();
+
+	if (num_shingles < SIMHASH_MIN_SHINGLES) {
+		return false;
+	}
+	fingerprint = 0;
+	for (int bit = 0; bit < 64; bit++) {
+		if (weights[bit] > 0) {
+			fingerprint |= 1ULL << bit;
+		}
+	}
+	return true;
+}
+
+int HammingDistance64(uint64_t a, uint64_t b) {
+	uint64_t x = a ^ b;
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(x);
+#else
+	int count = 0;
+	while (x) {
+		x &= x - 1;
+		count++;
+	}
+	return count;
+#endif
+}
+
+//===--------------------------------------------------------------------===//
+// NearDuplicateIndex
+//===--------------------------------------------------------------------===//
+
+NearDuplicateIndex::NearDuplicateIndex(int max_distance)
+    : max_distance_(max_distance < 0 ? 0 : (max_distance > MAX_DISTANCE ? MAX_DISTANCE : max_distance)),
+      num_bands_(max_distance_ + 1), bands_(num_bands_) {
+}
+
+uint64_t NearDuplicateIndex::BandKey(uint64_t simhash, int band) const {
+	int start = band * 64 / num_bands_;
+	int end = (band + 1) * 64 / num_bands_;
+	int width = end - start;
+	uint64_t mask = width >= 64 ? ~0ULL : ((1ULL << width) - 1);
+	return (simhash >> start) & mask;
+}
+
+std::string NearDuplicateIndex::FindOrInsert(const std::string &url, const ContentHash128 &hash, bool has_simhash,
+                                             uint64_t simhash) {
+	auto exact = exact_.find(hash);
+	if (exact != exact_.end()) {
+		return exact->second;
+	}
+
+	if (has_simhash) {
+		for (int band = 0; band < num_bands_; band++) {
+			auto range = bands_[band].equal_range(BandKey(simhash, band));
+			for (auto it = range.first; it != range.second; ++it) {
+				auto &candidate = documents_[it->second];
+				if (HammingDistance64(candidate.first, simhash) <= max_distance_) {
+					return candidate.second;
+				}
+			}
+		}
+	}
+
+	exact_.emplace(hash, url);
+	if (has_simhash) {
+		size_t idx = documents_.size();
+		documents_.emplace_back(simhash, url);
+		for (int band = 0; band < num_bands_; band++) {
+			bands_[band].emplace(BandKey(simhash, band), idx);
+		}
+	}
+	return "";
+}
+
+} // namespace duckdb
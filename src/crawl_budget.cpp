@@ -0,0 +1,96 @@
+#include "crawl_budget.hpp"
+#include "crawler_utils.hpp"
+#include "pipeline_state.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// CrawlBudget
+//===--------------------------------------------------------------------===//
+
+static int64_t IntervalToMilliseconds(const Value &value) {
+    return Interval::GetMicro(value.GetValue<interval_t>()) / Interval::MICROS_PER_MSEC;
+}
+
+CrawlBudget CrawlBudget::FromSettings(ClientContext &context) {
+    CrawlBudget budget;
+    Value setting_value;
+    if (context.TryGetCurrentSetting("crawler_max_duration", setting_value) && !setting_value.IsNull()) {
+        budget.max_duration_ms = MaxValue<int64_t>(IntervalToMilliseconds(setting_value), 0);
+    }
+    if (context.TryGetCurrentSetting("crawler_max_bytes", setting_value) && !setting_value.IsNull()) {
+        budget.max_bytes = MaxValue<int64_t>(setting_value.GetValue<int64_t>(), 0);
+    }
+    if (context.TryGetCurrentSetting("crawler_max_requests_per_host", setting_value) && !setting_value.IsNull()) {
+        budget.max_requests_per_host = MaxValue<int64_t>(setting_value.GetValue<int64_t>(), 0);
+    }
+    return budget;
+}
+
+bool CrawlBudget::ApplyParameter(const string &function_name, const string &name, const Value &value) {
+    int64_t *target;
+    if (name == "max_duration") {
+        target = &max_duration_ms;
+    } else if (name == "max_bytes") {
+        target = &max_bytes;
+    } else if (name == "max_requests_per_host") {
+        target = &max_requests_per_host;
+    } else {
+        return false;
+    }
+    if (value.IsNull()) {
+        return true;
+    }
+    *target = name == "max_duration" ? IntervalToMilliseconds(value) : value.GetValue<int64_t>();
+    if (*target < 0) {
+        throw BinderException("%s(): %s must not be negative", function_name, name);
+    }
+    return true;
+}
+
+//===--------------------------------------------------------------------===//
+// CrawlBudgetTracker
+//===--------------------------------------------------------------------===//
+
+CrawlBudgetTracker::CrawlBudgetTracker(const CrawlBudget &budget)
+    : budget_(budget),
+      deadline_(std::chrono::steady_clock::now() + std::chrono::milliseconds(budget.max_duration_ms)) {
+}
+
+bool CrawlBudgetTracker::Exhausted() const {
+    if (exhausted_.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    bool spent = (budget_.max_duration_ms > 0 && std::chrono::steady_clock::now() >= deadline_) ||
+                 (budget_.max_bytes > 0 && bytes_.load(std::memory_order_relaxed) >= budget_.max_bytes);
+    if (spent) {
+        exhausted_.store(true, std::memory_order_relaxed);
+    }
+    return spent;
+}
+
+bool CrawlBudgetTracker::TryAcquireHost(const string &url) {
+    if (budget_.max_requests_per_host <= 0) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(host_mutex_);
+    auto &requests = host_requests_[ExtractDomain(url)];
+    if (requests >= budget_.max_requests_per_host) {
+        return false;
+    }
+    requests++;
+    return true;
+}
+
+std::shared_ptr<CrawlBudgetTracker> ResolveBudgetTracker(ClientContext &context, const CrawlBudget &budget) {
+    auto pipeline_state = GetPipelineState(context);
+    if (pipeline_state && pipeline_state->budget) {
+        return pipeline_state->budget;
+    }
+    if (budget.IsLimited()) {
+        return std::make_shared<CrawlBudgetTracker>(budget);
+    }
+    return nullptr;
+}
+
+} // namespace duckdb
@@ -0,0 +1,195 @@
+// crawl_due() - change-rate-aware recrawl source
+//
+// Usage:
+//   SELECT url FROM crawl_due(budget := 500);
+//
+//   CRAWLING MERGE INTO products
+//   USING (SELECT c.* FROM crawl_due(budget := 500) d, LATERAL crawl_url(d.url) c) AS src
+//   ON (src.url = products.url)
+//   WHEN MATCHED THEN UPDATE BY NAME
+//   WHEN NOT MATCHED THEN INSERT BY NAME;
+//
+// Returns URLs whose next_due has passed, most likely changed first. Change rates are
+// learned from content hashes of earlier fetches (crawler_track_changes).
+// Bodies fetched elsewhere can be recorded explicitly:
+//   SELECT * FROM crawl_record_change('https://shop.example.com/item', body);
+
+#include "crawl_due_function.hpp"
+#include "recrawl_scheduler.hpp"
+#include "crawler_utils.hpp"
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+static constexpr int64_t DEFAULT_CRAWL_DUE_BUDGET = 1000;
+
+//===--------------------------------------------------------------------===//
+// Bind Data
+//===--------------------------------------------------------------------===//
+
+struct CrawlDueBindData : public TableFunctionData {
+    int64_t budget = DEFAULT_CRAWL_DUE_BUDGET;
+};
+
+//===--------------------------------------------------------------------===//
+// Global State
+//===--------------------------------------------------------------------===//
+
+struct CrawlDueGlobalState : public GlobalTableFunctionState {
+    unique_ptr<Connection> conn;
+    unique_ptr<QueryResult> result;  // Streamed, at most `budget` rows
+
+    idx_t MaxThreads() const override { return 1; }
+};
+
+//===--------------------------------------------------------------------===//
+// Bind Function
+//===--------------------------------------------------------------------===//
+
+static unique_ptr<FunctionData> CrawlDueBind(ClientContext &context, TableFunctionBindInput &input,
+                                             vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<CrawlDueBindData>();
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "budget" && !kv.second.IsNull()) {
+            bind_data->budget = kv.second.GetValue<int64_t>();
+            if (bind_data->budget < 0) {
+                throw BinderException("crawl_due(): budget must not be negative");
+            }
+        }
+    }
+
+    return_types = {LogicalType::VARCHAR, LogicalType::TIMESTAMP, LogicalType::TIMESTAMP, LogicalType::DOUBLE,
+                    LogicalType::DOUBLE};
+    names = {"url", "next_due", "last_checked", "changes_per_day", "change_probability"};
+    return std::move(bind_data);
+}
+
+//===--------------------------------------------------------------------===//
+// Init Global
+//===--------------------------------------------------------------------===//
+
+static unique_ptr<GlobalTableFunctionState> CrawlDueInitGlobal(ClientContext &context, TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<CrawlDueBindData>();
+    auto state = make_uniq<CrawlDueGlobalState>();
+    state->conn = make_uniq<Connection>(*context.db);
+    EnsureChangeStatsTable(*state->conn);
+
+    // Value of a refetch = probability the page changed since the last check, assuming
+    // Poisson changes at the learned rate. URLs without a rate yet are always worth it.
+    string sql = "SELECT url, next_due, last_checked, changes_per_day, "
+                 "coalesce(1 - exp(-changes_per_day / 86400.0 * "
+                 "date_diff('second', last_checked, current_timestamp::TIMESTAMP)), 1.0) AS change_probability "
+                 "FROM " + string(CHANGE_STATS_TABLE_NAME) + " "
+                 "WHERE next_due <= current_timestamp::TIMESTAMP "
+                 "ORDER BY change_probability DESC, next_due, url "
+                 "LIMIT " + std::to_string(bind_data.budget);
+    state->result = state->conn->Query(sql);
+    if (state->result->HasError()) {
+        throw IOException("crawl_due(): %s", state->result->GetError());
+    }
+    return std::move(state);
+}
+
+//===--------------------------------------------------------------------===//
+// Table Function
+//===--------------------------------------------------------------------===//
+
+static void CrawlDueFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<CrawlDueGlobalState>();
+    auto chunk = state.result->Fetch();
+    if (!chunk || chunk->size() == 0) {
+        output.SetCardinality(0);
+        return;
+    }
+    for (idx_t col = 0; col < output.ColumnCount(); col++) {
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            output.SetValue(col, row, chunk->GetValue(col, row));
+        }
+    }
+    output.SetCardinality(chunk->size());
+}
+
+//===--------------------------------------------------------------------===//
+// crawl_record_change()
+//===--------------------------------------------------------------------===//
+
+struct RecordChangeBindData : public TableFunctionData {
+    string url;
+    string body;
+};
+
+struct RecordChangeGlobalState : public GlobalTableFunctionState {
+    bool done = false;
+
+    idx_t MaxThreads() const override { return 1; }
+};
+
+static unique_ptr<FunctionData> RecordChangeBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<RecordChangeBindData>();
+    if (input.inputs[0].IsNull() || input.inputs[1].IsNull()) {
+        throw BinderException("crawl_record_change(): url and body must not be NULL");
+    }
+    bind_data->url = StringValue::Get(input.inputs[0]);
+    bind_data->body = StringValue::Get(input.inputs[1]);
+
+    return_types = {LogicalType::VARCHAR, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::DOUBLE,
+                    LogicalType::TIMESTAMP};
+    names = {"url", "checks", "changes", "changes_per_day", "next_due"};
+    return std::move(bind_data);
+}
+
+static unique_ptr<GlobalTableFunctionState> RecordChangeInitGlobal(ClientContext &context,
+                                                                   TableFunctionInitInput &input) {
+    return make_uniq<RecordChangeGlobalState>();
+}
+
+// One row: the URL's change stats after recording the body
+static void RecordChangeFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &bind_data = data.bind_data->Cast<RecordChangeBindData>();
+    auto &state = data.global_state->Cast<RecordChangeGlobalState>();
+
+    if (state.done) {
+        output.SetCardinality(0);
+        return;
+    }
+    state.done = true;
+
+    Connection conn(*context.db);
+    EnsureChangeStatsTable(conn);
+    RecordChangeObservation(context, conn, bind_data.url, GenerateContentHash(bind_data.body));
+
+    auto result = conn.Query("SELECT url, checks, changes, changes_per_day, next_due FROM " +
+                                 string(CHANGE_STATS_TABLE_NAME) + " WHERE surt_key = $1",
+                             GenerateSurtKey(bind_data.url));
+    if (result->HasError()) {
+        throw IOException("crawl_record_change(): %s", result->GetError());
+    }
+    auto chunk = result->Fetch();
+    if (!chunk || chunk->size() == 0) {
+        output.SetCardinality(0);
+        return;
+    }
+    for (idx_t col = 0; col < output.ColumnCount(); col++) {
+        output.SetValue(col, 0, chunk->GetValue(col, 0));
+    }
+    output.SetCardinality(1);
+}
+
+//===--------------------------------------------------------------------===//
+// Register Function
+//===--------------------------------------------------------------------===//
+
+void RegisterCrawlDueFunction(ExtensionLoader &loader) {
+    TableFunction func("crawl_due", {}, CrawlDueFunction, CrawlDueBind, CrawlDueInitGlobal);
+    func.named_parameters["budget"] = LogicalType::BIGINT;
+    loader.RegisterFunction(func);
+
+    // crawl_record_change(url, body)
+    TableFunction record_func("crawl_record_change", {LogicalType::VARCHAR, LogicalType::VARCHAR},
+                              RecordChangeFunction, RecordChangeBind, RecordChangeInitGlobal);
+    loader.RegisterFunction(record_func);
+}
+
+} // namespace duckdb
@@ -0,0 +1,332 @@
+#include "crawl_frontier.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
+namespace duckdb {
+
+// Stale heap items (rescored or popped slots) are dropped once they outnumber live ones
+static constexpr idx_t HEAP_COMPACT_MIN_SIZE = 1024;
+
+Value LastmodAgeDays(ClientContext &context, const Value &lastmod) {
+    if (lastmod.IsNull()) {
+        return Value(LogicalType::DOUBLE);
+    }
+    // TIMESTAMPTZ parses both '2025-01-15' and '2025-01-15T10:00:00+02:00'
+    Value parsed, utc;
+    if (!lastmod.TryCastAs(context, LogicalType::TIMESTAMP_TZ, parsed) ||
+        !parsed.TryCastAs(context, LogicalType::TIMESTAMP, utc)) {
+        return Value(LogicalType::DOUBLE);
+    }
+    auto lastmod_us = Timestamp::GetEpochMicroSeconds(utc.GetValue<timestamp_t>());
+    auto now_us = Timestamp::GetEpochMicroSeconds(Timestamp::GetCurrentTimestamp());
+    return Value::DOUBLE(MaxValue<double>(0, static_cast<double>(now_us - lastmod_us) / Interval::MICROS_PER_DAY));
+}
+
+//===--------------------------------------------------------------------===//
+// Scoring
+//===--------------------------------------------------------------------===//
+
+FrontierOrder CrawlFrontier::ParseOrder(const string &order) {
+    string lower = StringUtil::Lower(order);
+    StringUtil::Trim(lower);
+    if (lower.empty() || lower == "fifo") {
+        return FrontierOrder::FIFO;
+    }
+    if (lower == "best_first") {
+        return FrontierOrder::BEST_FIRST;
+    }
+    return FrontierOrder::EXPRESSION;
+}
+
+double CrawlFrontier::BestFirstScore(const FrontierUrl &url) {
+    double score = 1.0 / MaxValue<int>(url.depth, 1);
+    score += url.sitemap_priority.IsNull() ? 0.5 : url.sitemap_priority.GetValue<double>();
+    score += url.lastmod_age_days.IsNull() ? 0.25 : std::exp(-url.lastmod_age_days.GetValue<double>() / 30.0);
+    score += std::log1p(static_cast<double>(url.inlinks)) / 4.0;
+    return score;
+}
+
+// Scores pending URLs passed as parallel lists; $6 carries the slot index back
+string CrawlFrontier::ScoreQuery(const string &expression) {
+    return "SELECT slot, (" + expression + ")::DOUBLE FROM (SELECT "
+           "unnest($1::INTEGER[]) AS depth, "
+           "unnest($2::DOUBLE[]) AS sitemap_priority, "
+           "unnest($3::DOUBLE[]) AS lastmod_age_days, "
+           "unnest($4::BIGINT[]) AS inlinks, "
+           "unnest($5::VARCHAR[]) AS url, "
+           "unnest($6::BIGINT[]) AS slot)";
+}
+
+void CrawlFrontier::ValidateOrder(ClientContext &context, const string &order) {
+    if (ParseOrder(order) != FrontierOrder::EXPRESSION) {
+        return;
+    }
+    Connection conn(*context.db);
+    auto result = conn.Query(ScoreQuery(order), Value::LIST(LogicalType::INTEGER, {Value::INTEGER(1)}),
+                             Value::LIST(LogicalType::DOUBLE, {Value::DOUBLE(0.5)}),
+                             Value::LIST(LogicalType::DOUBLE, {Value::DOUBLE(1)}),
+                             Value::LIST(LogicalType::BIGINT, {Value::BIGINT(0)}),
+                             Value::LIST(LogicalType::VARCHAR, {Value("https://example.com/")}),
+                             Value::LIST(LogicalType::BIGINT, {Value::BIGINT(0)}));
+    if (result->HasError()) {
+        throw BinderException("crawl(): invalid priority '%s' (expected 'fifo', 'best_first' or a SQL expression "
+                              "over depth, sitemap_priority, lastmod_age_days, inlinks, url): %s",
+                              order, result->GetError());
+    }
+}
+
+//===--------------------------------------------------------------------===//
+// CrawlFrontier
+//===--------------------------------------------------------------------===//
+
+CrawlFrontier::CrawlFrontier(ClientContext &context, const string &order) : order_(ParseOrder(order)) {
+    if (order_ == FrontierOrder::EXPRESSION) {
+        expression_ = order;
+        conn_ = make_uniq<Connection>(*context.db);
+    }
+}
+
+void CrawlFrontier::Schedule(idx_t slot_idx, double score) {
+    auto &slot = slots_[slot_idx];
+    slot.score = score;
+    slot.version++;
+    heap_.push_back({score, slot.seq, slot_idx, slot.version});
+    std::push_heap(heap_.begin(), heap_.end());
+}
+
+void CrawlFrontier::Push(FrontierUrl url) {
+    auto it = index_.find(url.url);
+    if (it != index_.end()) {
+        // Already pending: another page links to it
+        auto &slot = slots_[it->second];
+        slot.url.inlinks++;
+        slot.url.depth = MinValue(slot.url.depth, url.depth);
+        if (slot.url.sitemap_priority.IsNull()) {
+            slot.url.sitemap_priority = url.sitemap_priority;
+        }
+        if (slot.url.lastmod_age_days.IsNull()) {
+            slot.url.lastmod_age_days = url.lastmod_age_days;
+        }
+        if (order_ == FrontierOrder::BEST_FIRST) {
+            Schedule(it->second, BestFirstScore(slot.url));
+        } else if (order_ == FrontierOrder::EXPRESSION && !slot.dirty) {
+            slot.dirty = true;
+            dirty_.push_back(it->second);
+        }
+        return;
+    }
+
+    idx_t slot_idx;
+    if (!free_slots_.empty()) {
+        slot_idx = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        slot_idx = slots_.size();
+        slots_.emplace_back();
+    }
+    auto &slot = slots_[slot_idx];
+    slot.url = std::move(url);
+    slot.seq = next_seq_++;
+    index_[slot.url.url] = slot_idx;
+
+    switch (order_) {
+    case FrontierOrder::FIFO:
+        Schedule(slot_idx, 0);
+        break;
+    case FrontierOrder::BEST_FIRST:
+        Schedule(slot_idx, BestFirstScore(slot.url));
+        break;
+    case FrontierOrder::EXPRESSION:
+        slot.dirty = true;
+        dirty_.push_back(slot_idx);
+        break;
+    }
+}
+
+// Evaluate the priority expression for all new and changed URLs in one query
+void CrawlFrontier::ScoreDirty() {
+    if (dirty_.empty()) {
+        return;
+    }
+    vector<Value> depths, priorities, ages, inlinks, urls, slot_ids;
+    for (auto slot_idx : dirty_) {
+        auto &url = slots_[slot_idx].url;
+        depths.push_back(Value::INTEGER(url.depth));
+        priorities.push_back(url.sitemap_priority.IsNull() ? Value(LogicalType::DOUBLE)
+                                                           : url.sitemap_priority.DefaultCastAs(LogicalType::DOUBLE));
+        ages.push_back(url.lastmod_age_days.IsNull() ? Value(LogicalType::DOUBLE) : url.lastmod_age_days);
+        inlinks.push_back(Value::BIGINT(url.inlinks));
+        urls.push_back(Value(url.url));
+        slot_ids.push_back(Value::BIGINT(static_cast<int64_t>(slot_idx)));
+    }
+
+    auto result = conn_->Query(ScoreQuery(expression_), Value::LIST(LogicalType::INTEGER, std::move(depths)),
+                               Value::LIST(LogicalType::DOUBLE, std::move(priorities)),
+                               Value::LIST(LogicalType::DOUBLE, std::move(ages)),
+                               Value::LIST(LogicalType::BIGINT, std::move(inlinks)),
+                               Value::LIST(LogicalType::VARCHAR, std::move(urls)),
+                               Value::LIST(LogicalType::BIGINT, std::move(slot_ids)));
+    if (result->HasError()) {
+        throw IOException("crawl(): priority expression failed: %s", result->GetError());
+    }
+    while (auto chunk = result->Fetch()) {
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            auto slot_idx = static_cast<idx_t>(chunk->GetValue(0, row).GetValue<int64_t>());
+            auto score = chunk->GetValue(1, row);
+            // NULL scores go last
+            Schedule(slot_idx, score.IsNull() ? -std::numeric_limits<double>::infinity() : score.GetValue<double>());
+            slots_[slot_idx].dirty = false;
+        }
+    }
+    dirty_.clear();
+}
+
+bool CrawlFrontier::IsLive(const HeapItem &item) const {
+    return slots_[item.slot].version == item.version;
+}
+
+bool CrawlFrontier::Pop(FrontierUrl &url) {
+    ScoreDirty();
+
+    if (heap_.size() >= HEAP_COMPACT_MIN_SIZE && heap_.size() > 2 * index_.size()) {
+        heap_.erase(std::remove_if(heap_.begin(), heap_.end(), [&](const HeapItem &item) { return !IsLive(item); }),
+                    heap_.end());
+        std::make_heap(heap_.begin(), heap_.end());
+    }
+
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end());
+        auto item = heap_.back();
+        heap_.pop_back();
+        if (!IsLive(item)) {
+            continue;
+        }
+        auto &slot = slots_[item.slot];
+        index_.erase(slot.url.url);
+        url = std::move(slot.url);
+        slot.url = FrontierUrl();
+        slot.version++;
+        free_slots_.push_back(item.slot);
+        return true;
+    }
+    return false;
+}
+
+void CrawlFrontier::Drain(vector<FrontierUrl> &out) {
+    FrontierUrl url;
+    while (Pop(url)) {
+        out.push_back(std::move(url));
+    }
+}
+
+vector<string> CrawlFrontier::TakePrefetchWindow(idx_t n) {
+    ScoreDirty();
+
+    vector<HeapItem> candidates;
+    for (auto &item : heap_) {
+        if (IsLive(item) && !slots_[item.slot].url.cache_prefetched) {
+            candidates.push_back(item);
+        }
+    }
+    idx_t take = MinValue<idx_t>(n, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + take, candidates.end(),
+                      [](const HeapItem &a, const HeapItem &b) { return b < a; });
+
+    vector<string> window;
+    for (idx_t i = 0; i < take; i++) {
+        auto &url = slots_[candidates[i].slot].url;
+        url.cache_prefetched = true;
+        window.push_back(url.url);
+    }
+    return window;
+}
+
+//===--------------------------------------------------------------------===//
+// Frontier Persistence
+//===--------------------------------------------------------------------===//
+
+void EnsureFrontierTable(Connection &conn) {
+    conn.Query("CREATE TABLE IF NOT EXISTS " + string(FRONTIER_TABLE_NAME) + " ("
+               "crawl_id VARCHAR, "
+               "url VARCHAR, "
+               "depth INTEGER, "
+               "sitemap_priority DOUBLE, "
+               "lastmod_age_days DOUBLE, "
+               "inlinks BIGINT, "
+               "position BIGINT, "      // Frontier order at save time
+               "saved_at TIMESTAMP DEFAULT current_timestamp, "
+               "PRIMARY KEY (crawl_id, url))");
+}
+
+void SaveFrontier(Connection &conn, const string &crawl_id, const vector<FrontierUrl> &urls) {
+    if (urls.empty()) {
+        return;
+    }
+    EnsureFrontierTable(conn);
+
+    // One row per URL: a statement may not replace the same key twice
+    std::unordered_set<string> seen;
+    vector<Value> url_values, depths, priorities, ages, inlinks, positions;
+    for (auto &url : urls) {
+        if (!seen.insert(url.url).second) {
+            continue;
+        }
+        url_values.push_back(Value(url.url));
+        depths.push_back(Value::INTEGER(url.depth));
+        priorities.push_back(url.sitemap_priority.IsNull() ? Value(LogicalType::DOUBLE)
+                                                           : url.sitemap_priority.DefaultCastAs(LogicalType::DOUBLE));
+        ages.push_back(url.lastmod_age_days.IsNull() ? Value(LogicalType::DOUBLE) : url.lastmod_age_days);
+        inlinks.push_back(Value::BIGINT(url.inlinks));
+        positions.push_back(Value::BIGINT(static_cast<int64_t>(positions.size())));
+    }
+    auto result = conn.Query("INSERT OR REPLACE INTO " + string(FRONTIER_TABLE_NAME) +
+                                 " (crawl_id, url, depth, sitemap_priority, lastmod_age_days, inlinks, position, saved_at) "
+                                 "SELECT $1, unnest($2::VARCHAR[]), unnest($3::INTEGER[]), unnest($4::DOUBLE[]), "
+                                 "unnest($5::DOUBLE[]), unnest($6::BIGINT[]), unnest($7::BIGINT[]), current_timestamp",
+                             crawl_id, Value::LIST(LogicalType::VARCHAR, std::move(url_values)),
+                             Value::LIST(LogicalType::INTEGER, std::move(depths)),
+                             Value::LIST(LogicalType::DOUBLE, std::move(priorities)),
+                             Value::LIST(LogicalType::DOUBLE, std::move(ages)),
+                             Value::LIST(LogicalType::BIGINT, std::move(inlinks)),
+                             Value::LIST(LogicalType::BIGINT, std::move(positions)));
+    if (result->HasError()) {
+        throw IOException("Failed to save the crawl frontier: %s", result->GetError());
+    }
+}
+
+vector<FrontierUrl> LoadSavedFrontier(Connection &conn, const string &crawl_id) {
+    vector<FrontierUrl> urls;
+    EnsureFrontierTable(conn);
+
+    // lastmod ages were relative to the save; age them by the time since
+    auto result = conn.Query("SELECT url, depth, sitemap_priority, "
+                             "lastmod_age_days + date_diff('second', saved_at, current_timestamp::TIMESTAMP) / 86400.0, "
+                             "inlinks FROM " + string(FRONTIER_TABLE_NAME) + " WHERE crawl_id = $1 ORDER BY saved_at, position",
+                             crawl_id);
+    if (result->HasError()) {
+        return urls;
+    }
+    while (auto chunk = result->Fetch()) {
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            FrontierUrl url;
+            url.url = StringValue::Get(chunk->GetValue(0, row));
+            url.depth = chunk->GetValue(1, row).IsNull() ? 1 : chunk->GetValue(1, row).GetValue<int32_t>();
+            url.sitemap_priority = chunk->GetValue(2, row);
+            url.lastmod_age_days = chunk->GetValue(3, row);
+            url.inlinks = chunk->GetValue(4, row).IsNull() ? 0 : chunk->GetValue(4, row).GetValue<int64_t>();
+            urls.push_back(std::move(url));
+        }
+    }
+    return urls;
+}
+
+void ForgetSavedFrontierUrl(Connection &conn, const string &crawl_id, const string &url) {
+    conn.Query("DELETE FROM " + string(FRONTIER_TABLE_NAME) + " WHERE crawl_id = $1 AND url = $2", crawl_id, url);
+}
+
+} // namespace duckdb
@@ -24,6 +24,13 @@
 #include "crawl_table_function.hpp"
 #include "crawler_utils.hpp"
 #include "rust_ffi.hpp"
+#include "response_cache.hpp"
+#include "body_versions.hpp"
+#include "recrawl_scheduler.hpp"
+#include "proxy_pool.hpp"
+#include "extraction_plan.hpp"
+#include "facet_cache.hpp"
+#include "content_fingerprint.hpp"
 #include "yyjson.hpp"
 #include "pipeline_state.hpp"
 
@@ -34,6 +41,9 @@
 #include "duckdb/common/types/data_chunk.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <unordered_map>
 
@@ -43,36 +53,35 @@ namespace duckdb {
 // Shared Pipeline State - enables LIMIT pushdown across LATERAL calls
 //===--------------------------------------------------------------------===//
 
-// Global registry of pipeline states, keyed by database instance pointer
-static std::mutex g_pipeline_mutex;
-static std::unordered_map<uintptr_t, std::shared_ptr<PipelineState>> g_pipeline_states;
+// Pipeline states live in the registered state of the client context running the
+// pipeline, so lookups never contend on a global lock
+static constexpr const char *PIPELINE_STATE_KEY = "crawler_pipeline_state";
 
-// Initialize pipeline limit for a database instance (call before running query)
-void InitPipelineLimit(DatabaseInstance &db, int64_t limit) {
-    uintptr_t key = reinterpret_cast<uintptr_t>(&db);
-    std::lock_guard<std::mutex> lock(g_pipeline_mutex);
-
-    auto state = std::make_shared<PipelineState>(limit);
-    g_pipeline_states[key] = state;
+// Attach a pipeline limit to a client context (call on the connection that runs the query)
+shared_ptr<PipelineState> InitPipelineLimit(ClientContext &context, int64_t limit) {
+    auto state = make_shared_ptr<PipelineState>(limit);
+    context.registered_state->Insert(PIPELINE_STATE_KEY, state);
+    return state;
 }
 
-// Get existing pipeline state for a database instance
-std::shared_ptr<PipelineState> GetPipelineState(DatabaseInstance &db) {
-    uintptr_t key = reinterpret_cast<uintptr_t>(&db);
-    std::lock_guard<std::mutex> lock(g_pipeline_mutex);
-
-    auto it = g_pipeline_states.find(key);
-    if (it != g_pipeline_states.end()) {
-        return it->second;
+// Attach a statement-wide crawl budget to a client context
+shared_ptr<PipelineState> InitPipelineBudget(ClientContext &context, const CrawlBudget &budget) {
+    auto state = GetPipelineState(context);
+    if (!state) {
+        state = InitPipelineLimit(context, NumericLimits<int64_t>::Maximum());
     }
-    return nullptr;
+    state->budget = std::make_shared<CrawlBudgetTracker>(budget);
+    return state;
+}
+
+// Get the pipeline state attached to a client context
+shared_ptr<PipelineState> GetPipelineState(ClientContext &context) {
+    return context.registered_state->Get<PipelineState>(PIPELINE_STATE_KEY);
 }
 
-// Clear pipeline state for a database instance
-void ClearPipelineState(DatabaseInstance &db) {
-    uintptr_t key = reinterpret_cast<uintptr_t>(&db);
-    std::lock_guard<std::mutex> lock(g_pipeline_mutex);
-    g_pipeline_states.erase(key);
+// Detach the pipeline state from a client context
+void ClearPipelineState(ClientContext &context) {
+    context.registered_state->Remove(PIPELINE_STATE_KEY);
 }
 
 using namespace duckdb_yyjson;
@@ -89,133 +98,154 @@ struct SingleCrawlResult {
     string error;
     string extracted_json;
     int64_t response_time_ms = 0;
+    string content_encoding;  // Coding of body_compressed (crawler_store_compressed only)
+    string body_compressed;   // Body exactly as received (crawler_store_compressed only)
+    int64_t content_length = -1;  // Resource size, -1 if unknown (probe only)
+    int64_t transfer_size = -1;   // Body bytes read off the connection, -1 if not fetched
+    string etag;                  // Validators (probe only)
+    string last_modified;
+    PlanResult plan;              // Facets computed in the fetch task
+
+    // Bytes that went over the wire
+    idx_t TransferSize() const {
+        if (transfer_size >= 0) {
+            return static_cast<idx_t>(transfer_size);
+        }
+        return body_compressed.empty() ? body.size() : body_compressed.size();
+    }
 };
 
 //===--------------------------------------------------------------------===//
-// HTTP Cache Table Management (__crawler_cache)
+// HTTP Cache (__crawler_cache behind the in-memory ResponseCache)
 //===--------------------------------------------------------------------===//
 
-static constexpr const char* CACHE_TABLE_NAME = "__crawler_cache";
-
-static void EnsureCacheTable(Connection &conn) {
-    string sql = "CREATE TABLE IF NOT EXISTS " + string(CACHE_TABLE_NAME) + " ("
-                 "url VARCHAR PRIMARY KEY, "
-                 "status_code INTEGER, "
-                 "content_type VARCHAR, "
-                 "body VARCHAR, "
-                 "error VARCHAR, "
-                 "response_time_ms BIGINT, "
-                 "cached_at TIMESTAMP DEFAULT current_timestamp)";
-    conn.Query(sql);
-}
-
-static unique_ptr<SingleCrawlResult> GetCachedEntry(Connection &conn, const string &url, int ttl_hours) {
-    EnsureCacheTable(conn);
-    auto result = conn.Query(
-        "SELECT url, status_code, content_type, body, error, response_time_ms "
-        "FROM " + string(CACHE_TABLE_NAME) + " "
-        "WHERE url = $1 AND cached_at > current_timestamp - INTERVAL '" + std::to_string(ttl_hours) + " hours'",
-        url);
-
-    if (!result->HasError()) {
-        auto chunk = result->Fetch();
-        if (chunk && chunk->size() > 0) {
-            auto entry = make_uniq<SingleCrawlResult>();
-            entry->url = chunk->GetValue(0, 0).ToString();
-            entry->status_code = chunk->GetValue(1, 0).GetValue<int>();
-            entry->content_type = chunk->GetValue(2, 0).IsNull() ? "" : chunk->GetValue(2, 0).ToString();
-            entry->body = chunk->GetValue(3, 0).IsNull() ? "" : chunk->GetValue(3, 0).ToString();
-            entry->error = chunk->GetValue(4, 0).IsNull() ? "" : chunk->GetValue(4, 0).ToString();
-            entry->response_time_ms = chunk->GetValue(5, 0).IsNull() ? 0 : chunk->GetValue(5, 0).GetValue<int64_t>();
-            return entry;
-        }
-    }
-    return nullptr;
+static unique_ptr<SingleCrawlResult> GetCachedEntry(ClientContext &context, const string &url, int ttl_hours) {
+    auto cached = ResponseCache::Get(context)->Lookup(*context.db, {url}, ttl_hours);
+    if (cached.empty()) {
+        return nullptr;
+    }
+    auto entry = make_uniq<SingleCrawlResult>();
+    entry->url = std::move(cached[0].url);
+    entry->status_code = cached[0].status_code;
+    entry->content_type = std::move(cached[0].content_type);
+    entry->body = std::move(cached[0].body);
+    entry->error = std::move(cached[0].error);
+    entry->response_time_ms = cached[0].response_time_ms;
+    return entry;
 }
 
-static void SaveToCache(Connection &conn, const SingleCrawlResult &result) {
-    EnsureCacheTable(conn);
-    string sql = "INSERT OR REPLACE INTO " + string(CACHE_TABLE_NAME) +
-                 " (url, status_code, content_type, body, error, response_time_ms, cached_at) "
-                 "VALUES ($1, $2, $3, $4, $5, $6, current_timestamp)";
-    conn.Query(sql, result.url, result.status_code,
-               result.content_type.empty() ? Value() : Value(result.content_type),
-               result.body.empty() ? Value() : Value(result.body),
-               result.error.empty() ? Value() : Value(result.error),
-               result.response_time_ms);
+static void SaveToCache(ClientContext &context, const SingleCrawlResult &result) {
+    CachedResponse cached;
+    cached.url = result.url;
+    cached.status_code = result.status_code;
+    cached.content_type = result.content_type;
+    cached.body = result.body;
+    cached.error = result.error;
+    cached.response_time_ms = result.response_time_ms;
+    cached.content_encoding = result.content_encoding;
+    cached.body_compressed = result.body_compressed;
+    ResponseCache::Get(context)->Save(*context.db, cached, CacheAutoVacuum::FromSettings(context));
 }
 
 //===--------------------------------------------------------------------===//
-// Helper: Combine JSON-LD and Microdata into schema object
+// Single-flight: coalesce concurrent fetches of the same URL
 //===--------------------------------------------------------------------===//
 
-static string CombineSchemaData(const string &jsonld, const string &microdata) {
-    // Combine JSON-LD and microdata into a single schema object
-    // Both are JSON objects keyed by @type, with array values
-    yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
-    if (!doc) return "{}";
+// Process-wide, so it spans queries and connections. Concurrent callers with the same
+// flight key wait for one in-flight fetch (cache lookup + fetch + cache save) and share
+// its response. Nothing is kept once the leader finishes: later callers go through the
+// response cache like any other fetch.
+struct InFlightFetch {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    bool abandoned = false;  // Leader was cancelled or failed; waiters must fetch themselves
+    SingleCrawlResult result;
+};
 
-    yyjson_mut_val *root = yyjson_mut_obj(doc);
-    yyjson_mut_doc_set_root(doc, root);
+static std::mutex g_flight_mutex;
+static std::unordered_map<string, std::shared_ptr<InFlightFetch>> g_flights;
 
-    // Parse and merge JSON-LD (values are arrays)
-    if (!jsonld.empty() && jsonld != "{}") {
-        yyjson_doc *jld_doc = yyjson_read(jsonld.c_str(), jsonld.size(), 0);
-        if (jld_doc) {
-            yyjson_val *jld_root = yyjson_doc_get_root(jld_doc);
-            if (yyjson_is_obj(jld_root)) {
-                size_t idx, max;
-                yyjson_val *key, *val;
-                yyjson_obj_foreach(jld_root, idx, max, key, val) {
-                    yyjson_mut_val *key_copy = yyjson_val_mut_copy(doc, key);
-                    yyjson_mut_val *val_copy = yyjson_val_mut_copy(doc, val);
-                    yyjson_mut_obj_add(root, key_copy, val_copy);
-                }
-            }
-            yyjson_doc_free(jld_doc);
-        }
-    }
-
-    // Parse and merge microdata (values are arrays, merge with existing)
-    if (!microdata.empty() && microdata != "{}") {
-        yyjson_doc *md_doc = yyjson_read(microdata.c_str(), microdata.size(), 0);
-        if (md_doc) {
-            yyjson_val *md_root = yyjson_doc_get_root(md_doc);
-            if (yyjson_is_obj(md_root)) {
-                size_t idx, max;
-                yyjson_val *key, *val;
-                yyjson_obj_foreach(md_root, idx, max, key, val) {
-                    const char *key_str = yyjson_get_str(key);
-                    yyjson_mut_val *existing = yyjson_mut_obj_get(root, key_str);
-
-                    if (existing && yyjson_mut_is_arr(existing) && yyjson_is_arr(val)) {
-                        // Append microdata items to existing JSON-LD array
-                        size_t arr_idx, arr_max;
-                        yyjson_val *item;
-                        yyjson_arr_foreach(val, arr_idx, arr_max, item) {
-                            yyjson_mut_val *item_copy = yyjson_val_mut_copy(doc, item);
-                            yyjson_mut_arr_append(existing, item_copy);
-                        }
-                    } else if (!existing) {
-                        // Add new type from microdata
-                        yyjson_mut_val *key_copy = yyjson_val_mut_copy(doc, key);
-                        yyjson_mut_val *val_copy = yyjson_val_mut_copy(doc, val);
-                        yyjson_mut_obj_add(root, key_copy, val_copy);
-                    }
-                }
+// Ends the leader's flight: unregisters the key and wakes the waiters. A flight that is
+// not completed (the fetch threw) is ended as abandoned, so the waiters retry.
+class FlightLeaderGuard {
+public:
+    FlightLeaderGuard(string key, std::shared_ptr<InFlightFetch> flight)
+        : key_(std::move(key)), flight_(std::move(flight)) {
+    }
+    ~FlightLeaderGuard() {
+        {
+            std::lock_guard<std::mutex> lock(g_flight_mutex);
+            g_flights.erase(key_);
+        }
+        {
+            std::lock_guard<std::mutex> lock(flight_->mutex);
+            flight_->done = true;
+            flight_->abandoned = !completed_;
+            if (completed_) {
+                flight_->result = std::move(result_);
             }
-            yyjson_doc_free(md_doc);
         }
+        flight_->cv.notify_all();
     }
+    FlightLeaderGuard(const FlightLeaderGuard &) = delete;
+    FlightLeaderGuard &operator=(const FlightLeaderGuard &) = delete;
 
-    size_t len = 0;
-    char *json_str = yyjson_mut_write(doc, 0, &len);
-    yyjson_mut_doc_free(doc);
+    // Share `result` with the waiters
+    void Complete(const SingleCrawlResult &result) {
+        result_ = result;
+        completed_ = true;
+    }
 
-    if (!json_str) return "{}";
-    string result(json_str, len);
-    free(json_str);
-    return result;
+private:
+    string key_;
+    std::shared_ptr<InFlightFetch> flight_;
+    SingleCrawlResult result_;
+    bool completed_ = false;
+};
+
+// Run `fetch` as the leader of the flight `key`, or wait for the current leader and take
+// its result. Returns false, without a result, if `cancel_token` fires while waiting.
+static bool FetchCoalesced(const string &key, const CrawlCancelToken &cancel_token,
+                           const std::function<SingleCrawlResult()> &fetch, SingleCrawlResult &result) {
+    while (true) {
+        std::shared_ptr<InFlightFetch> flight;
+        bool leader = false;
+        {
+            std::lock_guard<std::mutex> lock(g_flight_mutex);
+            auto it = g_flights.find(key);
+            if (it != g_flights.end()) {
+                flight = it->second;
+            } else {
+                flight = std::make_shared<InFlightFetch>();
+                g_flights.emplace(key, flight);
+                leader = true;
+            }
+        }
+
+        if (leader) {
+            FlightLeaderGuard guard(key, flight);
+            result = fetch();
+            if (!cancel_token.IsCancelled()) {
+                guard.Complete(result);
+            }
+            return true;
+        }
+
+        // Follower: wait for the leader, but stay responsive to our own cancellation
+        std::unique_lock<std::mutex> lock(flight->mutex);
+        while (!flight->done && !cancel_token.IsCancelled()) {
+            flight->cv.wait_for(lock, std::chrono::milliseconds(50));
+        }
+        if (!flight->done) {
+            return false;
+        }
+        if (!flight->abandoned) {
+            result = flight->result;
+            return true;
+        }
+        // Leader was cancelled or threw before it finished: retry, possibly as the new leader
+    }
 }
 
 //===--------------------------------------------------------------------===//
@@ -280,35 +310,18 @@ static Value MakeSchemaMapValue(const string &schema_json) {
     return Value::MAP(LogicalType::VARCHAR, LogicalType::JSON(), keys, values);
 }
 
-static Value BuildHtmlStructValue(const string &body, const string &content_type, const string &url = "") {
+// Facets come from the fetch task or ResolvePageFacets(); pages without them (non-HTML,
+// duplicates) get NULL facets
+static Value BuildHtmlStructValue(const string &body, const PlanResult *facets = nullptr) {
     child_list_t<Value> html_values;
+    html_values.push_back(make_pair("document", body.empty() ? Value() : Value(body)));
 
-    bool is_html = content_type.find("text/html") != string::npos ||
-                   content_type.find("application/xhtml") != string::npos;
-
-    if (is_html && !body.empty()) {
-#if defined(RUST_PARSER_AVAILABLE) && RUST_PARSER_AVAILABLE
-        string js_json = ExtractJsWithRust(body);
-        string og_json = ExtractOpenGraphWithRust(body);
-        string jsonld_json = ExtractJsonLdWithRust(body);
-        string microdata_json = ExtractMicrodataWithRust(body);
-        string schema_json = CombineSchemaData(jsonld_json, microdata_json);
-        string readability_json = ExtractReadabilityWithRust(body, url);
-
-        html_values.push_back(make_pair("document", Value(body)));
-        html_values.push_back(make_pair("js", MakeJsonValue(js_json)));
-        html_values.push_back(make_pair("opengraph", MakeJsonValue(og_json)));
-        html_values.push_back(make_pair("schema", MakeSchemaMapValue(schema_json)));
-        html_values.push_back(make_pair("readability", MakeJsonValue(readability_json)));
-#else
-        html_values.push_back(make_pair("document", Value(body)));
-        html_values.push_back(make_pair("js", Value(LogicalType::JSON())));
-        html_values.push_back(make_pair("opengraph", Value(LogicalType::JSON())));
-        html_values.push_back(make_pair("schema", Value::MAP(LogicalType::VARCHAR, LogicalType::JSON(), vector<Value>(), vector<Value>())));
-        html_values.push_back(make_pair("readability", Value(LogicalType::JSON())));
-#endif
+    if (facets && facets->has_facets) {
+        html_values.push_back(make_pair("js", MakeJsonValue(facets->js_json)));
+        html_values.push_back(make_pair("opengraph", MakeJsonValue(facets->opengraph_json)));
+        html_values.push_back(make_pair("schema", MakeSchemaMapValue(facets->schema_json)));
+        html_values.push_back(make_pair("readability", MakeJsonValue(facets->readability_json)));
     } else {
-        html_values.push_back(make_pair("document", body.empty() ? Value() : Value(body)));
         html_values.push_back(make_pair("js", Value(LogicalType::JSON())));
         html_values.push_back(make_pair("opengraph", Value(LogicalType::JSON())));
         html_values.push_back(make_pair("schema", Value::MAP(LogicalType::VARCHAR, LogicalType::JSON(), vector<Value>(), vector<Value>())));
@@ -328,9 +341,18 @@ struct CrawlUrlBindData : public TableFunctionData {
     bool use_cache = true;      // Enable HTTP response caching
     int cache_ttl_hours = 24;   // Cache TTL in hours
     int64_t max_results = -1;   // Max results to return (-1 = unlimited)
+    CrawlBudget budget;         // Session budget settings (a CRAWLING MERGE budget takes precedence)
+    CompressedStorage store_compressed = CompressedStorage::OFF;  // Raw bodies kept in __crawler_cache
+    bool probe = false;         // Headers only (method := 'HEAD'): no body, cache or extraction
+    bool head_only = false;     // Fetch HTML only up to </head>; truncated bodies are not cached
+    string extract_specs;       // extract := [...] as a JSON array of specs (empty = none)
+    ExtractionBudget extract_budget;  // crawler_extract_* limits per document
+    string http_proxy;          // A comma-separated list here is a proxy pool
+    string http_proxy_username;
+    string http_proxy_password;
 
     // Shared pipeline state for LIMIT pushdown across LATERAL calls
-    std::shared_ptr<PipelineState> pipeline_state;
+    shared_ptr<PipelineState> pipeline_state;
 
     CrawlUrlBindData() = default;
 };
@@ -344,6 +366,9 @@ struct CrawlUrlLocalState : public LocalTableFunctionState {
     idx_t input_size = 0;       // Size of current input chunk
     bool chunk_initialized = false;
     int64_t results_returned = 0;  // Total results returned (for max_results)
+    // crawler_track_changes writes (opened on first use). Per thread: the in-out operator
+    // runs on every pipeline thread, whatever MaxThreads() says
+    unique_ptr<Connection> change_conn;
 
     CrawlUrlLocalState() = default;
 
@@ -360,6 +385,10 @@ struct CrawlUrlLocalState : public LocalTableFunctionState {
 //===--------------------------------------------------------------------===//
 
 struct CrawlUrlGlobalState : public GlobalTableFunctionState {
+    // Cancelled when this query is interrupted or the shared pipeline stops
+    unique_ptr<CrawlCancelToken> cancel_token;
+    std::shared_ptr<CrawlBudgetTracker> budget;  // nullptr = unlimited
+
     idx_t MaxThreads() const override { return 1; }
 };
 
@@ -370,7 +399,12 @@ struct CrawlUrlGlobalState : public GlobalTableFunctionState {
 static SingleCrawlResult CrawlSingleUrl(const string &url,
                                          const string &extraction_json,
                                          const string &user_agent,
-                                         int timeout_ms) {
+                                         int timeout_ms,
+                                         CompressedStorage store_compressed,
+                                         bool probe,
+                                         bool head_only,
+                                         const ProxyEndpoint *proxy,
+                                         const CrawlCancelToken &cancel_token) {
     SingleCrawlResult result;
     result.url = url;
 
@@ -405,6 +439,24 @@ static SingleCrawlResult CrawlSingleUrl(const string &url,
     yyjson_mut_obj_add_uint(doc, root, "timeout_ms", timeout_ms);
     yyjson_mut_obj_add_uint(doc, root, "concurrency", 1);
     yyjson_mut_obj_add_uint(doc, root, "delay_ms", 0);
+    if (store_compressed != CompressedStorage::OFF) {
+        yyjson_mut_obj_add_str(doc, root, "store_compressed", CompressedStorageName(store_compressed));
+    }
+    if (probe) {
+        yyjson_mut_obj_add_bool(doc, root, "probe", true);
+    }
+    if (head_only) {
+        yyjson_mut_obj_add_bool(doc, root, "head_only", true);
+    }
+    if (proxy) {
+        yyjson_mut_obj_add_strcpy(doc, root, "http_proxy", proxy->url.c_str());
+        if (!proxy->username.empty()) {
+            yyjson_mut_obj_add_strcpy(doc, root, "http_proxy_username", proxy->username.c_str());
+        }
+        if (!proxy->password.empty()) {
+            yyjson_mut_obj_add_strcpy(doc, root, "http_proxy_password", proxy->password.c_str());
+        }
+    }
 
     size_t len = 0;
     char *json_str = yyjson_mut_write(doc, 0, &len);
@@ -419,7 +471,7 @@ static SingleCrawlResult CrawlSingleUrl(const string &url,
     free(json_str);
 
     // Call Rust
-    string response_json = CrawlBatchWithRust(request_json);
+    string response_json = CrawlBatchWithRust(request_json, cancel_token);
 
     // Parse response
     yyjson_doc *resp_doc = yyjson_read(response_json.c_str(), response_json.size(), 0);
@@ -468,6 +520,32 @@ static SingleCrawlResult CrawlSingleUrl(const string &url,
             result.response_time_ms = (int64_t)yyjson_get_uint(time_val);
         }
 
+        yyjson_val *length_val = yyjson_obj_get(item, "content_length");
+        if (length_val && yyjson_is_uint(length_val)) {
+            result.content_length = (int64_t)yyjson_get_uint(length_val);
+        }
+        yyjson_val *transfer_val = yyjson_obj_get(item, "transfer_size");
+        if (transfer_val && yyjson_is_uint(transfer_val)) {
+            result.transfer_size = (int64_t)yyjson_get_uint(transfer_val);
+        }
+        yyjson_val *etag_val = yyjson_obj_get(item, "etag");
+        if (etag_val && yyjson_is_str(etag_val)) {
+            result.etag = yyjson_get_str(etag_val);
+        }
+        yyjson_val *last_modified_val = yyjson_obj_get(item, "last_modified");
+        if (last_modified_val && yyjson_is_str(last_modified_val)) {
+            result.last_modified = yyjson_get_str(last_modified_val);
+        }
+
+        yyjson_val *compressed_val = yyjson_obj_get(item, "compressed_body");
+        if (compressed_val && yyjson_is_str(compressed_val)) {
+            result.body_compressed = DecodeBase64Body(yyjson_get_str(compressed_val));
+            yyjson_val *encoding_val = yyjson_obj_get(item, "content_encoding");
+            if (encoding_val && yyjson_is_str(encoding_val)) {
+                result.content_encoding = yyjson_get_str(encoding_val);
+            }
+        }
+
         yyjson_val *extracted = yyjson_obj_get(item, "extracted");
         if (extracted && !yyjson_is_null(extracted)) {
             size_t ext_len = 0;
@@ -477,6 +555,7 @@ static SingleCrawlResult CrawlSingleUrl(const string &url,
                 free(ext_str);
             }
         }
+        result.plan.Read(item);
     }
 
     yyjson_doc_free(resp_doc);
@@ -499,6 +578,17 @@ static unique_ptr<FunctionData> CrawlUrlBind(ClientContext &context, TableFuncti
     if (context.TryGetCurrentSetting("crawler_timeout_ms", setting_value)) {
         bind_data->timeout_ms = static_cast<int>(setting_value.GetValue<int64_t>());
     }
+    bind_data->store_compressed = GetCompressedStorage(context);
+    bind_data->extract_budget = ExtractionBudget::FromSettings(context);
+    if (context.TryGetCurrentSetting("http_proxy", setting_value) && !setting_value.IsNull()) {
+        bind_data->http_proxy = setting_value.ToString();
+    }
+    if (context.TryGetCurrentSetting("http_proxy_username", setting_value) && !setting_value.IsNull()) {
+        bind_data->http_proxy_username = setting_value.ToString();
+    }
+    if (context.TryGetCurrentSetting("http_proxy_password", setting_value) && !setting_value.IsNull()) {
+        bind_data->http_proxy_password = setting_value.ToString();
+    }
 
     // Check for optional second positional argument (max_results)
     // This enables LIMIT pushdown in LATERAL joins where named params don't work
@@ -518,8 +608,29 @@ static unique_ptr<FunctionData> CrawlUrlBind(ClientContext &context, TableFuncti
             bind_data->cache_ttl_hours = kv.second.GetValue<int>();
         } else if (kv.first == "max_results") {
             bind_data->max_results = kv.second.GetValue<int64_t>();
+        } else if (kv.first == "method") {
+            auto method = StringUtil::Upper(StringValue::Get(kv.second));
+            if (method != "GET" && method != "HEAD") {
+                throw BinderException("crawl_url(): method must be 'GET' or 'HEAD'");
+            }
+            bind_data->probe = method == "HEAD";
+        } else if (kv.first == "probe") {
+            bind_data->probe = kv.second.GetValue<bool>();
+        } else if (kv.first == "head_only") {
+            bind_data->head_only = kv.second.GetValue<bool>();
+        } else if (kv.first == "extract" && !kv.second.IsNull()) {
+            vector<string> entries;
+            for (auto &entry : ListValue::GetChildren(kv.second)) {
+                if (!entry.IsNull()) {
+                    entries.push_back(StringValue::Get(entry));
+                }
+            }
+            bind_data->extract_specs = ParseExtractSpecs(entries, "crawl_url");
         }
     }
+    if (bind_data->head_only && bind_data->probe) {
+        throw BinderException("crawl_url(): head_only cannot be combined with a HEAD probe");
+    }
 
     // Return columns
     return_types.push_back(LogicalType::VARCHAR);  // url
@@ -547,13 +658,23 @@ static unique_ptr<FunctionData> CrawlUrlBind(ClientContext &context, TableFuncti
     names.push_back("extract");
     names.push_back("response_time_ms");
 
+    // Probe mode: headers instead of the document
+    if (bind_data->probe) {
+        return_types = {LogicalType::VARCHAR, LogicalType::INTEGER, LogicalType::VARCHAR, LogicalType::BIGINT,
+                        LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BIGINT};
+        names = {"url", "status", "content_type", "content_length", "etag", "last_modified", "error",
+                 "response_time_ms"};
+    }
+
+    // Named params don't reach LATERAL calls, so budgets come from settings or the pipeline
+    bind_data->budget = CrawlBudget::FromSettings(context);
+
     // Look up shared pipeline state for LIMIT pushdown across LATERAL calls
-    // The state is created by stream_into_function BEFORE running the query
-    bind_data->pipeline_state = GetPipelineState(*context.db);
+    // The state is attached to this connection by STREAM INTO/MERGE BEFORE running the query
+    bind_data->pipeline_state = GetPipelineState(context);
     if (!bind_data->pipeline_state && bind_data->max_results > 0) {
-        // Fallback: create state if max_results is set directly (non-LATERAL case)
-        InitPipelineLimit(*context.db, bind_data->max_results);
-        bind_data->pipeline_state = GetPipelineState(*context.db);
+        // Fallback: private state if max_results is set directly (non-LATERAL case)
+        bind_data->pipeline_state = make_shared_ptr<PipelineState>(bind_data->max_results);
     }
 
     return std::move(bind_data);
@@ -565,7 +686,12 @@ static unique_ptr<FunctionData> CrawlUrlBind(ClientContext &context, TableFuncti
 
 static unique_ptr<GlobalTableFunctionState> CrawlUrlInitGlobal(ClientContext &context,
                                                                  TableFunctionInitInput &input) {
-    return make_uniq<CrawlUrlGlobalState>();
+    auto &bind_data = input.bind_data->Cast<CrawlUrlBindData>();
+    auto state = make_uniq<CrawlUrlGlobalState>();
+    state->cancel_token = make_uniq<CrawlCancelToken>(
+        &context.interrupted, bind_data.pipeline_state ? &bind_data.pipeline_state->stopped : nullptr);
+    state->budget = ResolveBudgetTracker(context, bind_data.budget);
+    return std::move(state);
 }
 
 static unique_ptr<LocalTableFunctionState> CrawlUrlInitLocal(ExecutionContext &context,
@@ -582,6 +708,7 @@ static OperatorResultType CrawlUrlInOut(ExecutionContext &context, TableFunction
                                          DataChunk &input, DataChunk &output) {
     auto &bind_data = data.bind_data->CastNoConst<CrawlUrlBindData>();
     auto &local_state = data.local_state->Cast<CrawlUrlLocalState>();
+    auto &global_state = data.global_state->Cast<CrawlUrlGlobalState>();
 
     // Initialize chunk tracking on new input
     if (!local_state.chunk_initialized) {
@@ -598,8 +725,8 @@ static OperatorResultType CrawlUrlInOut(ExecutionContext &context, TableFunction
     // Process ONE URL at a time for LIMIT pushdown support
     // This allows executor to stop between HTTP requests when LIMIT is reached
     while (local_state.current_row < local_state.input_size) {
-        // Check shared pipeline state (LIMIT pushdown across LATERAL calls)
-        if (bind_data.pipeline_state && bind_data.pipeline_state->stopped.load()) {
+        // Check shared pipeline state (LIMIT pushdown across LATERAL calls) and query interrupt
+        if (global_state.cancel_token->IsCancelled()) {
             // Skip remaining rows - limit reached across all LATERAL calls
             local_state.current_row = local_state.input_size;
             output.SetCardinality(0);
@@ -607,6 +734,14 @@ static OperatorResultType CrawlUrlInOut(ExecutionContext &context, TableFunction
             return OperatorResultType::NEED_MORE_INPUT;
         }
 
+        // Budget spent: dispatch nothing new. The input rows stay with the caller's query,
+        // which is the frontier to re-run, so nothing is saved here.
+        if (global_state.budget && global_state.budget->Exhausted()) {
+            output.SetCardinality(0);
+            local_state.Reset();
+            return OperatorResultType::NEED_MORE_INPUT;
+        }
+
         // Check local max_results limit (fallback for non-shared mode)
         if (bind_data.max_results >= 0 && local_state.results_returned >= bind_data.max_results) {
             output.SetCardinality(0);
@@ -620,23 +755,22 @@ static OperatorResultType CrawlUrlInOut(ExecutionContext &context, TableFunction
 
         if (url_val.IsNull()) {
             // NULL input -> NULL output row with proper struct
-            output.SetValue(0, 0, Value());
-            output.SetValue(1, 0, Value());
-            output.SetValue(2, 0, Value());
-            output.SetValue(3, 0, BuildHtmlStructValue("", "", ""));
-            output.SetValue(4, 0, Value("NULL URL"));
-            output.SetValue(5, 0, Value());
-            output.SetValue(6, 0, Value());
+            for (idx_t col = 0; col < output.ColumnCount(); col++) {
+                output.SetValue(col, 0, Value());
+            }
+            if (bind_data.probe) {
+                output.SetValue(6, 0, Value("NULL URL"));
+            } else {
+                output.SetValue(3, 0, BuildHtmlStructValue(""));
+                output.SetValue(4, 0, Value("NULL URL"));
+            }
             output.SetCardinality(1);
             local_state.current_row++;
             local_state.results_returned++;
 
             // Decrement shared pipeline counter (for LIMIT pushdown across LATERAL)
             if (bind_data.pipeline_state) {
-                int64_t remaining = --bind_data.pipeline_state->remaining;
-                if (remaining <= 0) {
-                    bind_data.pipeline_state->stopped = true;
-                }
+                bind_data.pipeline_state->ConsumeRow();
             }
 
             // More rows in chunk? Return HAVE_MORE_OUTPUT to allow LIMIT to interrupt
@@ -655,39 +789,141 @@ static OperatorResultType CrawlUrlInOut(ExecutionContext &context, TableFunction
             continue;
         }
 
-        SingleCrawlResult result;
-        bool from_cache = false;
-
-        // Check cache first
-        if (bind_data.use_cache) {
-            Connection cache_conn(*context.client.db);
-            auto cached = GetCachedEntry(cache_conn, url, bind_data.cache_ttl_hours);
-            if (cached) {
-                result = std::move(*cached);
-                from_cache = true;
+        // Host out of requests: skip the URL
+        if (global_state.budget && !global_state.budget->TryAcquireHost(url)) {
+            local_state.current_row++;
+            continue;
+        }
+
+        // Cache lookup, fetch and cache save run as one coalesced flight per URL, so
+        // concurrent queries asking for the same page fetch it once. Callers only share a
+        // flight if they would have made the same request against the same cache.
+        string flight_key = NormalizeCrawlUrl(url) + "\n" + bind_data.user_agent + "\n" +
+                            std::to_string(reinterpret_cast<uintptr_t>(context.client.db.get()));
+        if (bind_data.probe) {
+            // Probes and head-only fetches return partial responses, so they fly separately
+            flight_key += "\nHEAD";
+        } else {
+            if (bind_data.head_only) {
+                flight_key += "\n<head>";
+            }
+            flight_key += bind_data.use_cache ? "\ncache:" + std::to_string(bind_data.cache_ttl_hours) : "\nno-cache";
+            flight_key += "\n" + std::to_string(static_cast<int>(bind_data.store_compressed));
+            flight_key += "\n" + bind_data.extract_budget.ToJson();
+            // Results carry the extract values of this query's specs
+            if (!bind_data.extract_specs.empty()) {
+                flight_key += "\n" + bind_data.extract_specs;
             }
         }
+        SingleCrawlResult result;
+        bool fetched_ok = FetchCoalesced(flight_key, *global_state.cancel_token, [&]() {
+            // Probes bypass the cache: it holds full responses
+            bool use_cache = bind_data.use_cache && !bind_data.probe;
+
+            // Check cache first
+            if (use_cache) {
+                auto cached = GetCachedEntry(context.client, url, bind_data.cache_ttl_hours);
+                if (cached) {
+                    cached->extracted_json = EvaluateExtractSpecs(cached->body, bind_data.extract_specs, bind_data.extract_budget);
+                    if (!cached->body.empty()) {
+                        auto content_hash = HashContent128(cached->body.data(), cached->body.size()).ToHex();
+                        ResolvePageFacets(context.client, cached->body, cached->content_type, content_hash, url, true,
+                                          cached->plan);
+                    }
+                    return std::move(*cached);
+                }
+            }
 
-        // Crawl if not in cache
-        if (!from_cache) {
-            result = CrawlSingleUrl(url, "{}",  // No extraction specs
-                                    bind_data.user_agent, bind_data.timeout_ms);
+            // Route through the proxy pool, if one is configured; a lease per request
+            // lets concurrent LATERAL calls spread over the pool. A single http_proxy is
+            // used as is.
+            unique_ptr<ProxyLease> proxy_lease;
+            ProxyEndpoint single_proxy;
+            const ProxyEndpoint *proxy = nullptr;
+            auto proxy_pool = ProxyPool::Resolve(context.client, bind_data.http_proxy, bind_data.http_proxy_username,
+                                                 bind_data.http_proxy_password);
+            if (proxy_pool) {
+                proxy_lease = proxy_pool->Acquire(url, global_state.cancel_token.get());
+                if (!proxy_lease) {
+                    // Empty pool or cancelled: never fall back to a direct fetch
+                    SingleCrawlResult failed;
+                    failed.url = url;
+                    failed.error = "No proxy available in the proxy pool";
+                    return failed;
+                }
+                proxy = &proxy_lease->Endpoint();
+            } else if (!bind_data.http_proxy.empty()) {
+                single_proxy.url = bind_data.http_proxy;
+                single_proxy.username = bind_data.http_proxy_username;
+                single_proxy.password = bind_data.http_proxy_password;
+                proxy = &single_proxy;
+            }
+
+            // Crawl if not in cache; the fetch task parses the page once for the specs
+            // and the html facets
+            ExtractionPlan plan;
+            if (!bind_data.probe) {
+                plan.specs_json = bind_data.extract_specs;
+                plan.facets = true;
+                plan.budget = bind_data.extract_budget;
+            }
+            auto fetched = CrawlSingleUrl(url, plan.ToJson(),
+                                          bind_data.user_agent, bind_data.timeout_ms,
+                                          use_cache && !bind_data.head_only ? bind_data.store_compressed
+                                                                            : CompressedStorage::OFF,
+                                          bind_data.probe, bind_data.head_only,
+                                          proxy, *global_state.cancel_token);
+            if (proxy_lease) {
+                proxy_lease->Complete(fetched.response_time_ms, fetched.status_code);
+            }
+            if (global_state.budget) {
+                global_state.budget->AddBytes(static_cast<int64_t>(fetched.TransferSize()));
+            }
 
-            // Save to cache
-            if (bind_data.use_cache) {
-                Connection cache_conn(*context.client.db);
-                SaveToCache(cache_conn, result);
+            // Hashed once for the version history, change tracking and the facet cache
+            string content_hash;
+            if (!fetched.body.empty()) {
+                content_hash = HashContent128(fetched.body.data(), fetched.body.size()).ToHex();
             }
+
+            // Save to cache (and the version history, if enabled); head-only bodies are
+            // truncated and would poison full crawls of the URL
+            if (!global_state.cancel_token->IsCancelled() && !bind_data.probe && !bind_data.head_only) {
+                if (use_cache) {
+                    SaveToCache(context.client, fetched);
+                }
+                MaybeRecordBodyVersion(context.client, url, fetched.status_code, fetched.body, content_hash);
+                MaybeRecordChangeObservation(context.client, local_state.change_conn, url, fetched.status_code,
+                                             content_hash);
+            }
+            // Later cache hits of the same content reuse the facets the fetch task extracted
+            if (!global_state.cancel_token->IsCancelled() && fetched.plan.has_facets && !fetched.body.empty()) {
+                RememberPageFacets(context.client, content_hash, url, fetched.plan, use_cache);
+            }
+            return fetched;
+        }, result);
+        if (!fetched_ok) {
+            continue;  // Cancelled while waiting on another caller's fetch; stopped above
         }
+        result.url = url;  // A shared result may have been fetched under a different spelling
 
         // Set output values (single row)
         output.SetValue(0, 0, Value(result.url));
         output.SetValue(1, 0, Value(result.status_code));
-        output.SetValue(2, 0, Value(result.content_type));
-        output.SetValue(3, 0, BuildHtmlStructValue(result.body, result.content_type, result.url));
-        output.SetValue(4, 0, result.error.empty() ? Value() : Value(result.error));
-        output.SetValue(5, 0, result.extracted_json.empty() ? Value() : Value(result.extracted_json));
-        output.SetValue(6, 0, Value::BIGINT(result.response_time_ms));
+        if (bind_data.probe) {
+            output.SetValue(2, 0, result.content_type.empty() ? Value() : Value(result.content_type));
+            output.SetValue(3, 0, result.content_length < 0 ? Value() : Value::BIGINT(result.content_length));
+            output.SetValue(4, 0, result.etag.empty() ? Value() : Value(result.etag));
+            output.SetValue(5, 0, result.last_modified.empty() ? Value() : Value(result.last_modified));
+            output.SetValue(6, 0, result.error.empty() ? Value() : Value(result.error));
+            output.SetValue(7, 0, Value::BIGINT(result.response_time_ms));
+        } else {
+            output.SetValue(2, 0, Value(result.content_type));
+            output.SetValue(3, 0, BuildHtmlStructValue(result.body, &result.plan));
+            output.SetValue(4, 0, result.error.empty() ? Value() : Value(result.error));
+            output.SetValue(5, 0, result.extracted_json.empty() ? Value() : Value(result.extracted_json));
+            output.SetValue(6, 0, Value::BIGINT(result.response_time_ms));
+        }
         output.SetCardinality(1);
 
         local_state.current_row++;
@@ -695,10 +931,7 @@ static OperatorResultType CrawlUrlInOut(ExecutionContext &context, TableFunction
 
         // Decrement shared pipeline counter (for LIMIT pushdown across LATERAL)
         if (bind_data.pipeline_state) {
-            int64_t remaining = --bind_data.pipeline_state->remaining;
-            if (remaining <= 0) {
-                bind_data.pipeline_state->stopped = true;
-            }
+            bind_data.pipeline_state->ConsumeRow();
         }
 
         // More rows in chunk? Return HAVE_MORE_OUTPUT to allow LIMIT to interrupt
@@ -733,6 +966,9 @@ void RegisterCrawlUrlFunction(ExtensionLoader &loader) {
     func.named_parameters["cache"] = LogicalType::BOOLEAN;
     func.named_parameters["cache_ttl"] = LogicalType::INTEGER;
     func.named_parameters["max_results"] = LogicalType::BIGINT;
+    func.named_parameters["method"] = LogicalType::VARCHAR;
+    func.named_parameters["probe"] = LogicalType::BOOLEAN;
+    func.named_parameters["head_only"] = LogicalType::BOOLEAN;
 
     loader.RegisterFunction(func);
 
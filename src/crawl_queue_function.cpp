@@ -0,0 +1,460 @@
+// Work queue table functions for DuckDB Crawler
+// Lets several crawler processes split one frontier stored in a shared table.
+// URLs are enqueued once, claimed as time-limited leases per host-hash shard,
+// kept alive with heartbeats and completed or failed. A lease that expires
+// (crashed or stalled worker) becomes claimable again.
+//
+// Every host hashes to exactly one shard, so workers that claim disjoint shards
+// never fetch the same host and never overlap politeness windows. Shards are
+// assigned with the same jump hash crawl_stream() uses for its workers, so growing
+// num_shards moves only ~1/num_shards of the hosts.
+
+#include "crawl_queue_function.hpp"
+#include "crawler_utils.hpp"
+#include "thread_utils.hpp"
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+
+#include <unordered_set>
+
+namespace duckdb {
+
+static constexpr const char *DEFAULT_QUEUE_TABLE = "__crawler_queue";
+static constexpr int64_t DEFAULT_LEASE_SECONDS = 300;
+static constexpr int64_t DEFAULT_MAX_ATTEMPTS = 3;
+static constexpr int CONFLICT_RETRIES = 5;
+static constexpr idx_t ENQUEUE_BATCH_SIZE = 1000;
+
+//===--------------------------------------------------------------------===//
+// Bind Data (shared by all queue functions)
+//===--------------------------------------------------------------------===//
+
+enum class QueueOp : uint8_t { ENQUEUE, CLAIM, HEARTBEAT, COMPLETE, FAIL, RECLAIM };
+
+struct CrawlQueueBindData : public TableFunctionData {
+    QueueOp op;
+    string queue = DEFAULT_QUEUE_TABLE;
+    vector<string> urls;        // ENQUEUE: URLs to add; COMPLETE/FAIL: the leased URL
+    string worker;              // Lease owner
+    int64_t limit = 1;          // CLAIM: URLs per lease
+    int64_t shard = 0;          // CLAIM: shard to claim from
+    int64_t num_shards = 1;     // CLAIM: total shard count
+    int64_t lease_seconds = DEFAULT_LEASE_SECONDS;
+    string error;               // FAIL: error message to record
+    int64_t max_attempts = DEFAULT_MAX_ATTEMPTS;  // FAIL: attempts before giving up
+
+    explicit CrawlQueueBindData(QueueOp op_p) : op(op_p) {}
+};
+
+//===--------------------------------------------------------------------===//
+// Global State
+//===--------------------------------------------------------------------===//
+
+struct CrawlQueueGlobalState : public GlobalTableFunctionState {
+    bool executed = false;
+    vector<vector<Value>> rows;  // Output rows, produced on first call
+    idx_t current_idx = 0;
+
+    idx_t MaxThreads() const override { return 1; }
+};
+
+//===--------------------------------------------------------------------===//
+// Queue Table Management
+//===--------------------------------------------------------------------===//
+
+static void EnsureQueueTable(Connection &conn, const string &queue) {
+    string sql = "CREATE TABLE IF NOT EXISTS " + queue + " ("
+                 "url VARCHAR PRIMARY KEY, "
+                 "host VARCHAR, "
+                 "host_hash UBIGINT, "
+                 "status VARCHAR DEFAULT 'pending', "   // pending, leased, done, failed
+                 "attempts INTEGER DEFAULT 0, "
+                 "lease_owner VARCHAR, "
+                 "lease_expires TIMESTAMP, "
+                 "last_error VARCHAR, "
+                 "enqueued_at TIMESTAMP DEFAULT current_timestamp, "
+                 "updated_at TIMESTAMP DEFAULT current_timestamp)";
+    auto result = conn.Query(sql);
+    if (result->HasError()) {
+        throw IOException("crawl queue: failed to create %s: %s", queue, result->GetError());
+    }
+}
+
+// Run a queue statement and return its rows, retrying when a concurrent worker touched
+// the same rows. Conflicts are expected when several workers claim at once; the loser retries.
+template <typename... ARGS>
+static vector<vector<Value>> RunQueueStatement(Connection &conn, const string &sql, ARGS... args) {
+    unique_ptr<QueryResult> result;
+    for (int attempt = 0; attempt < CONFLICT_RETRIES; attempt++) {
+        result = conn.Query(sql, args...);
+        if (!result->HasError() || result->GetErrorType() != ExceptionType::TRANSACTION) {
+            break;
+        }
+    }
+    if (result->HasError()) {
+        throw IOException("crawl queue: %s", result->GetError());
+    }
+
+    vector<vector<Value>> rows;
+    while (auto chunk = result->Fetch()) {
+        if (chunk->size() == 0) break;
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            vector<Value> values;
+            for (idx_t col = 0; col < chunk->ColumnCount(); col++) {
+                values.push_back(chunk->GetValue(col, row));
+            }
+            rows.push_back(std::move(values));
+        }
+    }
+    return rows;
+}
+
+// First value of a single-row result (the affected row count of DML statements)
+static int64_t AffectedRows(const vector<vector<Value>> &rows) {
+    if (rows.empty() || rows[0].empty() || rows[0][0].IsNull()) return 0;
+    return rows[0][0].GetValue<int64_t>();
+}
+
+//===--------------------------------------------------------------------===//
+// Operations
+//===--------------------------------------------------------------------===//
+
+static int64_t EnqueueUrls(Connection &conn, const CrawlQueueBindData &bind_data) {
+    // Duplicate keys inside one INSERT fail even with ON CONFLICT, so dedupe first
+    std::unordered_set<string> seen;
+    vector<string> values;
+    for (const auto &url : bind_data.urls) {
+        if (!IsValidCrawlUrl(url) || !seen.insert(url).second) {
+            continue;
+        }
+        values.push_back("(" + EscapeSqlString(url) + ", " + EscapeSqlString(ExtractDomain(url)) + ", " +
+                         std::to_string(HostHash(url)) + "::UBIGINT)");
+    }
+
+    int64_t enqueued = 0;
+    for (idx_t start = 0; start < values.size(); start += ENQUEUE_BATCH_SIZE) {
+        idx_t end = MinValue<idx_t>(start + ENQUEUE_BATCH_SIZE, values.size());
+        string sql = "INSERT INTO " + bind_data.queue + " (url, host, host_hash) VALUES ";
+        for (idx_t i = start; i < end; i++) {
+            if (i > start) sql += ", ";
+            sql += values[i];
+        }
+        sql += " ON CONFLICT DO NOTHING";
+        enqueued += AffectedRows(RunQueueStatement(conn, sql));
+    }
+    return enqueued;
+}
+
+// Lease up to `limit` claimable URLs of one shard. Claimable means pending, or leased
+// with an expired lease. Each claim counts as an attempt, so a URL that keeps killing
+// its worker eventually exhausts max_attempts when it is failed.
+static vector<vector<Value>> ClaimUrls(Connection &conn, const CrawlQueueBindData &bind_data) {
+    string sql = "UPDATE " + bind_data.queue + " SET "
+                 "status = 'leased', lease_owner = $1, "
+                 "lease_expires = current_timestamp + to_seconds($2::BIGINT), "
+                 "attempts = attempts + 1, updated_at = current_timestamp "
+                 "WHERE url IN ("
+                 "SELECT url FROM " + bind_data.queue + " "
+                 "WHERE (status = 'pending' OR (status = 'leased' AND lease_expires < current_timestamp)) "
+                 "AND crawl_host_shard(host_hash, $3::INTEGER) = $4::INTEGER "
+                 "ORDER BY enqueued_at, url LIMIT $5) "
+                 "RETURNING url, host, attempts, lease_expires";
+    return RunQueueStatement(conn, sql, Value(bind_data.worker), Value::BIGINT(bind_data.lease_seconds),
+                             Value::BIGINT(bind_data.num_shards), Value::BIGINT(bind_data.shard),
+                             Value::BIGINT(bind_data.limit));
+}
+
+static int64_t HeartbeatLeases(Connection &conn, const CrawlQueueBindData &bind_data) {
+    string sql = "UPDATE " + bind_data.queue + " SET "
+                 "lease_expires = current_timestamp + to_seconds($2::BIGINT), updated_at = current_timestamp "
+                 "WHERE status = 'leased' AND lease_owner = $1";
+    return AffectedRows(
+        RunQueueStatement(conn, sql, Value(bind_data.worker), Value::BIGINT(bind_data.lease_seconds)));
+}
+
+// Complete only while the caller still owns the lease; 0 means the lease was lost
+static int64_t CompleteUrl(Connection &conn, const CrawlQueueBindData &bind_data) {
+    string sql = "UPDATE " + bind_data.queue + " SET "
+                 "status = 'done', lease_owner = NULL, lease_expires = NULL, last_error = NULL, "
+                 "updated_at = current_timestamp "
+                 "WHERE url = $1 AND status = 'leased' AND lease_owner = $2";
+    return AffectedRows(RunQueueStatement(conn, sql, Value(bind_data.urls[0]), Value(bind_data.worker)));
+}
+
+// Return the URL to the queue, or mark it failed once max_attempts is reached
+static int64_t FailUrl(Connection &conn, const CrawlQueueBindData &bind_data) {
+    string sql = "UPDATE " + bind_data.queue + " SET "
+                 "status = CASE WHEN attempts >= $4 THEN 'failed' ELSE 'pending' END, "
+                 "lease_owner = NULL, lease_expires = NULL, last_error = $3, "
+                 "updated_at = current_timestamp "
+                 "WHERE url = $1 AND status = 'leased' AND lease_owner = $2";
+    return AffectedRows(RunQueueStatement(conn, sql, Value(bind_data.urls[0]), Value(bind_data.worker),
+                                          bind_data.error.empty() ? Value() : Value(bind_data.error),
+                                          Value::BIGINT(bind_data.max_attempts)));
+}
+
+// Explicitly return expired leases to pending (claims also pick them up directly)
+static int64_t ReclaimExpired(Connection &conn, const CrawlQueueBindData &bind_data) {
+    string sql = "UPDATE " + bind_data.queue + " SET "
+                 "status = 'pending', lease_owner = NULL, lease_expires = NULL, updated_at = current_timestamp "
+                 "WHERE status = 'leased' AND lease_expires < current_timestamp";
+    return AffectedRows(RunQueueStatement(conn, sql));
+}
+
+//===--------------------------------------------------------------------===//
+// Bind Functions
+//===--------------------------------------------------------------------===//
+
+static string RequireString(const Value &value, const char *function_name, const char *argument) {
+    if (value.IsNull()) {
+        throw BinderException("%s() requires a non-NULL %s", function_name, argument);
+    }
+    return value.ToString();
+}
+
+// Named parameters shared by all queue functions
+static void BindQueueParameters(TableFunctionBindInput &input, CrawlQueueBindData &bind_data,
+                                const char *function_name) {
+    for (auto &kv : input.named_parameters) {
+        if (kv.second.IsNull()) continue;
+        if (kv.first == "queue") {
+            bind_data.queue = StringValue::Get(kv.second);
+        } else if (kv.first == "shard") {
+            bind_data.shard = kv.second.GetValue<int64_t>();
+        } else if (kv.first == "num_shards") {
+            bind_data.num_shards = kv.second.GetValue<int64_t>();
+        } else if (kv.first == "lease") {
+            bind_data.lease_seconds = kv.second.GetValue<int64_t>();
+        } else if (kv.first == "error") {
+            bind_data.error = StringValue::Get(kv.second);
+        } else if (kv.first == "max_attempts") {
+            bind_data.max_attempts = kv.second.GetValue<int64_t>();
+        }
+    }
+
+    if (!IsValidSqlIdentifier(bind_data.queue)) {
+        throw BinderException("%s(): invalid queue table name '%s'", function_name, bind_data.queue);
+    }
+    if (bind_data.num_shards < 1 || bind_data.num_shards > NumericLimits<int32_t>::Maximum()) {
+        throw BinderException("%s(): num_shards must be between 1 and %d", function_name,
+                              NumericLimits<int32_t>::Maximum());
+    }
+    if (bind_data.shard < 0 || bind_data.shard >= bind_data.num_shards) {
+        throw BinderException("%s(): shard must be between 0 and num_shards - 1", function_name);
+    }
+    if (bind_data.lease_seconds < 1) {
+        throw BinderException("%s(): lease must be at least 1 second", function_name);
+    }
+}
+
+static void SetCountColumn(vector<LogicalType> &return_types, vector<string> &names, const string &name) {
+    return_types.push_back(LogicalType::BIGINT);
+    names.push_back(name);
+}
+
+static unique_ptr<FunctionData> EnqueueBind(ClientContext &context, TableFunctionBindInput &input,
+                                            vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<CrawlQueueBindData>(QueueOp::ENQUEUE);
+    auto &urls_val = input.inputs[0];
+    if (urls_val.type().id() == LogicalTypeId::LIST) {
+        if (!urls_val.IsNull()) {
+            for (auto &child : ListValue::GetChildren(urls_val)) {
+                if (!child.IsNull()) {
+                    bind_data->urls.push_back(StringValue::Get(child));
+                }
+            }
+        }
+    } else if (!urls_val.IsNull()) {
+        bind_data->urls.push_back(StringValue::Get(urls_val));
+    }
+    BindQueueParameters(input, *bind_data, "crawl_queue_enqueue");
+    SetCountColumn(return_types, names, "enqueued");
+    return std::move(bind_data);
+}
+
+static unique_ptr<FunctionData> ClaimBind(ClientContext &context, TableFunctionBindInput &input,
+                                          vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<CrawlQueueBindData>(QueueOp::CLAIM);
+    bind_data->worker = RequireString(input.inputs[0], "crawl_queue_claim", "worker");
+    bind_data->limit = input.inputs[1].IsNull() ? 1 : input.inputs[1].GetValue<int64_t>();
+    if (bind_data->limit < 1) {
+        throw BinderException("crawl_queue_claim(): the number of URLs to claim must be at least 1");
+    }
+    BindQueueParameters(input, *bind_data, "crawl_queue_claim");
+
+    return_types.push_back(LogicalType::VARCHAR);
+    names.push_back("url");
+    return_types.push_back(LogicalType::VARCHAR);
+    names.push_back("host");
+    return_types.push_back(LogicalType::INTEGER);
+    names.push_back("attempts");
+    return_types.push_back(LogicalType::TIMESTAMP);
+    names.push_back("lease_expires");
+    return std::move(bind_data);
+}
+
+static unique_ptr<FunctionData> HeartbeatBind(ClientContext &context, TableFunctionBindInput &input,
+                                              vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<CrawlQueueBindData>(QueueOp::HEARTBEAT);
+    bind_data->worker = RequireString(input.inputs[0], "crawl_queue_heartbeat", "worker");
+    BindQueueParameters(input, *bind_data, "crawl_queue_heartbeat");
+    SetCountColumn(return_types, names, "extended");
+    return std::move(bind_data);
+}
+
+static unique_ptr<FunctionData> CompleteBind(ClientContext &context, TableFunctionBindInput &input,
+                                             vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<CrawlQueueBindData>(QueueOp::COMPLETE);
+    bind_data->urls.push_back(RequireString(input.inputs[0], "crawl_queue_complete", "url"));
+    bind_data->worker = RequireString(input.inputs[1], "crawl_queue_complete", "worker");
+    BindQueueParameters(input, *bind_data, "crawl_queue_complete");
+    SetCountColumn(return_types, names, "updated");
+    return std::move(bind_data);
+}
+
+static unique_ptr<FunctionData> FailBind(ClientContext &context, TableFunctionBindInput &input,
+                                         vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<CrawlQueueBindData>(QueueOp::FAIL);
+    bind_data->urls.push_back(RequireString(input.inputs[0], "crawl_queue_fail", "url"));
+    bind_data->worker = RequireString(input.inputs[1], "crawl_queue_fail", "worker");
+    BindQueueParameters(input, *bind_data, "crawl_queue_fail");
+    SetCountColumn(return_types, names, "updated");
+    return std::move(bind_data);
+}
+
+static unique_ptr<FunctionData> ReclaimBind(ClientContext &context, TableFunctionBindInput &input,
+                                            vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<CrawlQueueBindData>(QueueOp::RECLAIM);
+    BindQueueParameters(input, *bind_data, "crawl_queue_reclaim");
+    SetCountColumn(return_types, names, "reclaimed");
+    return std::move(bind_data);
+}
+
+//===--------------------------------------------------------------------===//
+// Init Global
+//===--------------------------------------------------------------------===//
+
+static unique_ptr<GlobalTableFunctionState> CrawlQueueInitGlobal(ClientContext &context,
+                                                                  TableFunctionInitInput &input) {
+    return make_uniq<CrawlQueueGlobalState>();
+}
+
+//===--------------------------------------------------------------------===//
+// Table Function
+//===--------------------------------------------------------------------===//
+
+static void CrawlQueueFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &bind_data = data.bind_data->Cast<CrawlQueueBindData>();
+    auto &state = data.global_state->Cast<CrawlQueueGlobalState>();
+
+    // Run the statement once, on first call
+    if (!state.executed) {
+        state.executed = true;
+        Connection conn(*context.db);
+        EnsureQueueTable(conn, bind_data.queue);
+
+        switch (bind_data.op) {
+        case QueueOp::ENQUEUE:
+            state.rows.push_back({Value::BIGINT(EnqueueUrls(conn, bind_data))});
+            break;
+        case QueueOp::CLAIM:
+            state.rows = ClaimUrls(conn, bind_data);
+            break;
+        case QueueOp::HEARTBEAT:
+            state.rows.push_back({Value::BIGINT(HeartbeatLeases(conn, bind_data))});
+            break;
+        case QueueOp::COMPLETE:
+            state.rows.push_back({Value::BIGINT(CompleteUrl(conn, bind_data))});
+            break;
+        case QueueOp::FAIL:
+            state.rows.push_back({Value::BIGINT(FailUrl(conn, bind_data))});
+            break;
+        case QueueOp::RECLAIM:
+            state.rows.push_back({Value::BIGINT(ReclaimExpired(conn, bind_data))});
+            break;
+        }
+    }
+
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE && state.current_idx < state.rows.size()) {
+        auto &row = state.rows[state.current_idx++];
+        for (idx_t col = 0; col < row.size(); col++) {
+            output.SetValue(col, count, row[col]);
+        }
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+// crawl_host_shard(host_hash, num_shards) -> INTEGER: the shard that owns a queued host
+static void HostShardFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    BinaryExecutor::Execute<uint64_t, int32_t, int32_t>(
+        args.data[0], args.data[1], result, args.size(), [](uint64_t host_hash, int32_t num_shards) {
+            if (num_shards < 1) {
+                throw InvalidInputException("crawl_host_shard(): num_shards must be at least 1");
+            }
+            return JumpConsistentHash(host_hash, num_shards);
+        });
+}
+
+//===--------------------------------------------------------------------===//
+// Register Functions
+//===--------------------------------------------------------------------===//
+
+void RegisterCrawlQueueFunctions(ExtensionLoader &loader) {
+    // crawl_host_shard(host_hash, num_shards), used by claims to pick a shard's hosts
+    loader.RegisterFunction(ScalarFunction("crawl_host_shard", {LogicalType::UBIGINT, LogicalType::INTEGER},
+                                           LogicalType::INTEGER, HostShardFunction));
+
+    auto add_params = [](TableFunction &func) {
+        func.named_parameters["queue"] = LogicalType::VARCHAR;
+        func.named_parameters["lease"] = LogicalType::BIGINT;
+    };
+
+    // crawl_queue_enqueue(url | [urls])
+    TableFunctionSet enqueue_set("crawl_queue_enqueue");
+    vector<LogicalType> url_arg_types = {LogicalType::VARCHAR, LogicalType::LIST(LogicalType::VARCHAR)};
+    for (auto &arg_type : url_arg_types) {
+        TableFunction func({arg_type}, CrawlQueueFunction, EnqueueBind, CrawlQueueInitGlobal);
+        func.named_parameters["queue"] = LogicalType::VARCHAR;
+        enqueue_set.AddFunction(func);
+    }
+    loader.RegisterFunction(enqueue_set);
+
+    // crawl_queue_claim(worker, n, shard := 0, num_shards := 1, lease := 300)
+    TableFunction claim_func("crawl_queue_claim", {LogicalType::VARCHAR, LogicalType::BIGINT}, CrawlQueueFunction,
+                             ClaimBind, CrawlQueueInitGlobal);
+    add_params(claim_func);
+    claim_func.named_parameters["shard"] = LogicalType::BIGINT;
+    claim_func.named_parameters["num_shards"] = LogicalType::BIGINT;
+    loader.RegisterFunction(claim_func);
+
+    // crawl_queue_heartbeat(worker, lease := 300)
+    TableFunction heartbeat_func("crawl_queue_heartbeat", {LogicalType::VARCHAR}, CrawlQueueFunction,
+                                 HeartbeatBind, CrawlQueueInitGlobal);
+    add_params(heartbeat_func);
+    loader.RegisterFunction(heartbeat_func);
+
+    // crawl_queue_complete(url, worker)
+    TableFunction complete_func("crawl_queue_complete", {LogicalType::VARCHAR, LogicalType::VARCHAR},
+                                CrawlQueueFunction, CompleteBind, CrawlQueueInitGlobal);
+    complete_func.named_parameters["queue"] = LogicalType::VARCHAR;
+    loader.RegisterFunction(complete_func);
+
+    // crawl_queue_fail(url, worker, error := ..., max_attempts := 3)
+    TableFunction fail_func("crawl_queue_fail", {LogicalType::VARCHAR, LogicalType::VARCHAR}, CrawlQueueFunction,
+                            FailBind, CrawlQueueInitGlobal);
+    fail_func.named_parameters["queue"] = LogicalType::VARCHAR;
+    fail_func.named_parameters["error"] = LogicalType::VARCHAR;
+    fail_func.named_parameters["max_attempts"] = LogicalType::BIGINT;
+    loader.RegisterFunction(fail_func);
+
+    // crawl_queue_reclaim()
+    TableFunction reclaim_func("crawl_queue_reclaim", {}, CrawlQueueFunction, ReclaimBind, CrawlQueueInitGlobal);
+    reclaim_func.named_parameters["queue"] = LogicalType::VARCHAR;
+    loader.RegisterFunction(reclaim_func);
+}
+
+} // namespace duckdb
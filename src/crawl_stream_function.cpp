@@ -3,12 +3,20 @@
 // Usage:
 //   SELECT * FROM crawl_stream(['https://example.com', 'https://test.com'])
 //   SELECT * FROM crawl_stream(['url1', 'url2'], user_agent := 'Bot/1.0')
+//   SELECT * FROM crawl_stream('SELECT url FROM todo', max_duration := INTERVAL 30 MINUTE,
+//                              frontier := 'todo')
 //
 // Returns rows as they are crawled (streaming), not blocking until all complete.
+// When a budget (max_duration, max_bytes, max_requests_per_host) runs out, workers stop
+// dispatching and in-flight fetches complete and are returned. With `frontier`, the URLs
+// not fetched are saved to __crawler_frontier under that crawl_id, and the next run with
+// the same frontier fetches them first.
 
 #include "crawl_stream_function.hpp"
 #include "crawler_internal.hpp"
 #include "crawler_utils.hpp"
+#include "crawl_budget.hpp"
+#include "crawl_frontier.hpp"
 #include "thread_utils.hpp"
 #include "link_parser.hpp"
 #include "rust_ffi.hpp"
@@ -24,6 +32,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace duckdb {
 
@@ -135,6 +145,11 @@ static bool ParseStreamCrawlResponse(const string &response_json, BatchCrawlEntr
         entry.body = yyjson_get_str(body_val);
     }
 
+    yyjson_val *transfer_val = yyjson_obj_get(item, "transfer_size");
+    if (transfer_val && yyjson_is_uint(transfer_val)) {
+        entry.transfer_size = (int64_t)yyjson_get_uint(transfer_val);
+    }
+
     yyjson_val *error_val = yyjson_obj_get(item, "error");
     if (error_val && yyjson_is_str(error_val)) {
         entry.error = yyjson_get_str(error_val);
@@ -167,6 +182,8 @@ struct CrawlStreamBindData : public TableFunctionData {
     double crawl_delay = 0.2;
     int timeout_seconds = 30;
     bool respect_robots_txt = false;
+    string frontier;      // crawl_id to resume from and save leftovers under (empty = none)
+    CrawlBudget budget;
 };
 
 // Thread-safe result queue
@@ -207,45 +224,113 @@ struct StreamResultQueue {
 struct CrawlStreamGlobalState : public GlobalTableFunctionState {
     std::unique_ptr<StreamResultQueue> result_queue;
     std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<MpscQueue<string>>> shard_inboxes;  // One per worker, URLs routed by host
+    std::atomic<bool> dispatch_complete{false};
     std::atomic<bool> should_stop{false};
-    std::atomic<idx_t> next_url_idx{0};
     bool workers_started = false;
     bool query_executed = false;
     std::mutex start_mutex;
+    std::unique_ptr<CrawlCancelToken> cancel_token;  // Cancelled on query interrupt or teardown
+    std::shared_ptr<CrawlBudgetTracker> budget;      // nullptr = unlimited
+    std::mutex unfetched_mutex;
+    vector<FrontierUrl> unfetched;                   // Left over by the budget, saved when the scan ends
+    std::unordered_set<string> resumed_urls;         // Saved frontier rows to drop once returned
+    unique_ptr<Connection> frontier_conn;            // Drops resumed rows (frontier only)
+
+    // The scan may be torn down before the queue drains (LIMIT, error, Ctrl+C):
+    // abort in-flight fetches and join the workers so no thread outlives this state.
+    ~CrawlStreamGlobalState() {
+        should_stop.store(true);
+        if (cancel_token) {
+            cancel_token->Cancel();
+        }
+        for (auto &worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
 
     idx_t MaxThreads() const override {
         return 1; // Only one thread reads results
     }
 };
 
-// Worker function for streaming crawl
+// Worker function for streaming crawl. Each worker is one host shard: it alone fetches
+// the hosts that hash to it, so per-host politeness state is worker-local and unlocked.
 static void StreamCrawlWorker(
     CrawlStreamBindData &bind_data,
     CrawlStreamGlobalState &global_state,
-    int worker_id
+    int shard
 ) {
-    (void)worker_id;  // Unused
-    global_state.result_queue->active_workers.fetch_add(1);
+    auto &inbox = *global_state.shard_inboxes[shard];
+    std::unordered_map<string, DomainState> domains;  // Hosts owned by this shard
+    std::priority_queue<UrlQueueEntry, std::vector<UrlQueueEntry>, std::greater<UrlQueueEntry>> schedule;
+    auto host_delay = std::chrono::milliseconds(static_cast<int64_t>(bind_data.crawl_delay * 1000));
 
-    // Cache robots.txt results per domain
+    // Cache robots.txt results per URL
     std::map<string, bool> robots_cache;
-    std::mutex robots_mutex;
 
-    while (!global_state.should_stop.load()) {
-        // Get next URL to process
-        idx_t url_idx = global_state.next_url_idx.fetch_add(1);
-        if (url_idx >= bind_data.urls.size()) {
+    // URLs this worker will not fetch because the budget ran out
+    vector<FrontierUrl> unfetched;
+    auto defer = [&](const string &url) {
+        FrontierUrl entry;
+        entry.url = url;
+        unfetched.push_back(std::move(entry));
+    };
+
+    while (!global_state.should_stop.load() && !global_state.cancel_token->IsCancelled()) {
+        // Take URLs handed to this shard into the local schedule
+        string handed_off;
+        while (inbox.TryPop(handed_off)) {
+            schedule.push(UrlQueueEntry(handed_off, 0, false));
+        }
+        if (schedule.empty()) {
+            if (global_state.dispatch_complete.load()) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (schedule.top().earliest_fetch > now) {
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                schedule.top().earliest_fetch - now, std::chrono::milliseconds(50)));
+            continue;
+        }
+        UrlQueueEntry next = schedule.top();
+        schedule.pop();
+
+        // Budget spent: stop dispatching and hand back everything still queued here
+        if (global_state.budget && global_state.budget->Exhausted()) {
+            defer(next.url);
+            for (; !schedule.empty(); schedule.pop()) {
+                defer(schedule.top().url);
+            }
+            while (inbox.TryPop(handed_off)) {
+                defer(handed_off);
+            }
             break;
         }
 
-        const string &url = bind_data.urls[url_idx];
+        const string &url = next.url;
         string domain = ExtractDomain(url);
         string path = ExtractPath(url);
 
+        // Per-host politeness: space requests to the same host by crawl_delay
+        auto &domain_state = domains[domain];
+        if (domain_state.urls_crawled > 0 && now < domain_state.last_crawl_time + host_delay) {
+            next.earliest_fetch = domain_state.last_crawl_time + host_delay;
+            schedule.push(std::move(next));
+            continue;
+        }
+        domain_state.last_crawl_time = now;
+        domain_state.urls_crawled++;
+
         // Check robots.txt if needed
         bool robots_allow = true;
         if (bind_data.respect_robots_txt) {
-            std::lock_guard<std::mutex> lock(robots_mutex);
             auto it = robots_cache.find(url);
             if (it != robots_cache.end()) {
                 robots_allow = it->second;
@@ -262,15 +347,28 @@ static void StreamCrawlWorker(
             continue;
         }
 
+        if (global_state.budget && !global_state.budget->TryAcquireHost(url)) {
+            defer(url);
+            continue;
+        }
+
         // Fetch the URL using Rust
         string request_json = BuildStreamCrawlRequest(url, bind_data.user_agent,
                                                        bind_data.timeout_seconds * 1000);
-        string response_json = CrawlBatchWithRust(request_json);
+        string response_json = CrawlBatchWithRust(request_json, *global_state.cancel_token);
+        if (global_state.cancel_token->IsCancelled()) {
+            break;
+        }
 
         // Build result entry
         BatchCrawlEntry entry;
         entry.url = url;
         ParseStreamCrawlResponse(response_json, entry);
+        if (global_state.budget) {
+            // Charge what crossed the wire, not the decoded text
+            global_state.budget->AddBytes(entry.transfer_size >= 0 ? entry.transfer_size
+                                                                    : static_cast<int64_t>(entry.body.size()));
+        }
 
         // Extract structured data using Rust if successful
         if (entry.status_code >= 200 && entry.status_code < 300 && !entry.body.empty()) {
@@ -284,11 +382,12 @@ static void StreamCrawlWorker(
 
         // Push result to queue
         global_state.result_queue->Push(std::move(entry));
+    }
 
-        // Respect crawl delay
-        if (bind_data.crawl_delay > 0) {
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds(static_cast<int>(bind_data.crawl_delay * 1000)));
+    if (!unfetched.empty()) {
+        std::lock_guard<std::mutex> lock(global_state.unfetched_mutex);
+        for (auto &entry : unfetched) {
+            global_state.unfetched.push_back(std::move(entry));
         }
     }
 
@@ -318,6 +417,7 @@ static unique_ptr<FunctionData> CrawlStreamBind(ClientContext &context, TableFun
     if (context.TryGetCurrentSetting("crawler_respect_robots", setting_value)) {
         bind_data->respect_robots_txt = setting_value.GetValue<bool>();
     }
+    bind_data->budget = CrawlBudget::FromSettings(context);
 
     // First argument is list of URLs
     auto &url_list = ListValue::GetChildren(input.inputs[0]);
@@ -337,6 +437,10 @@ static unique_ptr<FunctionData> CrawlStreamBind(ClientContext &context, TableFun
             bind_data->timeout_seconds = kv.second.GetValue<int>();
         } else if (kv.first == "respect_robots_txt") {
             bind_data->respect_robots_txt = kv.second.GetValue<bool>();
+        } else if (kv.first == "frontier") {
+            bind_data->frontier = StringValue::Get(kv.second);
+        } else {
+            bind_data->budget.ApplyParameter("crawl_stream", kv.first, kv.second);
         }
     }
 
@@ -379,6 +483,7 @@ static unique_ptr<FunctionData> CrawlStreamBindQuery(ClientContext &context, Tab
     if (context.TryGetCurrentSetting("crawler_respect_robots", setting_value)) {
         bind_data->respect_robots_txt = setting_value.GetValue<bool>();
     }
+    bind_data->budget = CrawlBudget::FromSettings(context);
 
     // First argument is a query string
     bind_data->source_query = StringValue::Get(input.inputs[0]);
@@ -393,6 +498,10 @@ static unique_ptr<FunctionData> CrawlStreamBindQuery(ClientContext &context, Tab
             bind_data->timeout_seconds = kv.second.GetValue<int>();
         } else if (kv.first == "respect_robots_txt") {
             bind_data->respect_robots_txt = kv.second.GetValue<bool>();
+        } else if (kv.first == "frontier") {
+            bind_data->frontier = StringValue::Get(kv.second);
+        } else {
+            bind_data->budget.ApplyParameter("crawl_stream", kv.first, kv.second);
         }
     }
 
@@ -421,6 +530,8 @@ static unique_ptr<GlobalTableFunctionState> CrawlStreamInitGlobal(ClientContext
                                                                     TableFunctionInitInput &input) {
     auto state = make_uniq<CrawlStreamGlobalState>();
     state->result_queue = make_uniq<StreamResultQueue>();
+    state->cancel_token = make_uniq<CrawlCancelToken>(&context.interrupted);
+    state->budget = ResolveBudgetTracker(context, input.bind_data->Cast<CrawlStreamBindData>().budget);
     return std::move(state);
 }
 
@@ -455,9 +566,38 @@ static void CrawlStreamFunction(ClientContext &context, TableFunctionInput &data
         if (!global_state.workers_started) {
             global_state.workers_started = true;
 
-            // Start worker threads (use 4 workers or fewer if fewer URLs)
+            // Resume what an earlier run with this frontier left behind, ahead of the new URLs.
+            // Saved rows are dropped one by one as they are returned, so a run cut short
+            // keeps the rest.
+            if (!bind_data.frontier.empty()) {
+                global_state.frontier_conn = make_uniq<Connection>(*context.db);
+                vector<string> urls;
+                for (auto &saved : LoadSavedFrontier(*global_state.frontier_conn, bind_data.frontier)) {
+                    if (global_state.resumed_urls.insert(saved.url).second) {
+                        urls.push_back(saved.url);
+                    }
+                }
+                for (auto &url : bind_data.urls) {
+                    if (global_state.resumed_urls.count(url) == 0) {
+                        urls.push_back(url);
+                    }
+                }
+                bind_data.urls = std::move(urls);
+            }
+
+            // Start worker threads (use 4 workers or fewer if fewer URLs), one host shard each
             int num_workers = std::min((int)bind_data.urls.size(), 4);
             if (num_workers < 1) num_workers = 1;
+            for (int i = 0; i < num_workers; i++) {
+                global_state.shard_inboxes.push_back(make_uniq<MpscQueue<string>>());
+            }
+            for (const auto &url : bind_data.urls) {
+                global_state.shard_inboxes[HostShardFor(url, num_workers)]->Push(url);
+            }
+            global_state.dispatch_complete.store(true);
+
+            // Count workers before starting them, so an early finisher can't mark the queue finished
+            global_state.result_queue->active_workers.store(num_workers);
             for (int i = 0; i < num_workers; i++) {
                 global_state.workers.emplace_back(StreamCrawlWorker,
                     std::ref(bind_data), std::ref(global_state), i);
@@ -481,7 +621,10 @@ static void CrawlStreamFunction(ClientContext &context, TableFunctionInput &data
             output.SetValue(8, count, Value(entry.opengraph));
             output.SetValue(9, count, Value(entry.meta));
             count++;
-        } else if (global_state.result_queue->IsComplete()) {
+            if (global_state.frontier_conn && global_state.resumed_urls.erase(entry.url)) {
+                ForgetSavedFrontierUrl(*global_state.frontier_conn, bind_data.frontier, entry.url);
+            }
+        } else if (global_state.result_queue->IsComplete() || global_state.cancel_token->IsCancelled()) {
             break;
         }
     }
@@ -497,6 +640,14 @@ static void CrawlStreamFunction(ClientContext &context, TableFunctionInput &data
                 worker.join();
             }
         }
+
+        // All workers have drained; keep what the budget left for the next run with this
+        // frontier. Without one there is nothing to resume it under.
+        std::lock_guard<std::mutex> lock(global_state.unfetched_mutex);
+        if (global_state.frontier_conn && !global_state.unfetched.empty()) {
+            SaveFrontier(*global_state.frontier_conn, bind_data.frontier, global_state.unfetched);
+        }
+        global_state.unfetched.clear();
     }
 }
 
@@ -509,6 +660,10 @@ void RegisterCrawlStreamFunction(ExtensionLoader &loader) {
     list_func.named_parameters["crawl_delay"] = LogicalType::DOUBLE;
     list_func.named_parameters["timeout"] = LogicalType::INTEGER;
     list_func.named_parameters["respect_robots_txt"] = LogicalType::BOOLEAN;
+    list_func.named_parameters["frontier"] = LogicalType::VARCHAR;
+    list_func.named_parameters["max_duration"] = LogicalType::INTERVAL;
+    list_func.named_parameters["max_bytes"] = LogicalType::BIGINT;
+    list_func.named_parameters["max_requests_per_host"] = LogicalType::BIGINT;
 
     // Version 2: Accept query string
     TableFunction query_func("crawl_stream",
@@ -518,6 +673,10 @@ void RegisterCrawlStreamFunction(ExtensionLoader &loader) {
     query_func.named_parameters["crawl_delay"] = LogicalType::DOUBLE;
     query_func.named_parameters["timeout"] = LogicalType::INTEGER;
     query_func.named_parameters["respect_robots_txt"] = LogicalType::BOOLEAN;
+    query_func.named_parameters["frontier"] = LogicalType::VARCHAR;
+    query_func.named_parameters["max_duration"] = LogicalType::INTERVAL;
+    query_func.named_parameters["max_bytes"] = LogicalType::BIGINT;
+    query_func.named_parameters["max_requests_per_host"] = LogicalType::BIGINT;
 
     // Register both as a function set
     TableFunctionSet crawl_stream_set("crawl_stream");
@@ -12,6 +12,15 @@
 // Or with URL list:
 //   SELECT * FROM crawl(['https://example.com'], user_agent = 'Bot/1.0')
 //
+// priority := 'best_first' (or a SQL expression over depth, sitemap_priority,
+// lastmod_age_days, inlinks, url) fetches the most valuable URLs first, so a crawl cut
+// short by LIMIT or max_results keeps the best pages. A source query may pass sitemap()
+// priority and lastmod columns through.
+//
+// With dedup := true, pages that repeat (or nearly repeat) an earlier page of the same
+// crawl are returned without html/extract (they are still cached); near_duplicate_of
+// names the earlier URL.
+//
 // The 'html' column is a STRUCT containing:
 //   - body: raw HTML content
 //   - js: extracted JavaScript variables as JSON
@@ -21,6 +30,15 @@
 #include "crawl_table_function.hpp"
 #include "crawler_utils.hpp"
 #include "rust_ffi.hpp"
+#include "response_cache.hpp"
+#include "content_fingerprint.hpp"
+#include "body_versions.hpp"
+#include "recrawl_scheduler.hpp"
+#include "crawl_frontier.hpp"
+#include "crawl_budget.hpp"
+#include "proxy_pool.hpp"
+#include "extraction_plan.hpp"
+#include "facet_cache.hpp"
 #include "yyjson.hpp"
 
 #include "duckdb/function/table_function.hpp"
@@ -29,9 +47,11 @@
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/main/secret/secret_manager.hpp"
 #include "duckdb/catalog/catalog_transaction.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 
 #include <set>
 #include <map>
+#include <unordered_set>
 
 namespace duckdb {
 
@@ -49,7 +69,11 @@ static string BuildBatchCrawlRequest(const vector<string> &urls,
                                       const string &http_proxy = "",
                                       const string &http_proxy_username = "",
                                       const string &http_proxy_password = "",
-                                      const std::map<string, string> &extra_headers = {}) {
+                                      const std::map<string, string> &extra_headers = {},
+                                      CompressedStorage store_compressed = CompressedStorage::OFF,
+                                      bool probe = false,
+                                      bool head_only = false,
+                                      idx_t compute_threads = 0) {
     yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
     if (!doc) return "{}";
 
@@ -101,6 +125,26 @@ static string BuildBatchCrawlRequest(const vector<string> &urls,
         yyjson_mut_obj_add_val(doc, root, "extra_headers", headers_obj);
     }
 
+    // Keep the origin's compressed bytes (fetched without automatic decompression)
+    if (store_compressed != CompressedStorage::OFF) {
+        yyjson_mut_obj_add_str(doc, root, "store_compressed", CompressedStorageName(store_compressed));
+    }
+
+    // Headers only (HEAD, or a one-byte range GET where HEAD is rejected)
+    if (probe) {
+        yyjson_mut_obj_add_bool(doc, root, "probe", true);
+    }
+
+    // Stop reading HTML bodies at the end of <head>
+    if (head_only) {
+        yyjson_mut_obj_add_bool(doc, root, "head_only", true);
+    }
+
+    // Decoding/extraction jobs in flight on the Rust compute pool
+    if (compute_threads > 0) {
+        yyjson_mut_obj_add_uint(doc, root, "compute_threads", compute_threads);
+    }
+
     size_t len = 0;
     char *json_str = yyjson_mut_write(doc, 0, &len);
     yyjson_mut_doc_free(doc);
@@ -112,6 +156,17 @@ static string BuildBatchCrawlRequest(const vector<string> &urls,
     return result_str;
 }
 
+// Threads the Rust side may use for decoding and extraction: crawler_compute_threads,
+// or DuckDB's thread count (SET threads) when that is 0
+static idx_t GetComputeThreads(ClientContext &context) {
+    Value setting_value;
+    if (context.TryGetCurrentSetting("crawler_compute_threads", setting_value) && !setting_value.IsNull() &&
+        setting_value.GetValue<int64_t>() > 0) {
+        return static_cast<idx_t>(setting_value.GetValue<int64_t>());
+    }
+    return static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+}
+
 //===--------------------------------------------------------------------===//
 // HTTP Secret Lookup
 //===--------------------------------------------------------------------===//
@@ -181,6 +236,23 @@ struct CrawlResultEntry {
     string extracted_json;
     int64_t response_time_ms = 0;
     int depth = 1;  // Crawl depth (1 = initial URL)
+    string content_hash;       // XXH3-128 of body (hex), empty for empty bodies
+    string near_duplicate_of;  // Earlier URL with the same or nearly the same content (dedup only)
+    string content_encoding;   // Coding of body_compressed (crawler_store_compressed only)
+    string body_compressed;    // Body exactly as received (crawler_store_compressed only)
+    int64_t content_length = -1;  // Resource size, -1 if unknown (probe only)
+    int64_t transfer_size = -1;   // Body bytes read off the connection, -1 if not fetched
+    string etag;                  // Validators (probe only)
+    string last_modified;
+    PlanResult plan;              // Facets and links computed in the fetch task
+
+    // Bytes that went over the wire
+    idx_t TransferSize() const {
+        if (transfer_size >= 0) {
+            return static_cast<idx_t>(transfer_size);
+        }
+        return body_compressed.empty() ? body.size() : body_compressed.size();
+    }
 };
 
 // Parse batch crawl response from Rust
@@ -241,6 +313,32 @@ static vector<CrawlResultEntry> ParseBatchCrawlResponse(const string &response_j
             entry.response_time_ms = (int64_t)yyjson_get_uint(time_val);
         }
 
+        yyjson_val *length_val = yyjson_obj_get(item, "content_length");
+        if (length_val && yyjson_is_uint(length_val)) {
+            entry.content_length = (int64_t)yyjson_get_uint(length_val);
+        }
+        yyjson_val *transfer_val = yyjson_obj_get(item, "transfer_size");
+        if (transfer_val && yyjson_is_uint(transfer_val)) {
+            entry.transfer_size = (int64_t)yyjson_get_uint(transfer_val);
+        }
+        yyjson_val *etag_val = yyjson_obj_get(item, "etag");
+        if (etag_val && yyjson_is_str(etag_val)) {
+            entry.etag = yyjson_get_str(etag_val);
+        }
+        yyjson_val *last_modified_val = yyjson_obj_get(item, "last_modified");
+        if (last_modified_val && yyjson_is_str(last_modified_val)) {
+            entry.last_modified = yyjson_get_str(last_modified_val);
+        }
+
+        yyjson_val *compressed_val = yyjson_obj_get(item, "compressed_body");
+        if (compressed_val && yyjson_is_str(compressed_val)) {
+            entry.body_compressed = DecodeBase64Body(yyjson_get_str(compressed_val));
+            yyjson_val *encoding_val = yyjson_obj_get(item, "content_encoding");
+            if (encoding_val && yyjson_is_str(encoding_val)) {
+                entry.content_encoding = yyjson_get_str(encoding_val);
+            }
+        }
+
         // Extracted data
         yyjson_val *extracted = yyjson_obj_get(item, "extracted");
         if (extracted && !yyjson_is_null(extracted)) {
@@ -251,6 +349,7 @@ static vector<CrawlResultEntry> ParseBatchCrawlResponse(const string &response_j
                 free(json_str);
             }
         }
+        entry.plan.Read(item);
 
         results.push_back(std::move(entry));
     }
@@ -259,80 +358,6 @@ static vector<CrawlResultEntry> ParseBatchCrawlResponse(const string &response_j
     return results;
 }
 
-//===--------------------------------------------------------------------===//
-// Helper: Combine JSON-LD and Microdata into schema object
-//===--------------------------------------------------------------------===//
-
-static string CombineSchemaData(const string &jsonld, const string &microdata) {
-    // Combine JSON-LD and microdata into a single schema object
-    // Both are JSON objects keyed by @type, with array values
-    yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
-    if (!doc) return "{}";
-
-    yyjson_mut_val *root = yyjson_mut_obj(doc);
-    yyjson_mut_doc_set_root(doc, root);
-
-    // Parse and merge JSON-LD (values are arrays)
-    if (!jsonld.empty() && jsonld != "{}") {
-        yyjson_doc *jld_doc = yyjson_read(jsonld.c_str(), jsonld.size(), 0);
-        if (jld_doc) {
-            yyjson_val *jld_root = yyjson_doc_get_root(jld_doc);
-            if (yyjson_is_obj(jld_root)) {
-                size_t idx, max;
-                yyjson_val *key, *val;
-                yyjson_obj_foreach(jld_root, idx, max, key, val) {
-                    yyjson_mut_val *key_copy = yyjson_val_mut_copy(doc, key);
-                    yyjson_mut_val *val_copy = yyjson_val_mut_copy(doc, val);
-                    yyjson_mut_obj_add(root, key_copy, val_copy);
-                }
-            }
-            yyjson_doc_free(jld_doc);
-        }
-    }
-
-    // Parse and merge microdata (values are arrays, merge with existing)
-    if (!microdata.empty() && microdata != "{}") {
-        yyjson_doc *md_doc = yyjson_read(microdata.c_str(), microdata.size(), 0);
-        if (md_doc) {
-            yyjson_val *md_root = yyjson_doc_get_root(md_doc);
-            if (yyjson_is_obj(md_root)) {
-                size_t idx, max;
-                yyjson_val *key, *val;
-                yyjson_obj_foreach(md_root, idx, max, key, val) {
-                    const char *key_str = yyjson_get_str(key);
-                    yyjson_mut_val *existing = yyjson_mut_obj_get(root, key_str);
-
-                    if (existing && yyjson_mut_is_arr(existing) && yyjson_is_arr(val)) {
-                        // Append microdata items to existing JSON-LD array
-                        size_t arr_idx, arr_max;
-                        yyjson_val *item;
-                        yyjson_arr_foreach(val, arr_idx, arr_max, item) {
-                            yyjson_mut_val *item_copy = yyjson_val_mut_copy(doc, item);
-                            yyjson_mut_arr_append(existing, item_copy);
-                        }
-                    } else if (!existing) {
-                        // Add new type from microdata
-                        yyjson_mut_val *key_copy = yyjson_val_mut_copy(doc, key);
-                        yyjson_mut_val *val_copy = yyjson_val_mut_copy(doc, val);
-                        yyjson_mut_obj_add(root, key_copy, val_copy);
-                    }
-                }
-            }
-            yyjson_doc_free(md_doc);
-        }
-    }
-
-    size_t len = 0;
-    char *json_str = yyjson_mut_write(doc, 0, &len);
-    yyjson_mut_doc_free(doc);
-
-    if (!json_str) return "{}";
-
-    string result(json_str, len);
-    free(json_str);
-    return result;
-}
-
 //===--------------------------------------------------------------------===//
 // Helper: Build html struct value from response
 //===--------------------------------------------------------------------===//
@@ -391,36 +416,18 @@ static Value MakeSchemaMapValue(const string &schema_json) {
     return Value::MAP(LogicalType::VARCHAR, LogicalType::JSON(), keys, values);
 }
 
-static Value BuildHtmlStructValue(const string &body, const string &content_type, const string &url = "") {
+// Facets come from the fetch task or ResolvePageFacets(); pages without them (non-HTML,
+// duplicates) get NULL facets
+static Value BuildHtmlStructValue(const string &body, const PlanResult *facets = nullptr) {
     child_list_t<Value> html_values;
+    html_values.push_back(make_pair("document", body.empty() ? Value() : Value(body)));
 
-    bool is_html = content_type.find("text/html") != string::npos ||
-                   content_type.find("application/xhtml") != string::npos;
-
-    if (is_html && !body.empty()) {
-#if defined(RUST_PARSER_AVAILABLE) && RUST_PARSER_AVAILABLE
-        string js_json = ExtractJsWithRust(body);
-        string og_json = ExtractOpenGraphWithRust(body);
-        string jsonld_json = ExtractJsonLdWithRust(body);
-        string microdata_json = ExtractMicrodataWithRust(body);
-        string schema_json = CombineSchemaData(jsonld_json, microdata_json);
-        string readability_json = ExtractReadabilityWithRust(body, url);
-
-        html_values.push_back(make_pair("document", Value(body)));
-        html_values.push_back(make_pair("js", MakeJsonValue(js_json)));
-        html_values.push_back(make_pair("opengraph", MakeJsonValue(og_json)));
-        html_values.push_back(make_pair("schema", MakeSchemaMapValue(schema_json)));
-        html_values.push_back(make_pair("readability", MakeJsonValue(readability_json)));
-#else
-        html_values.push_back(make_pair("document", Value(body)));
-        html_values.push_back(make_pair("js", Value(LogicalType::JSON())));
-        html_values.push_back(make_pair("opengraph", Value(LogicalType::JSON())));
-        html_values.push_back(make_pair("schema", Value::MAP(LogicalType::VARCHAR, LogicalType::JSON(), vector<Value>(), vector<Value>())));
-        html_values.push_back(make_pair("readability", Value(LogicalType::JSON())));
-#endif
+    if (facets && facets->has_facets) {
+        html_values.push_back(make_pair("js", MakeJsonValue(facets->js_json)));
+        html_values.push_back(make_pair("opengraph", MakeJsonValue(facets->opengraph_json)));
+        html_values.push_back(make_pair("schema", MakeSchemaMapValue(facets->schema_json)));
+        html_values.push_back(make_pair("readability", MakeJsonValue(facets->readability_json)));
     } else {
-        // Non-HTML content or empty body
-        html_values.push_back(make_pair("document", body.empty() ? Value() : Value(body)));
         html_values.push_back(make_pair("js", Value(LogicalType::JSON())));
         html_values.push_back(make_pair("opengraph", Value(LogicalType::JSON())));
         html_values.push_back(make_pair("schema", Value::MAP(LogicalType::VARCHAR, LogicalType::JSON(), vector<Value>(), vector<Value>())));
@@ -445,10 +452,20 @@ struct CrawlBindData : public TableFunctionData {
     int delay_ms = 0;     // Min delay between requests to same domain
     bool respect_robots = false;  // Check robots.txt before fetching
     string follow_selector;  // CSS selector for link following (empty = no following)
+    string extract_specs;    // extract := [...] as a JSON array of specs (empty = none)
+    ExtractionBudget extract_budget;  // crawler_extract_* limits per document
     int max_depth = 1;       // Max crawl depth (1 = initial URLs only)
     bool use_cache = true;   // Enable HTTP response caching
     int cache_ttl_hours = 24;  // Cache TTL in hours
     int64_t max_results = -1;  // Max results to return (-1 = unlimited), for LIMIT pushdown
+    bool dedup = false;        // Skip extraction of exact/near-duplicate pages
+    int dedup_distance = 3;    // Max SimHash bit distance for near duplicates
+    string priority = "fifo";  // Frontier order: 'fifo', 'best_first' or a SQL expression
+    CrawlBudget budget;        // max_duration / max_bytes / max_requests_per_host
+    CompressedStorage store_compressed = CompressedStorage::OFF;  // Raw bodies kept in __crawler_cache
+    bool probe = false;        // Headers only (method := 'HEAD'): no body, cache or extraction
+    bool head_only = false;    // Fetch HTML only up to </head>; truncated bodies are not cached
+    idx_t compute_threads = 0; // Decoding/extraction threads (crawler_compute_threads, else SET threads)
     idx_t reported_cardinality = 0;  // Cardinality we report to optimizer (for LIMIT detection)
     // Proxy settings (from DuckDB http_proxy or CREATE SECRET)
     string http_proxy;
@@ -457,12 +474,6 @@ struct CrawlBindData : public TableFunctionData {
     std::map<string, string> extra_headers;  // From CREATE SECRET extra_http_headers
 };
 
-// URL with depth tracking for link following
-struct UrlWithDepth {
-    string url;
-    int depth;
-};
-
 //===--------------------------------------------------------------------===//
 // Global State
 //===--------------------------------------------------------------------===//
@@ -472,12 +483,17 @@ struct CrawlGlobalState : public GlobalTableFunctionState {
     idx_t result_idx = 0;                      // Index into pending_results
     idx_t next_url_idx = 0;                    // Next URL from initial list
     std::set<string> processed_urls;           // Already crawled (from state table)
-    vector<UrlWithDepth> url_queue;            // URLs to crawl with depth tracking
-    idx_t queue_idx = 0;                       // Next index in url_queue
+    unique_ptr<CrawlFrontier> frontier;        // URLs to crawl, in priority order, with depth tracking
+    std::shared_ptr<CrawlBudgetTracker> budget; // nullptr = unlimited
+    vector<FrontierUrl> unfetched;             // Left over by the budget; saved to __crawler_frontier
+    std::unordered_set<string> resumed_urls;   // Saved frontier rows to drop once fetched
+    unique_ptr<Connection> change_conn;        // crawler_track_changes writes (opened on first use)
     bool initialized = false;
     bool finished = false;
     int64_t results_returned = 0;              // Count of results returned (for max_results)
     int64_t limit_from_query = -1;             // LIMIT value pushed down from query (-1 = unlimited)
+    unique_ptr<CrawlCancelToken> cancel_token; // Cancelled on query interrupt or when the scan is torn down
+    unique_ptr<NearDuplicateIndex> dedup_index; // Fingerprints of pages returned so far (dedup only)
 
     idx_t MaxThreads() const override { return 1; }
 };
@@ -521,88 +537,53 @@ static void SaveToStateTable(Connection &conn, const string &table_name, const C
 }
 
 //===--------------------------------------------------------------------===//
-// HTTP Cache Table Management (__crawler_cache)
+// HTTP Cache (__crawler_cache behind the in-memory ResponseCache)
 //===--------------------------------------------------------------------===//
 
-static constexpr const char* CACHE_TABLE_NAME = "__crawler_cache";
-
-static void EnsureCacheTable(Connection &conn) {
-    string sql = "CREATE TABLE IF NOT EXISTS " + string(CACHE_TABLE_NAME) + " ("
-                 "url VARCHAR PRIMARY KEY, "
-                 "status_code INTEGER, "
-                 "content_type VARCHAR, "
-                 "body VARCHAR, "
-                 "error VARCHAR, "
-                 "response_time_ms BIGINT, "
-                 "cached_at TIMESTAMP DEFAULT current_timestamp)";
-    conn.Query(sql);
+// Cache misses are looked up this many queued URLs at a time
+static constexpr idx_t CACHE_PREFETCH_BATCH = 64;
+
+static CrawlResultEntry FromCachedResponse(CachedResponse &&cached) {
+    CrawlResultEntry entry;
+    entry.url = std::move(cached.url);
+    entry.status_code = cached.status_code;
+    entry.content_type = std::move(cached.content_type);
+    entry.body = std::move(cached.body);
+    entry.error = std::move(cached.error);
+    entry.response_time_ms = cached.response_time_ms;
+    return entry;
 }
 
-// Get cached entries for URLs that are fresher than ttl_hours
-// Uses batch query to avoid N+1 problem
-static vector<CrawlResultEntry> GetCachedEntries(Connection &conn, const vector<string> &urls, int ttl_hours) {
-    vector<CrawlResultEntry> cached;
-    if (urls.empty()) return cached;
-
-    EnsureCacheTable(conn);
-
-    // Build IN clause with properly quoted URLs
-    string url_list;
-    for (size_t i = 0; i < urls.size(); i++) {
-        if (i > 0) url_list += ", ";
-        url_list += EscapeSqlString(urls[i]);
-    }
+static CachedResponse ToCachedResponse(const CrawlResultEntry &entry) {
+    CachedResponse cached;
+    cached.url = entry.url;
+    cached.status_code = entry.status_code;
+    cached.content_type = entry.content_type;
+    cached.body = entry.body;
+    cached.error = entry.error;
+    cached.response_time_ms = entry.response_time_ms;
+    cached.content_encoding = entry.content_encoding;
+    cached.body_compressed = entry.body_compressed;
+    return cached;
+}
 
-    // Single batch query instead of N queries
-    string sql = "SELECT url, status_code, content_type, body, error, response_time_ms "
-                 "FROM " + string(CACHE_TABLE_NAME) + " "
-                 "WHERE url IN (" + url_list + ") "
-                 "AND cached_at > current_timestamp - INTERVAL '" + std::to_string(ttl_hours) + " hours'";
+//===--------------------------------------------------------------------===//
+// Content Fingerprints (exact and near-duplicate detection)
+//===--------------------------------------------------------------------===//
 
-    auto result = conn.Query(sql);
-    if (result->HasError()) {
-        return cached;
-    }
+// Hash the body and, with dedup enabled, look it up among the pages returned so far.
+// Only successful responses take part in near-duplicate detection.
+static void FingerprintResult(CrawlGlobalState &state, CrawlResultEntry &entry) {
+    if (entry.body.empty()) return;
 
-    // Process all results from single query
-    while (true) {
-        auto chunk = result->Fetch();
-        if (!chunk || chunk->size() == 0) break;
-
-        for (idx_t row = 0; row < chunk->size(); row++) {
-            CrawlResultEntry entry;
-            entry.url = chunk->GetValue(0, row).ToString();
-            entry.status_code = chunk->GetValue(1, row).GetValue<int>();
-            entry.content_type = chunk->GetValue(2, row).IsNull() ? "" : chunk->GetValue(2, row).ToString();
-            entry.body = chunk->GetValue(3, row).IsNull() ? "" : chunk->GetValue(3, row).ToString();
-            entry.error = chunk->GetValue(4, row).IsNull() ? "" : chunk->GetValue(4, row).ToString();
-            entry.response_time_ms = chunk->GetValue(5, row).IsNull() ? 0 : chunk->GetValue(5, row).GetValue<int64_t>();
-            cached.push_back(std::move(entry));
-        }
-    }
-    return cached;
-}
+    auto hash = HashContent128(entry.body.data(), entry.body.size());
+    entry.content_hash = hash.ToHex();
 
-// Check which URLs are in cache and fresh
-static std::set<string> GetCachedUrls(Connection &conn, const vector<string> &urls, int ttl_hours) {
-    std::set<string> cached_urls;
-    auto entries = GetCachedEntries(conn, urls, ttl_hours);
-    for (const auto &entry : entries) {
-        cached_urls.insert(entry.url);
-    }
-    return cached_urls;
-}
+    if (!state.dedup_index || entry.status_code < 200 || entry.status_code >= 300) return;
 
-static void SaveToCache(Connection &conn, const CrawlResultEntry &entry) {
-    EnsureCacheTable(conn);
-    string sql = "INSERT OR REPLACE INTO " + string(CACHE_TABLE_NAME) +
-                 " (url, status_code, content_type, body, error, response_time_ms, cached_at) "
-                 "VALUES ($1, $2, $3, $4, $5, $6, current_timestamp)";
-    conn.Query(sql, entry.url, entry.status_code,
-               entry.content_type.empty() ? Value() : Value(entry.content_type),
-               entry.body.empty() ? Value() : Value(entry.body),
-               entry.error.empty() ? Value() : Value(entry.error),
-               entry.response_time_ms);
+    uint64_t simhash = 0;
+    bool has_simhash = SimHashFingerprint(entry.body, simhash);
+    entry.near_duplicate_of = state.dedup_index->FindOrInsert(entry.url, hash, has_simhash, simhash);
 }
 
 //===--------------------------------------------------------------------===//
@@ -627,6 +608,10 @@ static unique_ptr<FunctionData> CrawlBind(ClientContext &context, TableFunctionB
     if (context.TryGetCurrentSetting("crawler_respect_robots", setting_value)) {
         bind_data->respect_robots = setting_value.GetValue<bool>();
     }
+    bind_data->budget = CrawlBudget::FromSettings(context);
+    bind_data->store_compressed = GetCompressedStorage(context);
+    bind_data->compute_threads = GetComputeThreads(context);
+    bind_data->extract_budget = ExtractionBudget::FromSettings(context);
 
     // Read DuckDB's http_proxy settings
     if (context.TryGetCurrentSetting("http_proxy", setting_value) && !setting_value.IsNull()) {
@@ -649,8 +634,13 @@ static unique_ptr<FunctionData> CrawlBind(ClientContext &context, TableFunctionB
             }
         }
     } else {
-        // Single URL string
-        bind_data->urls.push_back(StringValue::Get(first_arg));
+        // Single URL string, or a query yielding URLs (optionally with priority/lastmod columns)
+        string arg = StringValue::Get(first_arg);
+        if (IsUrlQuery(arg)) {
+            bind_data->source_query = arg;
+        } else {
+            bind_data->urls.push_back(arg);
+        }
     }
 
     // Named parameters
@@ -680,9 +670,69 @@ static unique_ptr<FunctionData> CrawlBind(ClientContext &context, TableFunctionB
             bind_data->cache_ttl_hours = kv.second.GetValue<int>();
         } else if (kv.first == "max_results") {
             bind_data->max_results = kv.second.GetValue<int64_t>();
+        } else if (kv.first == "dedup") {
+            bind_data->dedup = kv.second.GetValue<bool>();
+        } else if (kv.first == "dedup_distance") {
+            bind_data->dedup_distance = kv.second.GetValue<int>();
+            if (bind_data->dedup_distance < 0 || bind_data->dedup_distance > NearDuplicateIndex::MAX_DISTANCE) {
+                throw BinderException("crawl(): dedup_distance must be between 0 and %d",
+                                      NearDuplicateIndex::MAX_DISTANCE);
+            }
+        } else if (kv.first == "priority" && !kv.second.IsNull()) {
+            bind_data->priority = StringValue::Get(kv.second);
+            CrawlFrontier::ValidateOrder(context, bind_data->priority);
+        } else if (kv.first == "method") {
+            auto method = StringUtil::Upper(StringValue::Get(kv.second));
+            if (method != "GET" && method != "HEAD") {
+                throw BinderException("crawl(): method must be 'GET' or 'HEAD'");
+            }
+            bind_data->probe = method == "HEAD";
+        } else if (kv.first == "probe") {
+            bind_data->probe = kv.second.GetValue<bool>();
+        } else if (kv.first == "head_only") {
+            bind_data->head_only = kv.second.GetValue<bool>();
+        } else if (kv.first == "extract" && !kv.second.IsNull()) {
+            vector<string> entries;
+            for (auto &entry : ListValue::GetChildren(kv.second)) {
+                if (!entry.IsNull()) {
+                    entries.push_back(StringValue::Get(entry));
+                }
+            }
+            bind_data->extract_specs = ParseExtractSpecs(entries, "crawl");
+        } else {
+            bind_data->budget.ApplyParameter("crawl", kv.first, kv.second);
         }
     }
 
+    // Head-only bodies stop before the page content, so links and text are missing
+    if (bind_data->head_only) {
+        if (!bind_data->follow_selector.empty()) {
+            throw BinderException("crawl(): follow needs page bodies and cannot be combined with head_only");
+        }
+        if (bind_data->dedup) {
+            throw BinderException("crawl(): dedup needs page bodies and cannot be combined with head_only");
+        }
+        if (bind_data->probe) {
+            throw BinderException("crawl(): head_only cannot be combined with a HEAD probe");
+        }
+    }
+
+    // Probe mode: headers only, so there are no bodies to follow links in or compare
+    if (bind_data->probe) {
+        if (!bind_data->follow_selector.empty()) {
+            throw BinderException("crawl(): follow needs page bodies and cannot be combined with a HEAD probe");
+        }
+        if (bind_data->dedup) {
+            throw BinderException("crawl(): dedup needs page bodies and cannot be combined with a HEAD probe");
+        }
+        return_types = {LogicalType::VARCHAR, LogicalType::INTEGER, LogicalType::VARCHAR, LogicalType::BIGINT,
+                        LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BIGINT,
+                        LogicalType::INTEGER};
+        names = {"url", "status", "content_type", "content_length", "etag", "last_modified", "error",
+                 "response_time_ms", "depth"};
+        return std::move(bind_data);
+    }
+
     // Return columns
     return_types.push_back(LogicalType::VARCHAR);  // url
     return_types.push_back(LogicalType::INTEGER);  // status
@@ -702,6 +752,8 @@ static unique_ptr<FunctionData> CrawlBind(ClientContext &context, TableFunctionB
     return_types.push_back(LogicalType::VARCHAR);  // extract
     return_types.push_back(LogicalType::BIGINT);   // response_time_ms
     return_types.push_back(LogicalType::INTEGER);  // depth
+    return_types.push_back(LogicalType::VARCHAR);  // content_hash
+    return_types.push_back(LogicalType::VARCHAR);  // near_duplicate_of
 
     names.push_back("url");
     names.push_back("status");
@@ -711,6 +763,8 @@ static unique_ptr<FunctionData> CrawlBind(ClientContext &context, TableFunctionB
     names.push_back("extract");
     names.push_back("response_time_ms");
     names.push_back("depth");
+    names.push_back("content_hash");
+    names.push_back("near_duplicate_of");
 
     return std::move(bind_data);
 }
@@ -734,6 +788,13 @@ static unique_ptr<NodeStatistics> CrawlCardinality(ClientContext &context, const
 static unique_ptr<GlobalTableFunctionState> CrawlInitGlobal(ClientContext &context,
                                                              TableFunctionInitInput &input) {
     auto state = make_uniq<CrawlGlobalState>();
+    state->cancel_token = make_uniq<CrawlCancelToken>(&context.interrupted);
+
+    auto &bind_data = input.bind_data->Cast<CrawlBindData>();
+    if (bind_data.dedup) {
+        state->dedup_index = make_uniq<NearDuplicateIndex>(bind_data.dedup_distance);
+    }
+    state->budget = ResolveBudgetTracker(context, bind_data.budget);
 
     // LIMIT pushdown: compare estimated_cardinality with our reported cardinality
     // If estimated < reported, LIMIT was applied by the optimizer
@@ -761,32 +822,62 @@ static void CrawlFunction(ClientContext &context, TableFunctionInput &data, Data
         state.initialized = true;
 
         Connection conn(*context.db);
+        state.frontier = make_uniq<CrawlFrontier>(context, bind_data.priority);
+
+        // Initial URLs at depth 1
+        for (const auto &url : bind_data.urls) {
+            FrontierUrl seed;
+            seed.url = url;
+            state.frontier->Push(std::move(seed));
+        }
 
-        // Execute source query if provided
+        // Execute source query if provided; sitemap() style priority/lastmod columns feed the frontier
         if (!bind_data.source_query.empty()) {
             auto query_result = conn.Query(bind_data.source_query);
             if (query_result->HasError()) {
                 throw IOException("crawl source query error: " + query_result->GetError());
             }
+            optional_idx priority_col, lastmod_col;
+            for (idx_t col = 1; col < query_result->names.size(); col++) {
+                auto name = StringUtil::Lower(query_result->names[col]);
+                if (name == "priority") {
+                    priority_col = col;
+                } else if (name == "lastmod") {
+                    lastmod_col = col;
+                }
+            }
             while (auto chunk = query_result->Fetch()) {
                 for (idx_t i = 0; i < chunk->size(); i++) {
                     auto val = chunk->GetValue(0, i);
-                    if (!val.IsNull()) {
-                        bind_data.urls.push_back(val.ToString());
+                    if (val.IsNull()) {
+                        continue;
+                    }
+                    FrontierUrl seed;
+                    seed.url = val.ToString();
+                    if (priority_col.IsValid()) {
+                        Value priority;
+                        if (chunk->GetValue(priority_col.GetIndex(), i).TryCastAs(context, LogicalType::DOUBLE, priority)) {
+                            seed.sitemap_priority = priority;
+                        }
+                    }
+                    if (lastmod_col.IsValid()) {
+                        seed.lastmod_age_days = LastmodAgeDays(context, chunk->GetValue(lastmod_col.GetIndex(), i));
                     }
+                    state.frontier->Push(std::move(seed));
                 }
             }
         }
 
-        // Load processed URLs from state table
+        // Load processed URLs from state table, and resume the frontier an earlier run
+        // left behind when its budget ran out. Saved rows are dropped one by one as they
+        // are returned, so a run cut short by LIMIT or max_results keeps the rest
         if (!bind_data.state_table.empty()) {
             EnsureStateTable(conn, bind_data.state_table);
             state.processed_urls = LoadProcessedUrls(conn, bind_data.state_table);
-        }
-
-        // Initialize URL queue with initial URLs at depth 1
-        for (const auto &url : bind_data.urls) {
-            state.url_queue.push_back({url, 1});
+            for (auto &saved : LoadSavedFrontier(conn, bind_data.state_table)) {
+                state.resumed_urls.insert(saved.url);
+                state.frontier->Push(std::move(saved));
+            }
         }
     }
 
@@ -803,8 +894,8 @@ static void CrawlFunction(ClientContext &context, TableFunctionInput &data, Data
     // For LIMIT pushdown: yield ONE row at a time, then return to let executor decide
     // This allows LIMIT to take effect between HTTP requests
     while (count < 1) {  // Changed from STANDARD_VECTOR_SIZE to 1 for streaming
-        // Check for interrupt (Ctrl+C)
-        if (IsInterrupted()) {
+        // Check for interrupt of this query (Ctrl+C, client cancel)
+        if (state.cancel_token->IsCancelled()) {
             state.finished = true;
             break;
         }
@@ -822,15 +913,42 @@ static void CrawlFunction(ClientContext &context, TableFunctionInput &data, Data
         // If we have pending results, yield ONE
         if (state.result_idx < state.pending_results.size()) {
             auto &entry = state.pending_results[state.result_idx++];
+            bool is_duplicate = !entry.near_duplicate_of.empty();
+
+            if (bind_data.probe) {
+                output.SetValue(0, count, Value(entry.url));
+                output.SetValue(1, count, Value(entry.status_code));
+                output.SetValue(2, count, entry.content_type.empty() ? Value() : Value(entry.content_type));
+                output.SetValue(3, count, entry.content_length < 0 ? Value() : Value::BIGINT(entry.content_length));
+                output.SetValue(4, count, entry.etag.empty() ? Value() : Value(entry.etag));
+                output.SetValue(5, count, entry.last_modified.empty() ? Value() : Value(entry.last_modified));
+                output.SetValue(6, count, entry.error.empty() ? Value() : Value(entry.error));
+                output.SetValue(7, count, Value::BIGINT(entry.response_time_ms));
+                output.SetValue(8, count, Value::INTEGER(entry.depth));
+                count++;
+                state.results_returned++;
+                state.processed_urls.insert(entry.url);
+                if (conn) {
+                    SaveToStateTable(*conn, bind_data.state_table, entry);
+                    if (state.resumed_urls.erase(entry.url)) {
+                        ForgetSavedFrontierUrl(*conn, bind_data.state_table, entry.url);
+                    }
+                }
+                break;
+            }
 
             output.SetValue(0, count, Value(entry.url));
             output.SetValue(1, count, Value(entry.status_code));
             output.SetValue(2, count, Value(entry.content_type));
-            output.SetValue(3, count, BuildHtmlStructValue(entry.body, entry.content_type, entry.url));
+            // Duplicates skip the (expensive) structured extraction
+            output.SetValue(3, count, is_duplicate ? BuildHtmlStructValue("")
+                                                   : BuildHtmlStructValue(entry.body, &entry.plan));
             output.SetValue(4, count, entry.error.empty() ? Value() : Value(entry.error));
-            output.SetValue(5, count, entry.extracted_json.empty() ? Value() : Value(entry.extracted_json));
+            output.SetValue(5, count, entry.extracted_json.empty() || is_duplicate ? Value() : Value(entry.extracted_json));
             output.SetValue(6, count, Value::BIGINT(entry.response_time_ms));
             output.SetValue(7, count, Value::INTEGER(entry.depth));
+            output.SetValue(8, count, entry.content_hash.empty() ? Value() : Value(entry.content_hash));
+            output.SetValue(9, count, is_duplicate ? Value(entry.near_duplicate_of) : Value());
             count++;
             state.results_returned++;  // Track for max_results limit
 
@@ -842,16 +960,25 @@ static void CrawlFunction(ClientContext &context, TableFunctionInput &data, Data
                 entry.depth < bind_data.max_depth &&
                 entry.status_code >= 200 && entry.status_code < 300 &&
                 !entry.body.empty()) {
-                auto links = ExtractLinksWithRust(entry.body, bind_data.follow_selector, entry.url);
+                auto links = entry.plan.has_links
+                                 ? std::move(entry.plan.links)
+                                 : ExtractLinksWithRust(entry.body, bind_data.follow_selector, entry.url);
                 for (const auto &link : links) {
                     // Only add if not already processed (don't add to processed_urls yet)
                     if (state.processed_urls.count(link) == 0) {
-                        state.url_queue.push_back({link, entry.depth + 1});
+                        FrontierUrl next;
+                        next.url = link;
+                        next.depth = entry.depth + 1;
+                        next.inlinks = 1;
+                        state.frontier->Push(std::move(next));
                     }
                 }
             }
             if (conn) {
                 SaveToStateTable(*conn, bind_data.state_table, entry);
+                if (state.resumed_urls.erase(entry.url)) {
+                    ForgetSavedFrontierUrl(*conn, bind_data.state_table, entry.url);
+                }
             }
             break;  // Return after ONE row to allow LIMIT to interrupt
         }
@@ -860,17 +987,30 @@ static void CrawlFunction(ClientContext &context, TableFunctionInput &data, Data
         state.pending_results.clear();
         state.result_idx = 0;
 
-        // Get next single URL from queue (skip already processed)
+        // Budget spent: dispatch nothing new and keep the frontier for the next run
+        if (state.budget && state.budget->Exhausted()) {
+            state.frontier->Drain(state.unfetched);
+            state.finished = true;
+            break;
+        }
+
+        // Get next single URL from the frontier (skip already processed)
         string url_to_fetch;
         int url_depth = 1;
-        while (state.queue_idx < state.url_queue.size()) {
-            auto &item = state.url_queue[state.queue_idx++];
+        bool cache_prefetched = false;
+        FrontierUrl item;
+        while (state.frontier->Pop(item)) {
             // Skip if already processed (handles duplicates and resumption from state table)
             if (state.processed_urls.count(item.url) == 0) {
                 url_to_fetch = item.url;
                 url_depth = item.depth;
+                cache_prefetched = item.cache_prefetched;
                 break;
             }
+            // A saved URL another run has fetched since: drop it rather than reload it forever
+            if (conn && state.resumed_urls.erase(item.url)) {
+                ForgetSavedFrontierUrl(*conn, bind_data.state_table, item.url);
+            }
         }
 
         // No more URLs to fetch
@@ -879,21 +1019,45 @@ static void CrawlFunction(ClientContext &context, TableFunctionInput &data, Data
             break;
         }
 
-        Connection cache_conn(*context.db);
-
         // Check cache first
         CrawlResultEntry result;
         bool from_cache = false;
+        shared_ptr<ResponseCache> cache;
+
+        // Probes never read or write the cache: it holds full responses
+        if (bind_data.use_cache && !bind_data.probe) {
+            cache = ResponseCache::Get(context);
+
+            // Misses are loaded for a window of upcoming frontier URLs in one query;
+            // inside the window, lookups are served from memory only
+            if (!cache_prefetched) {
+                vector<string> window {url_to_fetch};
+                for (auto &url : state.frontier->TakePrefetchWindow(CACHE_PREFETCH_BATCH - 1)) {
+                    window.push_back(std::move(url));
+                }
+                cache->Prefetch(*context.db, window, bind_data.cache_ttl_hours);
+            }
 
-        if (bind_data.use_cache) {
-            auto cached = GetCachedEntries(cache_conn, {url_to_fetch}, bind_data.cache_ttl_hours);
+            auto cached = cache->Lookup(*context.db, {url_to_fetch}, bind_data.cache_ttl_hours, true);
             if (!cached.empty()) {
-                result = std::move(cached[0]);
+                result = FromCachedResponse(std::move(cached[0]));
                 result.depth = url_depth;
+                FingerprintResult(state, result);
+                if (result.near_duplicate_of.empty()) {
+                    result.extracted_json = EvaluateExtractSpecs(result.body, bind_data.extract_specs, bind_data.extract_budget);
+                    ResolvePageFacets(context, result.body, result.content_type, result.content_hash, result.url,
+                                      true, result.plan);
+                }
                 from_cache = true;
             }
         }
 
+        // Host out of requests: defer the URL to the next run
+        if (!from_cache && state.budget && !state.budget->TryAcquireHost(url_to_fetch)) {
+            state.unfetched.push_back(std::move(item));
+            continue;
+        }
+
         // Fetch if not cached
         if (!from_cache) {
             // Apply HTTP secrets for this specific URL (may override global settings)
@@ -903,9 +1067,38 @@ static void CrawlFunction(ClientContext &context, TableFunctionInput &data, Data
             std::map<string, string> extra_headers = bind_data.extra_headers;
             ApplyHttpSecrets(context, url_to_fetch, http_proxy, http_proxy_username, http_proxy_password, extra_headers);
 
+            // With a proxy pool (crawler_proxy_pool or an http_proxy list) the proxy is picked per request
+            unique_ptr<ProxyLease> proxy_lease;
+            if (auto proxy_pool = ProxyPool::Resolve(context, http_proxy, http_proxy_username, http_proxy_password)) {
+                proxy_lease = proxy_pool->Acquire(url_to_fetch, state.cancel_token.get());
+                if (!proxy_lease) {
+                    // Empty pool or cancelled: fail the request rather than fall back to
+                    // the raw proxy list or a direct fetch
+                    result.url = url_to_fetch;
+                    result.depth = url_depth;
+                    result.error = "No proxy available in the proxy pool";
+                    state.pending_results.push_back(std::move(result));
+                    continue;
+                }
+                http_proxy = proxy_lease->Endpoint().url;
+                http_proxy_username = proxy_lease->Endpoint().username;
+                http_proxy_password = proxy_lease->Endpoint().password;
+            }
+
+            // The fetch task parses the page once for specs, facets and links. With dedup
+            // the facets wait until the page is known to be unique.
+            ExtractionPlan plan;
+            if (!bind_data.probe) {
+                plan.specs_json = bind_data.extract_specs;
+                plan.facets = !bind_data.dedup;
+                plan.follow = !bind_data.follow_selector.empty() && url_depth < bind_data.max_depth;
+                plan.follow_selector = bind_data.follow_selector;
+                plan.budget = bind_data.extract_budget;
+            }
+
             string request_json = BuildBatchCrawlRequest(
                 {url_to_fetch},
-                "{}",  // No extraction specs
+                plan.ToJson(),
                 bind_data.user_agent,
                 bind_data.timeout_ms,
                 1,  // Single URL, single concurrency
@@ -914,18 +1107,54 @@ static void CrawlFunction(ClientContext &context, TableFunctionInput &data, Data
                 http_proxy,
                 http_proxy_username,
                 http_proxy_password,
-                extra_headers
+                extra_headers,
+                // Raw bodies are only worth fetching when the cache keeps them; head-only
+                // bodies are never cached
+                cache && !bind_data.head_only ? bind_data.store_compressed : CompressedStorage::OFF,
+                bind_data.probe,
+                bind_data.head_only,
+                bind_data.compute_threads
             );
 
-            string response_json = CrawlBatchWithRust(request_json);
+            string response_json = CrawlBatchWithRust(request_json, *state.cancel_token);
             auto fetched = ParseBatchCrawlResponse(response_json);
 
             if (!fetched.empty()) {
                 result = std::move(fetched[0]);
                 result.depth = url_depth;
+                if (proxy_lease) {
+                    proxy_lease->Complete(result.response_time_ms, result.status_code);
+                }
+                if (state.budget) {
+                    state.budget->AddBytes(static_cast<int64_t>(result.TransferSize()));
+                }
+                if (bind_data.probe) {
+                    state.pending_results.push_back(std::move(result));
+                    continue;
+                }
+                FingerprintResult(state, result);
+
+                // Facets extracted in the fetch task are remembered for later hits of the
+                // content; with dedup, unique pages are extracted (or found) here
+                if (result.near_duplicate_of.empty()) {
+                    if (result.plan.has_facets) {
+                        RememberPageFacets(context, result.content_hash, result.url, result.plan, cache != nullptr);
+                    } else {
+                        ResolvePageFacets(context, result.body, result.content_type, result.content_hash, result.url,
+                                          cache != nullptr, result.plan);
+                    }
+                }
 
-                if (bind_data.use_cache) {
-                    SaveToCache(cache_conn, result);
+                // Duplicates are stored too, so reruns serve them from the cache. Head-only
+                // bodies are truncated and would poison full crawls of the URL.
+                if (!bind_data.head_only) {
+                    if (cache) {
+                        cache->Save(*context.db, ToCachedResponse(result), CacheAutoVacuum::FromSettings(context));
+                    }
+                    MaybeRecordBodyVersion(context, url_to_fetch, result.status_code, result.body,
+                                           result.content_hash);
+                    MaybeRecordChangeObservation(context, state.change_conn, url_to_fetch, result.status_code,
+                                                 result.content_hash);
                 }
             }
         }
@@ -934,152 +1163,15 @@ static void CrawlFunction(ClientContext &context, TableFunctionInput &data, Data
         state.pending_results.push_back(std::move(result));
     }
 
-    output.SetCardinality(count);
-}
-
-//===--------------------------------------------------------------------===//
-// LATERAL Join Support (In-Out Function)
-//===--------------------------------------------------------------------===//
-
-struct CrawlLateralLocalState : public LocalTableFunctionState {
-    // No state needed - each row is independent
-};
-
-static unique_ptr<LocalTableFunctionState> CrawlLateralInitLocal(ExecutionContext &context,
-                                                                   TableFunctionInitInput &input,
-                                                                   GlobalTableFunctionState *global_state) {
-    return make_uniq<CrawlLateralLocalState>();
-}
-
-static OperatorResultType CrawlInOut(ExecutionContext &context, TableFunctionInput &data,
-                                      DataChunk &input, DataChunk &output) {
-    auto &bind_data = data.bind_data->CastNoConst<CrawlBindData>();
-
-    if (input.size() == 0) {
-        return OperatorResultType::NEED_MORE_INPUT;
-    }
-
-    idx_t count = 0;
-
-    for (idx_t i = 0; i < input.size() && count < STANDARD_VECTOR_SIZE; i++) {
-        Value url_val = input.GetValue(0, i);
-
-        if (url_val.IsNull()) {
-            output.SetValue(0, count, Value());
-            output.SetValue(1, count, Value());
-            output.SetValue(2, count, Value());
-            output.SetValue(3, count, BuildHtmlStructValue("", ""));
-            output.SetValue(4, count, Value("NULL URL"));
-            output.SetValue(5, count, Value());
-            output.SetValue(6, count, Value());
-            count++;
-            continue;
-        }
-
-        string url = StringValue::Get(url_val);
-        if (url.empty()) continue;
-
-        // Build minimal batch request for single URL
-        yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
-        yyjson_mut_val *root = yyjson_mut_obj(doc);
-        yyjson_mut_doc_set_root(doc, root);
-
-        yyjson_mut_val *urls_arr = yyjson_mut_arr(doc);
-        yyjson_mut_arr_add_strcpy(doc, urls_arr, url.c_str());
-        yyjson_mut_obj_add_val(doc, root, "urls", urls_arr);
-
-        yyjson_mut_obj_add_strcpy(doc, root, "user_agent", bind_data.user_agent.c_str());
-        yyjson_mut_obj_add_uint(doc, root, "timeout_ms", bind_data.timeout_ms);
-        yyjson_mut_obj_add_uint(doc, root, "concurrency", 1);
-
-        size_t len = 0;
-        char *json_str = yyjson_mut_write(doc, 0, &len);
-        yyjson_mut_doc_free(doc);
-
-        if (!json_str) {
-            output.SetValue(0, count, Value(url));
-            output.SetValue(1, count, Value());
-            output.SetValue(2, count, Value());
-            output.SetValue(3, count, BuildHtmlStructValue("", ""));
-            output.SetValue(4, count, Value("Failed to serialize request"));
-            output.SetValue(5, count, Value());
-            output.SetValue(6, count, Value());
-            count++;
-            continue;
-        }
-
-        string request_json(json_str, len);
-        free(json_str);
-
-        string response_json = CrawlBatchWithRust(request_json);
-
-        // Parse response
-        yyjson_doc *resp_doc = yyjson_read(response_json.c_str(), response_json.size(), 0);
-        if (!resp_doc) {
-            output.SetValue(0, count, Value(url));
-            output.SetValue(1, count, Value());
-            output.SetValue(2, count, Value());
-            output.SetValue(3, count, BuildHtmlStructValue("", ""));
-            output.SetValue(4, count, Value("Failed to parse response"));
-            output.SetValue(5, count, Value());
-            output.SetValue(6, count, Value());
-            count++;
-            continue;
-        }
-
-        yyjson_val *resp_root = yyjson_doc_get_root(resp_doc);
-        yyjson_val *results_arr = yyjson_obj_get(resp_root, "results");
-
-        if (results_arr && yyjson_is_arr(results_arr) && yyjson_arr_size(results_arr) > 0) {
-            yyjson_val *item = yyjson_arr_get_first(results_arr);
-
-            yyjson_val *url_val_json = yyjson_obj_get(item, "url");
-            yyjson_val *status_val = yyjson_obj_get(item, "status");
-            yyjson_val *content_type_val = yyjson_obj_get(item, "content_type");
-            yyjson_val *body_val = yyjson_obj_get(item, "body");
-            yyjson_val *error_val = yyjson_obj_get(item, "error");
-            yyjson_val *extracted_val = yyjson_obj_get(item, "extracted");
-            yyjson_val *time_val = yyjson_obj_get(item, "response_time_ms");
-
-            string result_url = url_val_json ? yyjson_get_str(url_val_json) : url;
-            int status = status_val ? yyjson_get_int(status_val) : 0;
-            string content_type = content_type_val ? yyjson_get_str(content_type_val) : "";
-            string body = body_val ? yyjson_get_str(body_val) : "";
-            string error = error_val ? yyjson_get_str(error_val) : "";
-            int64_t response_time = time_val ? yyjson_get_int(time_val) : 0;
-
-            string extracted_json;
-            if (extracted_val) {
-                char *ext_str = yyjson_val_write(extracted_val, 0, nullptr);
-                if (ext_str) {
-                    extracted_json = ext_str;
-                    free(ext_str);
-                }
-            }
-
-            output.SetValue(0, count, Value(result_url));
-            output.SetValue(1, count, Value(status));
-            output.SetValue(2, count, Value(content_type));
-            output.SetValue(3, count, BuildHtmlStructValue(body, content_type, result_url));
-            output.SetValue(4, count, error.empty() ? Value() : Value(error));
-            output.SetValue(5, count, extracted_json.empty() ? Value() : Value(extracted_json));
-            output.SetValue(6, count, Value::BIGINT(response_time));
-        } else {
-            output.SetValue(0, count, Value(url));
-            output.SetValue(1, count, Value());
-            output.SetValue(2, count, Value());
-            output.SetValue(3, count, BuildHtmlStructValue("", "", url));
-            output.SetValue(4, count, Value("No results"));
-            output.SetValue(5, count, Value());
-            output.SetValue(6, count, Value());
-        }
-
-        yyjson_doc_free(resp_doc);
-        count++;
+    // Everything dispatched has been returned; persist what the budget left over.
+    // Without a state_table there is no crawl_id to resume it under
+    if (state.finished && !state.unfetched.empty() && !bind_data.state_table.empty()) {
+        Connection frontier_conn(*context.db);
+        SaveFrontier(frontier_conn, bind_data.state_table, state.unfetched);
+        state.unfetched.clear();
     }
 
     output.SetCardinality(count);
-    return OperatorResultType::NEED_MORE_INPUT;
 }
 
 //===--------------------------------------------------------------------===//
@@ -1102,6 +1194,15 @@ void RegisterCrawlTableFunction(ExtensionLoader &loader) {
         func.named_parameters["cache"] = LogicalType::BOOLEAN;
         func.named_parameters["cache_ttl"] = LogicalType::INTEGER;
         func.named_parameters["max_results"] = LogicalType::BIGINT;
+        func.named_parameters["dedup"] = LogicalType::BOOLEAN;
+        func.named_parameters["dedup_distance"] = LogicalType::INTEGER;
+        func.named_parameters["priority"] = LogicalType::VARCHAR;
+        func.named_parameters["max_duration"] = LogicalType::INTERVAL;
+        func.named_parameters["max_bytes"] = LogicalType::BIGINT;
+        func.named_parameters["max_requests_per_host"] = LogicalType::BIGINT;
+        func.named_parameters["method"] = LogicalType::VARCHAR;
+        func.named_parameters["probe"] = LogicalType::BOOLEAN;
+        func.named_parameters["head_only"] = LogicalType::BOOLEAN;
     };
 
     // crawl() with URL list (batch mode)
@@ -8,6 +8,12 @@
 #include "stream_merge_function.hpp"
 #include "sitemap_function.hpp"
 #include "importhtml_function.hpp"
+#include "crawl_queue_function.hpp"
+#include "cache_vacuum_function.hpp"
+#include "body_versions_function.hpp"
+#include "crawl_due_function.hpp"
+#include "decompress_function.hpp"
+#include "proxy_stats_function.hpp"
 #include "rust_ffi.hpp"
 #include "duckdb.hpp"
 #include "duckdb/common/exception.hpp"
@@ -15,27 +21,10 @@
 #include "duckdb/main/extension_helper.hpp"
 #include "duckdb/main/config.hpp"
 #include "duckdb/parser/parser_extension.hpp"
-#include <csignal>
 #include <atomic>
 
 namespace duckdb {
 
-// Store previous signal handler to restore on unload
-static std::sig_atomic_t g_signal_handler_installed = 0;
-static void (*g_previous_sigint_handler)(int) = SIG_DFL;
-
-// Signal handler for graceful shutdown
-static void CrawlerSignalHandler(int signum) {
-	if (signum == SIGINT) {
-		// Set the interrupt flag in Rust
-		SetInterrupted(true);
-		// Call previous handler if it was set
-		if (g_previous_sigint_handler != SIG_DFL && g_previous_sigint_handler != SIG_IGN) {
-			g_previous_sigint_handler(signum);
-		}
-	}
-}
-
 static void LoadInternal(ExtensionLoader &loader) {
 	auto &db = loader.GetDatabaseInstance();
 	auto &config = DBConfig::GetConfig(db);
@@ -73,6 +62,104 @@ static void LoadInternal(ExtensionLoader &loader) {
 	                          LogicalType::BIGINT,
 	                          Value::BIGINT(10485760)); // 10MB default
 
+	// Register crawler_cache_memory_bytes setting
+	config.AddExtensionOption("crawler_cache_memory_bytes",
+	                          "Memory budget of the in-memory tier in front of __crawler_cache (0 = disabled)",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(67108864)); // 64MB default
+
+	// Register crawler_facet_cache_memory_bytes setting
+	config.AddExtensionOption("crawler_facet_cache_memory_bytes",
+	                          "Memory budget of the extracted html facet cache keyed by content hash (0 = disabled)",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(33554432)); // 32MB default
+
+	// Register __crawler_cache maintenance settings
+	config.AddExtensionOption("crawler_cache_max_age_hours",
+	                          "Rows of __crawler_cache older than this are deleted by crawler_cache_vacuum() (0 = keep)",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(168)); // 1 week
+	config.AddExtensionOption("crawler_cache_max_bytes",
+	                          "Size budget of __crawler_cache; oldest rows are evicted beyond it (0 = unlimited)",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(0));
+	config.AddExtensionOption("crawler_cache_auto_vacuum",
+	                          "Vacuum __crawler_cache automatically every 1000 cache writes",
+	                          LogicalType::BOOLEAN,
+	                          Value::BOOLEAN(false));
+	config.AddExtensionOption("crawler_store_compressed",
+	                          "Keep compressed response bytes in __crawler_cache: 'off', 'alongside' or 'only'",
+	                          LogicalType::VARCHAR,
+	                          Value("off"));
+
+	// Register body version history settings
+	config.AddExtensionOption("crawler_body_versions",
+	                          "Keep delta-encoded versions of fetched bodies in __crawler_versions",
+	                          LogicalType::BOOLEAN,
+	                          Value::BOOLEAN(false));
+	config.AddExtensionOption("crawler_version_keyframe_interval",
+	                          "Store a full body at least every N versions of a URL",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(16));
+
+	// Register recrawl scheduler settings
+	config.AddExtensionOption("crawler_track_changes",
+	                          "Learn per-URL change rates from content hashes for crawl_due()",
+	                          LogicalType::BOOLEAN,
+	                          Value::BOOLEAN(false));
+	config.AddExtensionOption("crawler_recrawl_min_hours",
+	                          "Shortest recrawl interval crawl_due() schedules",
+	                          LogicalType::DOUBLE,
+	                          Value::DOUBLE(1.0));
+	config.AddExtensionOption("crawler_recrawl_max_hours",
+	                          "Longest recrawl interval crawl_due() schedules",
+	                          LogicalType::DOUBLE,
+	                          Value::DOUBLE(720.0)); // 30 days
+
+	// Register crawl budget settings (0 = unlimited)
+	config.AddExtensionOption("crawler_max_duration",
+	                          "Stop dispatching new requests after this long (crawl functions, CRAWLING MERGE)",
+	                          LogicalType::INTERVAL,
+	                          Value::INTERVAL(0, 0, 0));
+	config.AddExtensionOption("crawler_max_bytes",
+	                          "Stop dispatching new requests after this many response bytes",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(0));
+	config.AddExtensionOption("crawler_max_requests_per_host",
+	                          "Maximum requests per host in one crawl",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(0));
+
+	// Register compute pool setting (0 = DuckDB's thread count)
+	config.AddExtensionOption("crawler_compute_threads",
+	                          "Threads for decoding and extraction of fetched pages (0 = SET threads)",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(0));
+
+	// Register per-document extraction budgets (0 = unlimited)
+	config.AddExtensionOption("crawler_extract_max_dom_nodes",
+	                          "Documents with more DOM nodes skip microdata and readability extraction (0 = unlimited)",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(1000000));
+	config.AddExtensionOption("crawler_extract_max_script_bytes",
+	                          "Inline script bytes parsed per document for html.js (0 = unlimited)",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(8388608)); // 8MB default
+	config.AddExtensionOption("crawler_extract_max_table_cells",
+	                          "Cells extracted per read_html() table (0 = unlimited)",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(1000000));
+	config.AddExtensionOption("crawler_extract_max_facet_ms",
+	                          "Wall-clock time per extracted facet in milliseconds (0 = unlimited)",
+	                          LogicalType::BIGINT,
+	                          Value::BIGINT(5000));
+
+	// Register proxy pool setting (table of egress proxies; empty = off)
+	config.AddExtensionOption("crawler_proxy_pool",
+	                          "Table of proxies (proxy, username, password, weight, max_concurrency) to rotate requests through",
+	                          LogicalType::VARCHAR,
+	                          Value(""));
+
 	// Register $() scalar function for CSS extraction
 	RegisterCssExtractFunction(loader);
 
@@ -91,16 +178,29 @@ static void LoadInternal(ExtensionLoader &loader) {
 	// Register read_html() table function for extracting HTML tables
 	RegisterReadHtmlFunction(loader);
 
+	// Register crawl_queue_*() work queue functions for multi-process crawls
+	RegisterCrawlQueueFunctions(loader);
+
+	// Register crawler_cache_vacuum() for __crawler_cache maintenance
+	RegisterCacheVacuumFunction(loader);
+
+	// Register crawl_body_versions() for reading delta-encoded body history
+	RegisterBodyVersionsFunction(loader);
+
+	// Register crawl_due() change-rate-aware recrawl source
+	RegisterCrawlDueFunction(loader);
+
+	// Register crawl_decompress() for bodies stored compressed
+	RegisterDecompressFunction(loader);
+
+	// Register crawler_proxy_stats() for proxy pool health
+	RegisterProxyStatsFunction(loader);
+
 	// Register stream_merge_internal() for STREAM INTO ... USING ... ON (merge) syntax
 	RegisterCrawlingMergeFunction(loader);
 
-	// Install signal handler for graceful shutdown (only once)
-	if (!g_signal_handler_installed) {
-		g_previous_sigint_handler = std::signal(SIGINT, CrawlerSignalHandler);
-		g_signal_handler_installed = 1;
-		// Reset interrupt flag
-		SetInterrupted(false);
-	}
+	// Crawls are cancelled per query through CrawlCancelToken, which follows the
+	// client's interrupt flag; no process-wide SIGINT handler is installed.
 
 	// Register CRAWL and STREAM parser extension
 	ParserExtension parser_ext;
@@ -1,4 +1,5 @@
 #include "crawler_utils.hpp"
+#include "content_fingerprint.hpp"
 #include <zlib.h>
 #include <algorithm>
 #include <chrono>
@@ -260,10 +261,61 @@ std::string GetUrlValidationError(const std::string &url) {
 	return "";  // Valid
 }
 
+bool IsUrlQuery(const std::string &arg) {
+	size_t start = 0;
+	while (start < arg.size() && std::isspace(static_cast<unsigned char>(arg[start]))) {
+		start++;
+	}
+	std::string lower;
+	for (size_t i = start; i < arg.size() && lower.size() < 7; i++) {
+		lower += static_cast<char>(std::tolower(static_cast<unsigned char>(arg[i])));
+	}
+	return lower.rfind("select ", 0) == 0 || lower.rfind("from ", 0) == 0 || lower.rfind("with ", 0) == 0 ||
+	       lower.rfind("(", 0) == 0;
+}
+
 bool IsValidCrawlUrl(const std::string &url) {
 	return GetUrlValidationError(url).empty();
 }
 
+std::string NormalizeCrawlUrl(const std::string &url) {
+	std::string result = url;
+
+	// Drop fragment - never sent to the server
+	size_t hash_pos = result.find('#');
+	if (hash_pos != std::string::npos) {
+		result = result.substr(0, hash_pos);
+	}
+
+	size_t proto_end = result.find("://");
+	if (proto_end == std::string::npos) {
+		return result;
+	}
+	size_t authority_start = proto_end + 3;
+	size_t authority_end = result.find_first_of("/?", authority_start);
+	if (authority_end == std::string::npos) {
+		authority_end = result.length();
+	}
+
+	std::string scheme = result.substr(0, proto_end);
+	std::string authority = result.substr(authority_start, authority_end - authority_start);
+	std::string rest = result.substr(authority_end);
+	std::transform(scheme.begin(), scheme.end(), scheme.begin(), ::tolower);
+	std::transform(authority.begin(), authority.end(), authority.begin(), ::tolower);
+
+	// Drop default ports
+	std::string default_port = scheme == "http" ? ":80" : (scheme == "https" ? ":443" : "");
+	if (!default_port.empty() && authority.size() > default_port.size() &&
+	    authority.compare(authority.size() - default_port.size(), default_port.size(), default_port) == 0) {
+		authority = authority.substr(0, authority.size() - default_port.size());
+	}
+
+	if (rest.empty() || rest[0] != '/') {
+		rest = "/" + rest;
+	}
+	return scheme + "://" + authority + rest;
+}
+
 std::string ExtractDomain(const std::string &url) {
 	size_t proto_end = url.find("://");
 	if (proto_end == std::string::npos) {
@@ -395,15 +447,22 @@ std::string GenerateDomainSurt(const std::string &hostname) {
 	return surt;
 }
 
+uint64_t HostHash(const std::string &url) {
+	// FNV-1a: std::hash is not guaranteed to be stable between builds
+	std::string key = GenerateDomainSurt(ExtractDomain(url));
+	uint64_t hash = 14695981039346656037ULL;
+	for (unsigned char c : key) {
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
 std::string GenerateContentHash(const std::string &content) {
 	if (content.empty()) {
 		return "";
 	}
-	std::hash<std::string> hasher;
-	size_t hash_value = hasher(content);
-	char buf[17];
-	snprintf(buf, sizeof(buf), "%016zx", hash_value);
-	return std::string(buf);
+	return HashContent128(content.data(), content.size()).ToHex();
 }
 
 //===--------------------------------------------------------------------===//
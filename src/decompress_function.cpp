@@ -0,0 +1,56 @@
+// crawl_decompress() - inflate a body kept raw by crawler_store_compressed
+//
+// Usage:
+//   SET crawler_store_compressed = 'only';
+//   SELECT crawl_decompress(body_compressed, content_encoding) FROM __crawler_cache;
+//   SELECT crawl_decompress(body_compressed, content_encoding, content_type) FROM __crawler_cache;
+//
+// Undoes gzip, deflate, br and zstd (stacked codings too) and decodes the result to
+// UTF-8 using the BOM, the Content-Type charset or a <meta charset> prescan.
+
+#include "decompress_function.hpp"
+#include "rust_ffi.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+#include "duckdb/common/vector_operations/ternary_executor.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+static string_t DecompressBody(Vector &result, string_t data, string_t content_encoding, const string &content_type) {
+    string text;
+    string error;
+    if (!DecompressBodyWithRust(data.GetString(), content_encoding.GetString(), content_type, text, error)) {
+        throw InvalidInputException("crawl_decompress(): %s", error);
+    }
+    return StringVector::AddString(result, text);
+}
+
+// crawl_decompress(body_compressed, content_encoding) -> VARCHAR
+static void DecompressFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    BinaryExecutor::Execute<string_t, string_t, string_t>(
+        args.data[0], args.data[1], result, args.size(),
+        [&result](string_t data, string_t content_encoding) {
+            return DecompressBody(result, data, content_encoding, "");
+        });
+}
+
+// crawl_decompress(body_compressed, content_encoding, content_type) -> VARCHAR
+static void DecompressWithTypeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    TernaryExecutor::Execute<string_t, string_t, string_t, string_t>(
+        args.data[0], args.data[1], args.data[2], result, args.size(),
+        [&result](string_t data, string_t content_encoding, string_t content_type) {
+            return DecompressBody(result, data, content_encoding, content_type.GetString());
+        });
+}
+
+void RegisterDecompressFunction(ExtensionLoader &loader) {
+    ScalarFunctionSet decompress_set("crawl_decompress");
+    decompress_set.AddFunction(ScalarFunction({LogicalType::BLOB, LogicalType::VARCHAR}, LogicalType::VARCHAR,
+                                              DecompressFunction));
+    decompress_set.AddFunction(ScalarFunction({LogicalType::BLOB, LogicalType::VARCHAR, LogicalType::VARCHAR},
+                                              LogicalType::VARCHAR, DecompressWithTypeFunction));
+    loader.RegisterFunction(decompress_set);
+}
+
+} // namespace duckdb
@@ -0,0 +1,330 @@
+#include "extraction_plan.hpp"
+#include "rust_ffi.hpp"
+
+#include <cctype>
+#include <set>
+
+namespace duckdb {
+
+using namespace duckdb_yyjson;
+
+//===--------------------------------------------------------------------===//
+// ExtractionBudget
+//===--------------------------------------------------------------------===//
+
+static int64_t GetLimitSetting(ClientContext &context, const char *name) {
+    Value setting_value;
+    if (context.TryGetCurrentSetting(name, setting_value) && !setting_value.IsNull()) {
+        return MaxValue<int64_t>(setting_value.GetValue<int64_t>(), 0);
+    }
+    return 0;
+}
+
+ExtractionBudget ExtractionBudget::FromSettings(ClientContext &context) {
+    ExtractionBudget budget;
+    budget.max_dom_nodes = GetLimitSetting(context, "crawler_extract_max_dom_nodes");
+    budget.max_script_bytes = GetLimitSetting(context, "crawler_extract_max_script_bytes");
+    budget.max_table_cells = GetLimitSetting(context, "crawler_extract_max_table_cells");
+    budget.max_facet_ms = GetLimitSetting(context, "crawler_extract_max_facet_ms");
+    return budget;
+}
+
+static void AddBudgetFields(yyjson_mut_doc *doc, yyjson_mut_val *obj, const ExtractionBudget &budget) {
+    yyjson_mut_obj_add_uint(doc, obj, "max_dom_nodes", budget.max_dom_nodes);
+    yyjson_mut_obj_add_uint(doc, obj, "max_script_bytes", budget.max_script_bytes);
+    yyjson_mut_obj_add_uint(doc, obj, "max_table_cells", budget.max_table_cells);
+    yyjson_mut_obj_add_uint(doc, obj, "max_facet_ms", budget.max_facet_ms);
+}
+
+string ExtractionBudget::ToJson() const {
+    if (Unlimited()) {
+        return "";
+    }
+    yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+    if (!doc) return "";
+
+    yyjson_mut_val *root = yyjson_mut_obj(doc);
+    yyjson_mut_doc_set_root(doc, root);
+    AddBudgetFields(doc, root, *this);
+
+    size_t len = 0;
+    char *json_str = yyjson_mut_write(doc, 0, &len);
+    yyjson_mut_doc_free(doc);
+    if (!json_str) return "";
+
+    string result(json_str, len);
+    free(json_str);
+    return result;
+}
+
+//===--------------------------------------------------------------------===//
+// ExtractionPlan
+//===--------------------------------------------------------------------===//
+
+string ExtractionPlan::ToJson() const {
+    if (Empty()) {
+        return "{}";
+    }
+    yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+    if (!doc) return "{}";
+
+    yyjson_mut_val *root = yyjson_mut_obj(doc);
+    yyjson_mut_doc_set_root(doc, root);
+
+    if (!specs_json.empty()) {
+        yyjson_doc *specs_doc = yyjson_read(specs_json.c_str(), specs_json.size(), 0);
+        if (specs_doc) {
+            yyjson_mut_obj_add_val(doc, root, "specs", yyjson_val_mut_copy(doc, yyjson_doc_get_root(specs_doc)));
+            yyjson_doc_free(specs_doc);
+        }
+    }
+    if (facets) {
+        yyjson_mut_obj_add_bool(doc, root, "facets", true);
+    }
+    if (follow) {
+        yyjson_mut_obj_add_strcpy(doc, root, "follow", follow_selector.c_str());
+    }
+    if (!budget.Unlimited()) {
+        yyjson_mut_val *budget_obj = yyjson_mut_obj(doc);
+        AddBudgetFields(doc, budget_obj, budget);
+        yyjson_mut_obj_add_val(doc, root, "budget", budget_obj);
+    }
+
+    size_t len = 0;
+    char *json_str = yyjson_mut_write(doc, 0, &len);
+    yyjson_mut_doc_free(doc);
+    if (!json_str) return "{}";
+
+    string result(json_str, len);
+    free(json_str);
+    return result;
+}
+
+//===--------------------------------------------------------------------===//
+// PlanResult
+//===--------------------------------------------------------------------===//
+
+static string WriteJsonValue(yyjson_val *val) {
+    if (!val || yyjson_is_null(val)) {
+        return "";
+    }
+    size_t len = 0;
+    char *json_str = yyjson_val_write(val, 0, &len);
+    if (!json_str) return "";
+    string result(json_str, len);
+    free(json_str);
+    return result;
+}
+
+void PlanResult::Read(yyjson_val *result) {
+    yyjson_val *facets = yyjson_obj_get(result, "facets");
+    if (facets && yyjson_is_obj(facets)) {
+        has_facets = true;
+        js_json = WriteJsonValue(yyjson_obj_get(facets, "js"));
+        opengraph_json = WriteJsonValue(yyjson_obj_get(facets, "opengraph"));
+        schema_json = WriteJsonValue(yyjson_obj_get(facets, "schema"));
+        readability_json = WriteJsonValue(yyjson_obj_get(facets, "readability"));
+    }
+
+    yyjson_val *links_arr = yyjson_obj_get(result, "links");
+    if (links_arr && yyjson_is_arr(links_arr)) {
+        has_links = true;
+        size_t idx, max_idx;
+        yyjson_val *link;
+        yyjson_arr_foreach(links_arr, idx, max_idx, link) {
+            if (yyjson_is_str(link)) {
+                links.push_back(yyjson_get_str(link));
+            }
+        }
+    }
+}
+
+//===--------------------------------------------------------------------===//
+// extract := [...] specs
+//===--------------------------------------------------------------------===//
+
+struct ParsedSpec {
+    string source;
+    vector<string> path;
+    string selector;
+    string accessor;
+    string alias;
+};
+
+// Position of `token` in `text` outside quoted strings, or string::npos
+static idx_t FindUnquoted(const string &text, const string &token) {
+    char quote = 0;
+    for (idx_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (text.compare(i, token.size(), token) == 0) {
+            return i;
+        }
+    }
+    return string::npos;
+}
+
+// A quoted string at `pos`; advances `pos` past the closing quote
+static bool ReadQuoted(const string &text, idx_t &pos, string &out) {
+    if (pos >= text.size() || (text[pos] != '"' && text[pos] != '\'')) {
+        return false;
+    }
+    auto end = text.find(text[pos], pos + 1);
+    if (end == string::npos) {
+        return false;
+    }
+    out = text.substr(pos + 1, end - pos - 1);
+    pos = end + 1;
+    return true;
+}
+
+static bool IsIdentifier(const string &name) {
+    if (name.empty()) return false;
+    for (char c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') return false;
+    }
+    return true;
+}
+
+// Returns an error message, or "" on success
+static string ParseSpec(const string &entry, ParsedSpec &spec) {
+    string expr = entry;
+    auto assign = FindUnquoted(entry, ":=");
+    if (assign != string::npos) {
+        spec.alias = entry.substr(0, assign);
+        StringUtil::Trim(spec.alias);
+        if (!IsIdentifier(spec.alias)) {
+            return "alias must be an identifier";
+        }
+        expr = entry.substr(assign + 2);
+    }
+    StringUtil::Trim(expr);
+
+    if (StringUtil::StartsWith(expr, "$(")) {
+        // $("selector") with an optional .text, .html or .attr("name") accessor
+        spec.source = "css";
+        idx_t pos = 2;
+        if (!ReadQuoted(expr, pos, spec.selector) || pos >= expr.size() || expr[pos] != ')') {
+            return "expected $(\"selector\")";
+        }
+        auto accessor = expr.substr(pos + 1);
+        if (accessor.empty() || accessor == ".text") {
+            spec.accessor = "text";
+        } else if (accessor == ".html") {
+            spec.accessor = "html";
+        } else if (StringUtil::StartsWith(accessor, ".attr(")) {
+            idx_t attr_pos = 6;
+            string attr_name;
+            if (!ReadQuoted(accessor, attr_pos, attr_name) || attr_pos + 1 != accessor.size() ||
+                accessor[attr_pos] != ')') {
+                return "expected .attr(\"name\")";
+            }
+            spec.accessor = "attr:" + attr_name;
+        } else {
+            return "unknown accessor '" + accessor + "' (expected .text, .html or .attr(\"name\"))";
+        }
+        if (spec.alias.empty()) {
+            return "a $(...) spec needs an alias (alias := $(...))";
+        }
+        return "";
+    }
+
+    auto segments = StringUtil::Split(expr, '.');
+    if (segments.size() < 2) {
+        return "expected source.path or $(\"selector\")";
+    }
+    spec.source = StringUtil::Lower(segments[0]);
+    if (spec.source != "jsonld" && spec.source != "microdata" && spec.source != "og" && spec.source != "meta" &&
+        spec.source != "js") {
+        return "unknown source '" + segments[0] + "' (expected jsonld, microdata, og, meta, js or $(...))";
+    }
+    for (idx_t i = 1; i < segments.size(); i++) {
+        auto segment = segments[i];
+        StringUtil::Trim(segment);
+        if (segment.empty()) {
+            return "empty path segment";
+        }
+        spec.path.push_back(segment);
+    }
+    if (spec.alias.empty()) {
+        spec.alias = spec.path.back();
+    }
+    return "";
+}
+
+string ParseExtractSpecs(const vector<string> &entries, const string &function_name) {
+    if (entries.empty()) {
+        return "";
+    }
+    vector<ParsedSpec> specs;
+    std::set<string> aliases;
+    for (auto &entry : entries) {
+        ParsedSpec spec;
+        auto error = ParseSpec(entry, spec);
+        if (!error.empty()) {
+            throw BinderException("%s(): invalid extract spec '%s': %s", function_name, entry, error);
+        }
+        if (!aliases.insert(spec.alias).second) {
+            throw BinderException("%s(): extract alias '%s' is used more than once", function_name, spec.alias);
+        }
+        specs.push_back(std::move(spec));
+    }
+
+    yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+    if (!doc) return "";
+
+    yyjson_mut_val *specs_arr = yyjson_mut_arr(doc);
+    yyjson_mut_doc_set_root(doc, specs_arr);
+    for (auto &spec : specs) {
+        yyjson_mut_val *spec_obj = yyjson_mut_obj(doc);
+        yyjson_mut_obj_add_strcpy(doc, spec_obj, "source", spec.source.c_str());
+        yyjson_mut_val *path_arr = yyjson_mut_arr(doc);
+        for (auto &segment : spec.path) {
+            yyjson_mut_arr_add_strcpy(doc, path_arr, segment.c_str());
+        }
+        yyjson_mut_obj_add_val(doc, spec_obj, "path", path_arr);
+        if (spec.source == "css") {
+            yyjson_mut_obj_add_strcpy(doc, spec_obj, "selector", spec.selector.c_str());
+            yyjson_mut_obj_add_strcpy(doc, spec_obj, "accessor", spec.accessor.c_str());
+        }
+        yyjson_mut_obj_add_strcpy(doc, spec_obj, "alias", spec.alias.c_str());
+        yyjson_mut_obj_add_bool(doc, spec_obj, "return_text", true);
+        yyjson_mut_arr_append(specs_arr, spec_obj);
+    }
+
+    size_t len = 0;
+    char *json_str = yyjson_mut_write(doc, 0, &len);
+    yyjson_mut_doc_free(doc);
+    if (!json_str) return "";
+
+    string result(json_str, len);
+    free(json_str);
+    return result;
+}
+
+string EvaluateExtractSpecs(const string &body, const string &specs_json, const ExtractionBudget &budget) {
+    if (specs_json.empty() || body.empty()) {
+        return "";
+    }
+#if defined(RUST_PARSER_AVAILABLE) && RUST_PARSER_AVAILABLE
+    auto budget_json = budget.ToJson();
+    string request_json = "{\"specs\":" + specs_json;
+    if (!budget_json.empty()) {
+        request_json += ",\"budget\":" + budget_json;
+    }
+    string result_json = ExtractWithRust(body, request_json + "}");
+    yyjson_doc *doc = yyjson_read(result_json.c_str(), result_json.size(), 0);
+    if (!doc) return "";
+    string values = WriteJsonValue(yyjson_obj_get(yyjson_doc_get_root(doc), "values"));
+    yyjson_doc_free(doc);
+    return values;
+#else
+    (void)budget;
+    return "";
+#endif
+}
+
+} // namespace duckdb
@@ -0,0 +1,364 @@
+#include "facet_cache.hpp"
+#include "rust_ffi.hpp"
+#include "yyjson.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+using namespace duckdb_yyjson;
+
+// Bump when the shape of a facet changes without a Rust parser version change
+static constexpr const char *FACET_FORMAT_VERSION = "2";
+
+string FacetExtractorVersion() {
+    return GetRustParserVersion() + "/" + FACET_FORMAT_VERSION;
+}
+
+//===--------------------------------------------------------------------===//
+// Facets
+//===--------------------------------------------------------------------===//
+
+static const char *const FACET_JS = "js";
+static const char *const FACET_OPENGRAPH = "opengraph";
+static const char *const FACET_SCHEMA = "schema";
+
+// Readability resolves relative links against the document's base URL (the page URL
+// without its fragment), so its facet is per base URL
+static string ReadabilityFacet(const string &url) {
+    return "readability@" + url.substr(0, url.find('#'));
+}
+
+static string *FacetField(PlanResult &facets, const string &facet) {
+    if (facet == FACET_JS) return &facets.js_json;
+    if (facet == FACET_OPENGRAPH) return &facets.opengraph_json;
+    if (facet == FACET_SCHEMA) return &facets.schema_json;
+    return &facets.readability_json;
+}
+
+static const string &FacetValue(const PlanResult &facets, const string &facet) {
+    if (facet == FACET_JS) return facets.js_json;
+    if (facet == FACET_OPENGRAPH) return facets.opengraph_json;
+    if (facet == FACET_SCHEMA) return facets.schema_json;
+    return facets.readability_json;
+}
+
+static vector<string> FacetNames(const string &url) {
+    return {FACET_JS, FACET_OPENGRAPH, FACET_SCHEMA, ReadabilityFacet(url)};
+}
+
+//===--------------------------------------------------------------------===//
+// Extraction
+//===--------------------------------------------------------------------===//
+
+static string CombineSchemaData(const string &jsonld, const string &microdata) {
+    // Combine JSON-LD and microdata into a single schema object
+    // Both are JSON objects keyed by @type, with array values
+    yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+    if (!doc) return "{}";
+
+    yyjson_mut_val *root = yyjson_mut_obj(doc);
+    yyjson_mut_doc_set_root(doc, root);
+
+    // Parse and merge JSON-LD (values are arrays)
+    if (!jsonld.empty() && jsonld != "{}") {
+        yyjson_doc *jld_doc = yyjson_read(jsonld.c_str(), jsonld.size(), 0);
+        if (jld_doc) {
+            yyjson_val *jld_root = yyjson_doc_get_root(jld_doc);
+            if (yyjson_is_obj(jld_root)) {
+                size_t idx, max;
+                yyjson_val *key, *val;
+                yyjson_obj_foreach(jld_root, idx, max, key, val) {
+                    yyjson_mut_val *key_copy = yyjson_val_mut_copy(doc, key);
+                    yyjson_mut_val *val_copy = yyjson_val_mut_copy(doc, val);
+                    yyjson_mut_obj_add(root, key_copy, val_copy);
+                }
+            }
+            yyjson_doc_free(jld_doc);
+        }
+    }
+
+    // Parse and merge microdata (values are arrays, merge with existing)
+    if (!microdata.empty() && microdata != "{}") {
+        yyjson_doc *md_doc = yyjson_read(microdata.c_str(), microdata.size(), 0);
+        if (md_doc) {
+            yyjson_val *md_root = yyjson_doc_get_root(md_doc);
+            if (yyjson_is_obj(md_root)) {
+                size_t idx, max;
+                yyjson_val *key, *val;
+                yyjson_obj_foreach(md_root, idx, max, key, val) {
+                    const char *key_str = yyjson_get_str(key);
+                    yyjson_mut_val *existing = yyjson_mut_obj_get(root, key_str);
+
+                    if (existing && yyjson_mut_is_arr(existing) && yyjson_is_arr(val)) {
+                        // Append microdata items to existing JSON-LD array
+                        size_t arr_idx, arr_max;
+                        yyjson_val *item;
+                        yyjson_arr_foreach(val, arr_idx, arr_max, item) {
+                            yyjson_mut_val *item_copy = yyjson_val_mut_copy(doc, item);
+                            yyjson_mut_arr_append(existing, item_copy);
+                        }
+                    } else if (!existing) {
+                        // Add new type from microdata
+                        yyjson_mut_val *key_copy = yyjson_val_mut_copy(doc, key);
+                        yyjson_mut_val *val_copy = yyjson_val_mut_copy(doc, val);
+                        yyjson_mut_obj_add(root, key_copy, val_copy);
+                    }
+                }
+            }
+            yyjson_doc_free(md_doc);
+        }
+    }
+
+    size_t len = 0;
+    char *json_str = yyjson_mut_write(doc, 0, &len);
+    yyjson_mut_doc_free(doc);
+
+    if (!json_str) return "{}";
+
+    string result(json_str, len);
+    free(json_str);
+    return result;
+}
+
+// Run the extractors for the named facets only
+static void ExtractFacets(const string &body, const string &url, const vector<string> &names,
+                          const string &budget_json, PlanResult &facets) {
+#if defined(RUST_PARSER_AVAILABLE) && RUST_PARSER_AVAILABLE
+    for (auto &name : names) {
+        if (name == FACET_JS) {
+            facets.js_json = ExtractJsWithRust(body, budget_json);
+        } else if (name == FACET_OPENGRAPH) {
+            facets.opengraph_json = ExtractOpenGraphWithRust(body);
+        } else if (name == FACET_SCHEMA) {
+            facets.schema_json =
+                CombineSchemaData(ExtractJsonLdWithRust(body), ExtractMicrodataWithRust(body, budget_json));
+        } else {
+            facets.readability_json = ExtractReadabilityWithRust(body, url, budget_json);
+        }
+    }
+#else
+    (void)budget_json;
+#endif
+}
+
+// A facet cut short by the extraction budget depends on the budget, not just the
+// content, so it is not cached. The marker is a top-level key of the facet object.
+static bool IsTruncated(const string &value) {
+    if (value.find("$truncated") == string::npos) {
+        return false;
+    }
+    yyjson_doc *doc = yyjson_read(value.c_str(), value.size(), 0);
+    if (!doc) {
+        return false;
+    }
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    bool truncated = yyjson_is_obj(root) && yyjson_obj_get(root, "$truncated") != nullptr;
+    yyjson_doc_free(doc);
+    return truncated;
+}
+
+//===--------------------------------------------------------------------===//
+// Facet Table
+//===--------------------------------------------------------------------===//
+
+void EnsureFacetTable(Connection &conn) {
+    conn.Query("CREATE TABLE IF NOT EXISTS " + string(FACET_TABLE_NAME) + " ("
+               "content_hash VARCHAR, "
+               "extractor_version VARCHAR, "
+               "facet VARCHAR, "
+               "value VARCHAR, "
+               "created_at TIMESTAMP DEFAULT current_timestamp, "
+               "PRIMARY KEY (content_hash, extractor_version, facet))");
+}
+
+int64_t PruneFacetTable(Connection &conn, int64_t max_age_hours) {
+    EnsureFacetTable(conn);
+    auto result = conn.Query("DELETE FROM " + string(FACET_TABLE_NAME) +
+                                 " WHERE extractor_version <> $1 "
+                                 "OR ($2::BIGINT > 0 AND created_at < current_timestamp - to_hours($2::BIGINT))",
+                             FacetExtractorVersion(), Value::BIGINT(max_age_hours));
+    if (result->HasError()) {
+        return 0;
+    }
+    auto chunk = result->Fetch();
+    if (!chunk || chunk->size() == 0) {
+        return 0;
+    }
+    return chunk->GetValue(0, 0).GetValue<int64_t>();
+}
+
+//===--------------------------------------------------------------------===//
+// FacetCache
+//===--------------------------------------------------------------------===//
+
+static string FacetKey(const string &content_hash, const string &facet) {
+    return content_hash + "\n" + facet;
+}
+
+shared_ptr<FacetCache> FacetCache::Get(ClientContext &context) {
+    idx_t budget = DEFAULT_MEMORY_BYTES;
+    Value setting_value;
+    if (context.TryGetCurrentSetting("crawler_facet_cache_memory_bytes", setting_value) && !setting_value.IsNull()) {
+        budget = static_cast<idx_t>(MaxValue<int64_t>(setting_value.GetValue<int64_t>(), 0));
+    }
+    if (budget == 0) {
+        return nullptr;
+    }
+    auto cache = ObjectCache::GetObjectCache(context).GetOrCreate<FacetCache>(FacetCache::ObjectType());
+    cache->SetMemoryBudget(budget);
+    return cache;
+}
+
+bool FacetCache::GetFromMemory(const string &key, string &value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    value = it->second->value;
+    return true;
+}
+
+void FacetCache::PutInMemory(const string &key, const string &value) {
+    Entry entry {key, value};
+    idx_t size = entry.MemorySize();
+    idx_t budget = memory_budget_.load();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        bytes_ -= it->second->MemorySize();
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+    if (size > budget) {
+        return;
+    }
+    while (!lru_.empty() && bytes_ + size > budget) {
+        bytes_ -= lru_.back().MemorySize();
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+    lru_.push_front(std::move(entry));
+    index_[key] = lru_.begin();
+    bytes_ += size;
+}
+
+bool FacetCache::Lookup(DatabaseInstance &db, const string &content_hash, const string &url, PlanResult &facets,
+                        vector<string> &missing) {
+    missing.clear();
+    for (auto &facet : FacetNames(url)) {
+        if (!GetFromMemory(FacetKey(content_hash, facet), *FacetField(facets, facet))) {
+            missing.push_back(facet);
+        }
+    }
+    if (missing.empty()) {
+        return true;
+    }
+
+    // Memory misses in one query
+    Connection conn(db);
+    EnsureFacetTable(conn);
+    vector<Value> facet_values;
+    for (auto &facet : missing) {
+        facet_values.push_back(Value(facet));
+    }
+    auto result = conn.Query("SELECT facet, value FROM " + string(FACET_TABLE_NAME) +
+                                 " WHERE content_hash = $1 AND extractor_version = $2 "
+                                 "AND list_contains($3::VARCHAR[], facet)",
+                             content_hash, FacetExtractorVersion(),
+                             Value::LIST(LogicalType::VARCHAR, std::move(facet_values)));
+    if (result->HasError()) {
+        return false;
+    }
+    while (auto chunk = result->Fetch()) {
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            auto facet = chunk->GetValue(0, row).ToString();
+            auto value = chunk->GetValue(1, row).IsNull() ? string() : chunk->GetValue(1, row).ToString();
+            PutInMemory(FacetKey(content_hash, facet), value);
+            *FacetField(facets, facet) = std::move(value);
+            missing.erase(std::remove(missing.begin(), missing.end(), facet), missing.end());
+        }
+    }
+    return missing.empty();
+}
+
+void FacetCache::Save(DatabaseInstance &db, const string &content_hash, const vector<string> &names,
+                      const PlanResult &facets, bool persist) {
+    vector<Value> facet_values, values;
+    for (auto &facet : names) {
+        auto &value = FacetValue(facets, facet);
+        if (IsTruncated(value)) {
+            continue;
+        }
+        PutInMemory(FacetKey(content_hash, facet), value);
+        facet_values.push_back(Value(facet));
+        values.push_back(Value(value));
+    }
+    if (!persist || facet_values.empty()) {
+        return;
+    }
+    Connection conn(db);
+    EnsureFacetTable(conn);
+    conn.Query("INSERT OR REPLACE INTO " + string(FACET_TABLE_NAME) +
+                   " (content_hash, extractor_version, facet, value, created_at) "
+                   "SELECT $1, $2, unnest($3::VARCHAR[]), unnest($4::VARCHAR[]), current_timestamp",
+               content_hash, FacetExtractorVersion(), Value::LIST(LogicalType::VARCHAR, std::move(facet_values)),
+               Value::LIST(LogicalType::VARCHAR, std::move(values)));
+}
+
+void FacetCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
+
+idx_t FacetCache::MemoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+//===--------------------------------------------------------------------===//
+// Facet Resolution
+//===--------------------------------------------------------------------===//
+
+static bool IsHtmlContentType(const string &content_type) {
+    return content_type.find("text/html") != string::npos || content_type.find("application/xhtml") != string::npos;
+}
+
+void ResolvePageFacets(ClientContext &context, const string &body, const string &content_type,
+                       const string &content_hash, const string &url, bool persist, PlanResult &facets) {
+    if (facets.has_facets || body.empty() || !IsHtmlContentType(content_type) || !IsRustParserAvailable()) {
+        return;
+    }
+    facets.has_facets = true;
+
+    auto budget_json = ExtractionBudget::FromSettings(context).ToJson();
+    auto cache = content_hash.empty() ? nullptr : FacetCache::Get(context);
+    if (!cache) {
+        ExtractFacets(body, url, FacetNames(url), budget_json, facets);
+        return;
+    }
+    vector<string> missing;
+    if (cache->Lookup(*context.db, content_hash, url, facets, missing)) {
+        return;
+    }
+    // Only what was just extracted; the rest came from the cache
+    ExtractFacets(body, url, missing, budget_json, facets);
+    cache->Save(*context.db, content_hash, missing, facets, persist);
+}
+
+void RememberPageFacets(ClientContext &context, const string &content_hash, const string &url,
+                        const PlanResult &facets, bool persist) {
+    if (!facets.has_facets || content_hash.empty()) {
+        return;
+    }
+    if (auto cache = FacetCache::Get(context)) {
+        cache->Save(*context.db, content_hash, FacetNames(url), facets, persist);
+    }
+}
+
+} // namespace duckdb
@@ -229,9 +229,9 @@ HttpResponse HttpClient::ExecuteHttpGet(const std::string &url,
 		curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent.c_str());
 	}
 
-	// Enable compression
+	// Enable compression: "" offers every coding libcurl was built with (gzip, deflate, br, zstd)
 	if (compress) {
-		curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "gzip, deflate");
+		curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
 	}
 
 	// Apply global HTTP settings (from DuckDB configuration)
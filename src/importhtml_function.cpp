@@ -1,12 +1,33 @@
 // read_html() table function for DuckDB Crawler
 // Similar to Google Sheets =IMPORTHTML() - extracts tables from web pages
+//
+// read_html(url, selector [, index])          - single page
+// read_html([url, ...], selector [, index])   - many pages, unioned by position
+// read_html('SELECT url FROM ...', selector)  - URLs from a query's first column
+//
+// Anything without an http(s):// scheme is a local file, read through DuckDB's file
+// system like read_csv() paths.
+//
+// Only a small sample of pages is fetched at bind time (to infer the schema, or
+// none at all when columns := is given). Remaining pages are fetched
+// concurrently in batches during the scan and streamed out.
 
 #include "importhtml_function.hpp"
+#include "crawler_utils.hpp"
 #include "rust_ffi.hpp"
+#include "extraction_plan.hpp"
 #include "yyjson.hpp"
 #include "duckdb.hpp"
 #include "duckdb/function/table_function.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/main/connection.hpp"
+#include <cstring>
+#include <deque>
+#include <memory>
 #include <set>
+#include <unordered_map>
 
 namespace duckdb {
 
@@ -16,27 +37,63 @@ using namespace duckdb_yyjson;
 // Bind Data
 //===--------------------------------------------------------------------===//
 
-// Column type detected during inference
-enum class InferredType : uint8_t {
-    VARCHAR = 0,
-    BIGINT = 1,
-    DOUBLE = 2
+// Table extracted from a single page. HTML tables come back from Rust in
+// columnar form; JS variables are materialized as rows.
+struct HtmlTable {
+    string url;
+    vector<string> headers;
+    vector<vector<string>> rows;                  // JS variable tables
+    std::unique_ptr<RustColumnarTable> columnar;  // HTML tables
+    string error;
+
+    idx_t NumRows() const {
+        return columnar ? columnar->NumRows() : rows.size();
+    }
+
+    // Cell text (empty for missing cells), pointing into memory owned by this table
+    string_t Cell(idx_t row, idx_t col) const {
+        if (columnar) {
+            if (col >= columnar->NumColumns()) return string_t("", 0);
+            size_t len;
+            const char *data = columnar->Cell(row, col, len);
+            return string_t(data, static_cast<uint32_t>(len));
+        }
+        const auto &cells = rows[row];
+        if (col >= cells.size()) return string_t("", 0);
+        return string_t(cells[col].c_str(), static_cast<uint32_t>(cells[col].size()));
+    }
+};
+
+// Keeps a page's cell memory alive for output string_t values that point into it
+class HtmlTableBuffer : public VectorBuffer {
+public:
+    explicit HtmlTableBuffer(std::shared_ptr<HtmlTable> table_p)
+        : VectorBuffer(VectorBufferType::OPAQUE_BUFFER), table(std::move(table_p)) {}
+
+    std::shared_ptr<HtmlTable> table;
 };
 
 struct ReadHtmlBindData : public TableFunctionData {
-    string url;
+    vector<string> urls;
+    string source_query;     // Query whose first column yields URLs (alternative to urls)
     string selector;
     size_t table_index = 0;  // 0-based index of which matching table to extract
     string user_agent = "DuckDB-Crawler/1.0";
     int timeout_ms = 30000;
+    int concurrency = 8;     // Concurrent fetches per Rust batch
+    idx_t sample_size = 3;   // Pages fetched at bind time for schema inference
+    bool ignore_errors = false;  // Skip pages that fail and read uncastable cells as NULL
+    string extract_budget;       // crawler_extract_* limits as JSON (table cells, facet time)
 
-    // Extracted table data (populated during bind)
+    // Schema (from columns := or inferred from sample pages)
     vector<string> headers;
-    vector<vector<string>> rows;
-    vector<InferredType> column_types;  // Inferred types per column
+    vector<LogicalType> column_types;  // Inferred (or declared) types per column
+    vector<bool> normalize_numbers;    // Strip currency/thousand separators before casting
     idx_t num_columns = 0;
-    idx_t num_rows = 0;
-    string error;
+
+    // Pages fetched during bind for inference; emitted first so they are not refetched
+    vector<std::shared_ptr<HtmlTable>> sample_tables;
+    idx_t sampled_urls = 0;  // Number of leading urls consumed by sampling
 };
 
 //===--------------------------------------------------------------------===//
@@ -44,7 +101,12 @@ struct ReadHtmlBindData : public TableFunctionData {
 //===--------------------------------------------------------------------===//
 
 struct ReadHtmlGlobalState : public GlobalTableFunctionState {
-    idx_t current_row = 0;
+    bool initialized = false;
+    vector<string> urls;         // URLs still to fetch
+    idx_t next_url = 0;
+    std::deque<std::shared_ptr<HtmlTable>> tables;  // Fetched tables waiting to be emitted
+    idx_t current_row = 0;         // Row within tables.front()
+    unique_ptr<CrawlCancelToken> cancel_token;  // Cancelled when this query is interrupted
 
     idx_t MaxThreads() const override { return 1; }
 };
@@ -53,20 +115,20 @@ struct ReadHtmlGlobalState : public GlobalTableFunctionState {
 // Helper: Extract JS variable as table
 //===--------------------------------------------------------------------===//
 
-static void ExtractJsVariable(const string &html, ReadHtmlBindData &bind_data) {
+static void ExtractJsVariable(const string &html, const string &selector, HtmlTable &table) {
     // Use ExtractPathWithRust to get the JS variable
     // Selector format: @$varname or script@$varname
-    string json_result = ExtractPathWithRust(html, bind_data.selector);
+    string json_result = ExtractPathWithRust(html, selector);
 
     if (json_result.empty() || json_result == "null") {
-        bind_data.error = "JS variable not found: " + bind_data.selector;
+        table.error = "JS variable not found: " + selector;
         return;
     }
 
     // Parse the JSON result
     yyjson_doc *doc = yyjson_read(json_result.c_str(), json_result.length(), 0);
     if (!doc) {
-        bind_data.error = "Failed to parse JS variable as JSON";
+        table.error = "Failed to parse JS variable as JSON";
         return;
     }
 
@@ -93,7 +155,7 @@ static void ExtractJsVariable(const string &html, ReadHtmlBindData &bind_data) {
 
         if (all_keys.empty()) {
             // Array of non-objects, treat as single column
-            bind_data.headers.push_back("value");
+            table.headers.push_back("value");
             yyjson_arr_foreach(root, idx, max_idx, item) {
                 vector<string> row;
                 if (yyjson_is_str(item)) {
@@ -117,12 +179,12 @@ static void ExtractJsVariable(const string &html, ReadHtmlBindData &bind_data) {
                         row.push_back("");
                     }
                 }
-                bind_data.rows.push_back(std::move(row));
+                table.rows.push_back(std::move(row));
             }
         } else {
             // Array of objects - use keys as headers
             for (const auto &key : all_keys) {
-                bind_data.headers.push_back(key);
+                table.headers.push_back(key);
             }
 
             // Second pass: extract values for each object
@@ -152,13 +214,13 @@ static void ExtractJsVariable(const string &html, ReadHtmlBindData &bind_data) {
                         }
                     }
                 }
-                bind_data.rows.push_back(std::move(row));
+                table.rows.push_back(std::move(row));
             }
         }
     } else if (yyjson_is_obj(root)) {
         // Single object - each key becomes a row with key/value columns
-        bind_data.headers.push_back("key");
-        bind_data.headers.push_back("value");
+        table.headers.push_back("key");
+        table.headers.push_back("value");
 
         size_t key_idx, key_max;
         yyjson_val *key, *val;
@@ -186,11 +248,11 @@ static void ExtractJsVariable(const string &html, ReadHtmlBindData &bind_data) {
                     row.push_back("");
                 }
             }
-            bind_data.rows.push_back(std::move(row));
+            table.rows.push_back(std::move(row));
         }
     } else {
         // Scalar value - single row, single column
-        bind_data.headers.push_back("value");
+        table.headers.push_back("value");
         vector<string> row;
         if (yyjson_is_str(root)) {
             row.push_back(yyjson_get_str(root));
@@ -203,263 +265,449 @@ static void ExtractJsVariable(const string &html, ReadHtmlBindData &bind_data) {
         } else {
             row.push_back("");
         }
-        bind_data.rows.push_back(std::move(row));
+        table.rows.push_back(std::move(row));
     }
 
-    bind_data.num_columns = bind_data.headers.size();
-    bind_data.num_rows = bind_data.rows.size();
-
     yyjson_doc_free(doc);
 }
 
 //===--------------------------------------------------------------------===//
-// Helper: Fetch page and extract table
+// Helper: Extract table from fetched HTML
 //===--------------------------------------------------------------------===//
 
-static void FetchAndExtractTable(ReadHtmlBindData &bind_data) {
-    // Build request JSON for CrawlBatchWithRust
-    yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
-    if (!doc) {
-        bind_data.error = "Failed to create JSON document";
+static void ExtractTableFromHtml(const string &html, const ReadHtmlBindData &bind_data, HtmlTable &table) {
+    if (html.empty()) {
+        table.error = "Empty HTML body";
+        return;
+    }
+
+    // Check if selector is a JS variable path
+    // Syntax: js=varname or script@js=varname (= is illegal in JS variable names)
+    size_t js_pos = bind_data.selector.find("js=");
+    if (js_pos != string::npos) {
+        // Replace js= with @$ for the Rust extractor
+        string converted_selector = bind_data.selector;
+        converted_selector.replace(js_pos, 3, "@$");
+        ExtractJsVariable(html, converted_selector, table);
         return;
     }
 
+    // Extract table in columnar form (pass URL for Wikipedia-specific handling, table_index for nth match)
+    auto columnar = ExtractTableColumnarWithRust(html, bind_data.selector, table.url, bind_data.table_index,
+                                                 bind_data.extract_budget);
+    if (columnar->HasError()) {
+        table.error = columnar->GetError();
+        return;
+    }
+
+    for (size_t col = 0; col < columnar->NumColumns(); col++) {
+        size_t len;
+        const char *data = columnar->Header(col, len);
+        table.headers.emplace_back(data, len);
+    }
+    table.columnar = std::move(columnar);
+}
+
+//===--------------------------------------------------------------------===//
+// Helper: Fetch a batch of pages and extract their tables
+//===--------------------------------------------------------------------===//
+
+static string BuildFetchRequest(const vector<string> &urls, const ReadHtmlBindData &bind_data) {
+    yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+    if (!doc) return "";
+
     yyjson_mut_val *root = yyjson_mut_obj(doc);
     yyjson_mut_doc_set_root(doc, root);
 
     // URLs array
     yyjson_mut_val *urls_arr = yyjson_mut_arr(doc);
-    yyjson_mut_arr_add_strcpy(doc, urls_arr, bind_data.url.c_str());
+    for (const auto &url : urls) {
+        yyjson_mut_arr_add_strcpy(doc, urls_arr, url.c_str());
+    }
     yyjson_mut_obj_add_val(doc, root, "urls", urls_arr);
 
     yyjson_mut_obj_add_strcpy(doc, root, "user_agent", bind_data.user_agent.c_str());
     yyjson_mut_obj_add_uint(doc, root, "timeout_ms", bind_data.timeout_ms);
-    yyjson_mut_obj_add_uint(doc, root, "concurrency", 1);
+    yyjson_mut_obj_add_uint(doc, root, "concurrency", std::max(bind_data.concurrency, 1));
 
     size_t len = 0;
     char *json_str = yyjson_mut_write(doc, 0, &len);
     yyjson_mut_doc_free(doc);
 
-    if (!json_str) {
-        bind_data.error = "Failed to serialize request";
-        return;
-    }
-
-    string request_json(json_str, len);
+    if (!json_str) return "";
+    string result(json_str, len);
     free(json_str);
+    return result;
+}
 
-    // Fetch the page
-    string response_json = CrawlBatchWithRust(request_json);
-
-    // Parse response
-    yyjson_doc *resp_doc = yyjson_read(response_json.c_str(), response_json.length(), 0);
-    if (!resp_doc) {
-        bind_data.error = "Failed to parse crawl response";
-        return;
-    }
-
-    yyjson_val *resp_root = yyjson_doc_get_root(resp_doc);
-    yyjson_val *results = yyjson_obj_get(resp_root, "results");
-
-    if (!results || !yyjson_is_arr(results) || yyjson_arr_size(results) == 0) {
-        yyjson_doc_free(resp_doc);
-        bind_data.error = "No results from crawl";
-        return;
-    }
-
-    yyjson_val *first_result = yyjson_arr_get_first(results);
-    if (!first_result) {
-        yyjson_doc_free(resp_doc);
-        bind_data.error = "Empty result";
-        return;
-    }
-
-    // Check for error
-    yyjson_val *error_val = yyjson_obj_get(first_result, "error");
-    if (error_val && !yyjson_is_null(error_val)) {
-        bind_data.error = yyjson_get_str(error_val);
-        yyjson_doc_free(resp_doc);
-        return;
-    }
+static bool IsHttpUrl(const string &url) {
+    auto lower = StringUtil::Lower(url.substr(0, 8));
+    return StringUtil::StartsWith(lower, "http://") || StringUtil::StartsWith(lower, "https://");
+}
 
-    // Get body
-    yyjson_val *body_val = yyjson_obj_get(first_result, "body");
-    if (!body_val || !yyjson_is_str(body_val)) {
-        yyjson_doc_free(resp_doc);
-        bind_data.error = "No body in response";
-        return;
+// Read a local page and extract its table; failures are reported through HtmlTable::error
+static void ReadLocalTable(ClientContext &context, const ReadHtmlBindData &bind_data, HtmlTable &table) {
+    try {
+        auto &fs = FileSystem::GetFileSystem(context);
+        auto handle = fs.OpenFile(table.url, FileFlags::FILE_FLAGS_READ);
+        string html(static_cast<size_t>(handle->GetFileSize()), '\0');
+        handle->Read(&html[0], html.size());
+        table.error.clear();
+        ExtractTableFromHtml(html, bind_data, table);
+    } catch (std::exception &ex) {
+        table.error = ErrorData(ex).RawMessage();
     }
+}
 
-    string html = yyjson_get_str(body_val);
-    yyjson_doc_free(resp_doc);
-
-    if (html.empty()) {
-        bind_data.error = "Empty HTML body";
-        return;
+// Fetch all URLs in one Rust batch (fetched concurrently) and extract one table per page.
+// Results are returned in input order; failures are reported through HtmlTable::error.
+static vector<std::shared_ptr<HtmlTable>> FetchTables(ClientContext &context, const vector<string> &urls,
+                                                      const ReadHtmlBindData &bind_data,
+                                                      const CrawlCancelToken &cancel_token) {
+    vector<std::shared_ptr<HtmlTable>> tables;
+    vector<string> remote_urls;
+    std::unordered_map<string, vector<idx_t>> positions;
+    for (idx_t i = 0; i < urls.size(); i++) {
+        auto table = std::make_shared<HtmlTable>();
+        table->url = urls[i];
+        table->error = "No result from crawl";
+        if (IsHttpUrl(urls[i])) {
+            remote_urls.push_back(urls[i]);
+            positions[urls[i]].push_back(i);
+        } else {
+            ReadLocalTable(context, bind_data, *table);
+        }
+        tables.push_back(std::move(table));
     }
+    if (remote_urls.empty()) return tables;
 
-    // Check if selector is a JS variable path
-    // Syntax: js=varname or script@js=varname (= is illegal in JS variable names)
-    bool is_js_var = bind_data.selector.find("js=") != string::npos;
+    auto fail_remote = [&](const string &message) {
+        for (auto &url_positions : positions) {
+            for (auto i : url_positions.second) tables[i]->error = message;
+        }
+    };
 
-    if (is_js_var) {
-        // Convert js=varname to @$varname for ExtractPathWithRust
-        string converted_selector = bind_data.selector;
-        size_t pos = converted_selector.find("js=");
-        if (pos != string::npos) {
-            // Replace js= with @$ for the Rust extractor
-            converted_selector.replace(pos, 3, "@$");
-        }
-        // Temporarily swap selector for extraction
-        string original_selector = bind_data.selector;
-        bind_data.selector = converted_selector;
-        ExtractJsVariable(html, bind_data);
-        bind_data.selector = original_selector;  // Restore for error messages
-        return;
+    string request_json = BuildFetchRequest(remote_urls, bind_data);
+    if (request_json.empty()) {
+        fail_remote("Failed to serialize request");
+        return tables;
     }
 
-    // Extract table (pass URL for Wikipedia-specific handling, table_index for nth match)
-    string table_json = ExtractTableWithRust(html, bind_data.selector, bind_data.url, bind_data.table_index);
+    // Fetch the pages
+    string response_json = CrawlBatchWithRust(request_json, cancel_token);
 
-    // Parse table JSON
-    yyjson_doc *table_doc = yyjson_read(table_json.c_str(), table_json.length(), 0);
-    if (!table_doc) {
-        bind_data.error = "Failed to parse table extraction result";
-        return;
+    // Parse response
+    yyjson_doc *resp_doc = yyjson_read(response_json.c_str(), response_json.length(), 0);
+    if (!resp_doc) {
+        fail_remote("Failed to parse crawl response");
+        return tables;
     }
 
-    yyjson_val *table_root = yyjson_doc_get_root(table_doc);
-
-    // Check for extraction error
-    yyjson_val *table_error = yyjson_obj_get(table_root, "error");
-    if (table_error && !yyjson_is_null(table_error)) {
-        bind_data.error = yyjson_get_str(table_error);
-        yyjson_doc_free(table_doc);
-        return;
+    yyjson_val *resp_root = yyjson_doc_get_root(resp_doc);
+    yyjson_val *batch_error = yyjson_obj_get(resp_root, "error");
+    if (batch_error && yyjson_is_str(batch_error)) {
+        string message = yyjson_get_str(batch_error);
+        yyjson_doc_free(resp_doc);
+        fail_remote(message);
+        return tables;
     }
 
-    // Get headers
-    yyjson_val *headers_arr = yyjson_obj_get(table_root, "headers");
-    if (headers_arr && yyjson_is_arr(headers_arr)) {
+    yyjson_val *results = yyjson_obj_get(resp_root, "results");
+    if (results && yyjson_is_arr(results)) {
         size_t idx, max_idx;
-        yyjson_val *val;
-        yyjson_arr_foreach(headers_arr, idx, max_idx, val) {
-            if (yyjson_is_str(val)) {
-                bind_data.headers.push_back(yyjson_get_str(val));
-            } else {
-                bind_data.headers.push_back("");
+        yyjson_val *item;
+        yyjson_arr_foreach(results, idx, max_idx, item) {
+            yyjson_val *url_val = yyjson_obj_get(item, "url");
+            if (!url_val || !yyjson_is_str(url_val)) continue;
+
+            // Rust completes requests out of order; map each result back to its slot
+            auto pos_it = positions.find(yyjson_get_str(url_val));
+            if (pos_it == positions.end() || pos_it->second.empty()) continue;
+            auto &table = *tables[pos_it->second.front()];
+            pos_it->second.erase(pos_it->second.begin());
+            table.error.clear();
+
+            // Check for error
+            yyjson_val *error_val = yyjson_obj_get(item, "error");
+            if (error_val && yyjson_is_str(error_val)) {
+                table.error = yyjson_get_str(error_val);
+                continue;
             }
+
+            // Get body
+            yyjson_val *body_val = yyjson_obj_get(item, "body");
+            if (!body_val || !yyjson_is_str(body_val)) {
+                table.error = "No body in response";
+                continue;
+            }
+
+            string html(yyjson_get_str(body_val), yyjson_get_len(body_val));
+            ExtractTableFromHtml(html, bind_data, table);
         }
     }
 
-    // Get rows
-    yyjson_val *rows_arr = yyjson_obj_get(table_root, "rows");
-    if (rows_arr && yyjson_is_arr(rows_arr)) {
-        size_t row_idx, row_max;
-        yyjson_val *row_val;
-        yyjson_arr_foreach(rows_arr, row_idx, row_max, row_val) {
-            if (!yyjson_is_arr(row_val)) continue;
+    yyjson_doc_free(resp_doc);
+    return tables;
+}
 
-            vector<string> row;
-            size_t col_idx, col_max;
-            yyjson_val *cell_val;
-            yyjson_arr_foreach(row_val, col_idx, col_max, cell_val) {
-                if (yyjson_is_str(cell_val)) {
-                    row.push_back(yyjson_get_str(cell_val));
-                } else {
-                    row.push_back("");
-                }
+//===--------------------------------------------------------------------===//
+// Helper: Resolve URLs from a source query
+//===--------------------------------------------------------------------===//
+
+static vector<string> RunUrlQuery(ClientContext &context, const string &query) {
+    vector<string> urls;
+    Connection conn(*context.db);
+    auto query_result = conn.Query(query);
+    if (query_result->HasError()) {
+        throw IOException("read_html source query error: " + query_result->GetError());
+    }
+    while (auto chunk = query_result->Fetch()) {
+        for (idx_t i = 0; i < chunk->size(); i++) {
+            auto val = chunk->GetValue(0, i);
+            if (!val.IsNull()) {
+                urls.push_back(val.ToString());
             }
-            bind_data.rows.push_back(std::move(row));
         }
     }
-
-    bind_data.num_columns = bind_data.headers.size();
-    bind_data.num_rows = bind_data.rows.size();
-
-    yyjson_doc_free(table_doc);
+    return urls;
 }
 
 //===--------------------------------------------------------------------===//
 // Type Inference Helpers
 //===--------------------------------------------------------------------===//
 
-// Try to parse string as integer
-static bool TryParseBigInt(const string &str, int64_t &result) {
-    if (str.empty()) return true;  // Empty is compatible with any type
-
-    char *end;
-    errno = 0;
-    long long val = strtoll(str.c_str(), &end, 10);
+// Candidate types tried (in order) against the sampled cells of a column.
+// Casting goes through DuckDB's own vectorized VARCHAR casts, the same
+// machinery the CSV sniffer relies on, so DATE/TIMESTAMP formats match.
+static const LogicalTypeId INFERENCE_CANDIDATES[] = {
+    LogicalTypeId::BIGINT, LogicalTypeId::DOUBLE, LogicalTypeId::DATE, LogicalTypeId::TIMESTAMP
+};
 
-    // Must consume entire string (no trailing chars except whitespace)
-    while (*end && isspace(*end)) end++;
-    if (*end != '\0' || errno == ERANGE) return false;
+// Cells per column examined during inference (one vector)
+static constexpr idx_t INFERENCE_SAMPLE_ROWS = STANDARD_VECTOR_SIZE;
 
-    result = static_cast<int64_t>(val);
-    return true;
+// Skip a UTF-8 sequence from a fixed list at the start of str[pos..], returning bytes consumed
+static idx_t MatchAny(const string &str, idx_t pos, std::initializer_list<const char *> needles) {
+    for (auto needle : needles) {
+        idx_t len = strlen(needle);
+        if (str.compare(pos, len, needle) == 0) {
+            return len;
+        }
+    }
+    return 0;
 }
 
-// Try to parse string as double
-static bool TryParseDouble(const string &str, double &result) {
-    if (str.empty()) return true;  // Empty is compatible with any type
-
-    char *end;
-    errno = 0;
-    double val = strtod(str.c_str(), &end);
+// True if str[pos..] starts with exactly three digits
+static bool IsDigitGroup(const string &str, idx_t pos) {
+    for (idx_t i = pos; i < pos + 3; i++) {
+        if (i >= str.size() || !isdigit(static_cast<unsigned char>(str[i]))) return false;
+    }
+    return pos + 3 >= str.size() || !isdigit(static_cast<unsigned char>(str[pos + 3]));
+}
 
-    // Must consume entire string (no trailing chars except whitespace)
-    while (*end && isspace(*end)) end++;
-    if (*end != '\0' || errno == ERANGE) return false;
+// Normalize a locale-formatted number to plain "[-]digits[.digits]".
+// Handles currency symbols, thousand separators (',', '.', '\'', spaces/NBSP),
+// decimal commas and accounting negatives "(123)". Returns false when the
+// value is not a formatted number, so the column stays VARCHAR.
+static bool NormalizeNumber(const string &input, string &out, bool &has_currency, idx_t &scale) {
+    out.clear();
+    bool negative = false;
+    bool in_parens = false;
+    string body;  // digits plus raw ',' / '.' separators
+    idx_t pos = 0;
+    while (pos < input.size()) {
+        char c = input[pos];
+        if (c >= '0' && c <= '9') {
+            body += c;
+            pos++;
+        } else if (c == ',' || c == '.') {
+            body += c;
+            pos++;
+        } else if (c == ' ' || c == '\t' || c == '\'') {
+            // Inner spaces/apostrophes only count as grouping before exactly three digits ("1 234", "1'234")
+            if (!body.empty() && pos + 1 < input.size() && !IsDigitGroup(input, pos + 1)) return false;
+            pos++;
+        } else if (c == '-' && body.empty() && !negative) {
+            negative = true;
+            pos++;
+        } else if (c == '(' && body.empty() && !in_parens) {
+            in_parens = true;
+            pos++;
+        } else if (c == ')' && in_parens) {
+            in_parens = false;
+            negative = true;
+            pos++;
+        } else if (c == '$') {
+            has_currency = true;
+            pos++;
+        } else if (idx_t currency_len = MatchAny(input, pos, {"\xe2\x82\xac", "\xc2\xa3", "\xc2\xa5", "\xe2\x82\xb9"})) {
+            has_currency = true;  // EUR, GBP, JPY, INR
+            pos += currency_len;
+        } else if (idx_t space_len = MatchAny(input, pos, {"\xc2\xa0", "\xe2\x80\xaf", "\xe2\x80\x89"})) {
+            pos += space_len;  // NBSP, narrow NBSP, thin space used as thousand separators
+        } else if (idx_t minus_len = MatchAny(input, pos, {"\xe2\x88\x92"})) {
+            if (!body.empty() || negative) return false;
+            negative = true;  // Unicode minus sign
+            pos += minus_len;
+        } else {
+            return false;
+        }
+    }
+    if (in_parens || body.empty()) return false;
+
+    // Decide which separator (if any) is the decimal point
+    auto last_comma = body.rfind(',');
+    auto last_dot = body.rfind('.');
+    char decimal = 0;
+    if (last_comma != string::npos && last_dot != string::npos) {
+        decimal = last_comma > last_dot ? ',' : '.';
+    } else if (last_dot != string::npos) {
+        // Several dots are grouping ("1.234.567"), a single one is a decimal point
+        decimal = body.find('.') == last_dot ? '.' : 0;
+    } else if (last_comma != string::npos) {
+        // A single comma followed by exactly three digits is grouping ("1,234"), otherwise decimal ("3,5")
+        decimal = (body.find(',') == last_comma && body.size() - last_comma - 1 != 3) ? ',' : 0;
+    }
 
-    result = val;
-    return true;
+    // At most one decimal separator, with only digits after it
+    idx_t int_end = body.size();
+    if (decimal) {
+        int_end = decimal == ',' ? last_comma : last_dot;
+        if (body.find(decimal) != int_end) return false;
+        for (idx_t i = int_end + 1; i < body.size(); i++) {
+            if (body[i] < '0' || body[i] > '9') return false;
+        }
+    }
+    // Grouping in the integer part: 1-3 leading digits, then groups of exactly three
+    // behind one separator kind ("1.2.3", "10.0.0.1" and "01.02.2023" are not numbers)
+    char group = 0;
+    idx_t digits_in_group = 0;
+    for (idx_t i = 0; i < int_end; i++) {
+        char c = body[i];
+        if (c >= '0' && c <= '9') {
+            digits_in_group++;
+            continue;
+        }
+        if ((group && c != group) || digits_in_group == 0 || (group && digits_in_group != 3) ||
+            (!group && digits_in_group > 3)) {
+            return false;
+        }
+        group = c;
+        digits_in_group = 0;
+    }
+    if (group && digits_in_group != 3) return false;
+
+    if (negative) out += '-';
+    bool seen_digit = false;
+    scale = 0;
+    bool after_decimal = false;
+    for (idx_t i = 0; i < body.size(); i++) {
+        char c = body[i];
+        if (c == decimal && (decimal == ',' ? i == last_comma : i == last_dot)) {
+            out += '.';
+            after_decimal = true;
+        } else if (c >= '0' && c <= '9') {
+            out += c;
+            seen_digit = true;
+            if (after_decimal) scale++;
+        }
+        // Remaining separators are grouping characters and are dropped
+    }
+    return seen_digit;
 }
 
-// Infer column types based on all values
-static void InferColumnTypes(ReadHtmlBindData &bind_data) {
-    bind_data.column_types.resize(bind_data.num_columns, InferredType::BIGINT);  // Start optimistic
-
-    for (idx_t col = 0; col < bind_data.num_columns; col++) {
-        bool all_integers = true;
-        bool all_doubles = true;
-        bool has_non_empty = false;
+// True if every valid entry of source casts to target_type
+static bool CanCastAll(ClientContext &context, Vector &source, idx_t count, const LogicalType &target_type) {
+    Vector result(target_type, count);
+    string error_message;
+    return VectorOperations::TryCast(context, source, result, count, &error_message, true);
+}
 
-        for (const auto &row : bind_data.rows) {
-            if (col >= row.size()) continue;
-            const string &val = row[col];
-            if (val.empty()) continue;
+// Infer the type of one column from the sampled pages. Sets normalize when
+// values only cast after locale normalization (e.g. "$1,234.50").
+static LogicalType InferColumnType(ClientContext &context, const ReadHtmlBindData &bind_data, idx_t col,
+                                   bool &normalize) {
+    normalize = false;
 
-            has_non_empty = true;
+    // Gather non-empty sample cells; string_t references the sample tables directly
+    Vector raw(LogicalType::VARCHAR, INFERENCE_SAMPLE_ROWS);
+    auto raw_data = FlatVector::GetData<string_t>(raw);
+    idx_t count = 0;
+    for (const auto &table : bind_data.sample_tables) {
+        for (idx_t row = 0; row < table->NumRows() && count < INFERENCE_SAMPLE_ROWS; row++) {
+            auto cell = table->Cell(row, col);
+            if (cell.GetSize() > 0) {
+                raw_data[count++] = cell;
+            }
+        }
+    }
+    if (count == 0) {
+        return LogicalType::VARCHAR;  // All empty - keep as VARCHAR
+    }
 
-            int64_t int_val;
-            double dbl_val;
+    for (auto candidate : INFERENCE_CANDIDATES) {
+        if (CanCastAll(context, raw, count, LogicalType(candidate))) {
+            return LogicalType(candidate);
+        }
+    }
 
-            if (!TryParseBigInt(val, int_val)) {
-                all_integers = false;
-            }
-            if (!TryParseDouble(val, dbl_val)) {
-                all_doubles = false;
-            }
+    // Retry numeric types on locale-normalized values
+    Vector normalized(LogicalType::VARCHAR, INFERENCE_SAMPLE_ROWS);
+    auto norm_data = FlatVector::GetData<string_t>(normalized);
+    bool has_currency = false;
+    idx_t max_scale = 0;
+    string buffer;
+    for (idx_t i = 0; i < count; i++) {
+        idx_t scale = 0;
+        if (!NormalizeNumber(raw_data[i].GetString(), buffer, has_currency, scale)) {
+            return LogicalType::VARCHAR;
+        }
+        max_scale = MaxValue(max_scale, scale);
+        norm_data[i] = StringVector::AddString(normalized, buffer);
+    }
 
-            // Early exit if neither works
-            if (!all_integers && !all_doubles) {
-                break;
-            }
+    normalize = true;
+    if (has_currency && max_scale <= 4) {
+        // Money: keep exact cents instead of binary floating point
+        auto money_type = LogicalType::DECIMAL(18, MaxValue<idx_t>(max_scale, 2));
+        if (CanCastAll(context, normalized, count, money_type)) {
+            return money_type;
         }
+    }
+    if (CanCastAll(context, normalized, count, LogicalType::BIGINT)) {
+        return LogicalType::BIGINT;
+    }
+    if (CanCastAll(context, normalized, count, LogicalType::DOUBLE)) {
+        return LogicalType::DOUBLE;
+    }
+    normalize = false;
+    return LogicalType::VARCHAR;
+}
 
-        // Determine final type
-        if (!has_non_empty) {
-            // All empty - keep as VARCHAR
-            bind_data.column_types[col] = InferredType::VARCHAR;
-        } else if (all_integers) {
-            bind_data.column_types[col] = InferredType::BIGINT;
-        } else if (all_doubles) {
-            bind_data.column_types[col] = InferredType::DOUBLE;
-        } else {
-            bind_data.column_types[col] = InferredType::VARCHAR;
+// Infer column types from the sampled pages
+static void InferColumnTypes(ClientContext &context, ReadHtmlBindData &bind_data) {
+    bind_data.column_types.clear();
+    bind_data.normalize_numbers.clear();
+    for (idx_t col = 0; col < bind_data.num_columns; col++) {
+        bool normalize = false;
+        bind_data.column_types.push_back(InferColumnType(context, bind_data, col, normalize));
+        bind_data.normalize_numbers.push_back(normalize);
+    }
+}
+
+// Sanitize header name for SQL compatibility
+static string SanitizeColumnName(const string &header, idx_t position) {
+    string col_name = header;
+    if (col_name.empty()) {
+        col_name = "column" + std::to_string(position + 1);
+    }
+    // Replace spaces and special chars with underscores
+    for (auto &c : col_name) {
+        if (c == ' ' || c == '-' || c == '/' || c == '\\' || c == '(' || c == ')' || c == ',') {
+            c = '_';
         }
     }
+    return col_name;
 }
 
 //===--------------------------------------------------------------------===//
@@ -471,12 +719,29 @@ static unique_ptr<FunctionData> ReadHtmlBind(ClientContext &context,
                                                 vector<LogicalType> &return_types,
                                                 vector<string> &names) {
     auto bind_data = make_uniq<ReadHtmlBindData>();
+    bind_data->extract_budget = ExtractionBudget::FromSettings(context).ToJson();
 
-    // First argument: URL
+    // First argument: URL, list of URLs, or a query returning URLs
     if (input.inputs[0].IsNull()) {
         throw BinderException("read_html() requires a URL argument");
     }
-    bind_data->url = StringValue::Get(input.inputs[0]);
+    bool single_url = false;
+    auto &first_arg = input.inputs[0];
+    if (first_arg.type().id() == LogicalTypeId::LIST) {
+        for (auto &url_val : ListValue::GetChildren(first_arg)) {
+            if (!url_val.IsNull()) {
+                bind_data->urls.push_back(StringValue::Get(url_val));
+            }
+        }
+    } else {
+        string arg = StringValue::Get(first_arg);
+        if (IsUrlQuery(arg)) {
+            bind_data->source_query = arg;
+        } else {
+            bind_data->urls.push_back(arg);
+            single_url = true;
+        }
+    }
 
     // Second argument: CSS selector
     if (input.inputs.size() < 2 || input.inputs[1].IsNull()) {
@@ -494,55 +759,81 @@ static unique_ptr<FunctionData> ReadHtmlBind(ClientContext &context,
     }
 
     // Named parameters
+    Value columns_value;
     for (auto &kv : input.named_parameters) {
         if (kv.first == "user_agent") {
             bind_data->user_agent = StringValue::Get(kv.second);
         } else if (kv.first == "timeout") {
             bind_data->timeout_ms = kv.second.GetValue<int>() * 1000;
+        } else if (kv.first == "concurrency") {
+            bind_data->concurrency = std::max(kv.second.GetValue<int>(), 1);
+        } else if (kv.first == "sample_size") {
+            bind_data->sample_size = static_cast<idx_t>(std::max<int64_t>(kv.second.GetValue<int64_t>(), 1));
+        } else if (kv.first == "ignore_errors") {
+            bind_data->ignore_errors = kv.second.GetValue<bool>();
+        } else if (kv.first == "columns") {
+            columns_value = kv.second;
         }
     }
 
-    // Fetch and extract table during bind to determine schema
-    FetchAndExtractTable(*bind_data);
-
-    if (!bind_data->error.empty()) {
-        throw BinderException("read_html() failed: " + bind_data->error);
-    }
-
-    if (bind_data->num_columns == 0) {
-        throw BinderException("read_html() found no columns in the table");
-    }
-
-    // Infer column types based on data
-    InferColumnTypes(*bind_data);
-
-    // Define columns based on extracted headers and inferred types
-    for (idx_t i = 0; i < bind_data->headers.size(); i++) {
-        // Sanitize header name for SQL compatibility
-        string col_name = bind_data->headers[i];
-        if (col_name.empty()) {
-            col_name = "column" + std::to_string(names.size() + 1);
+    if (!columns_value.IsNull()) {
+        // Explicit schema: nothing is fetched at bind time
+        if (columns_value.type().id() != LogicalTypeId::STRUCT) {
+            throw BinderException("read_html() columns must be a struct, e.g. {'name': 'VARCHAR', 'year': 'BIGINT'}");
+        }
+        auto &child_types = StructType::GetChildTypes(columns_value.type());
+        auto &child_values = StructValue::GetChildren(columns_value);
+        for (idx_t i = 0; i < child_types.size(); i++) {
+            auto column_type = TransformStringToLogicalType(child_values[i].ToString(), context);
+            bind_data->headers.push_back(child_types[i].first);
+            bind_data->column_types.push_back(column_type);
+            // Declared numeric columns accept locale-formatted cells ("1,234", "$5.00")
+            bind_data->normalize_numbers.push_back(column_type.IsNumeric());
         }
-        // Replace spaces and special chars with underscores
-        for (auto &c : col_name) {
-            if (c == ' ' || c == '-' || c == '/' || c == '\\' || c == '(' || c == ')' || c == ',') {
-                c = '_';
+        bind_data->num_columns = bind_data->headers.size();
+        if (bind_data->num_columns == 0) {
+            throw BinderException("read_html() columns must define at least one column");
+        }
+    } else {
+        // Infer schema from a bounded sample of pages
+        if (!bind_data->source_query.empty()) {
+            bind_data->urls = RunUrlQuery(context, bind_data->source_query);
+            bind_data->source_query.clear();
+        }
+        idx_t sample_count = MinValue<idx_t>(bind_data->sample_size, bind_data->urls.size());
+        vector<string> sample_urls(bind_data->urls.begin(), bind_data->urls.begin() + sample_count);
+        CrawlCancelToken cancel_token(&context.interrupted);
+        bind_data->sample_tables = FetchTables(context, sample_urls, *bind_data, cancel_token);
+        bind_data->sampled_urls = sample_count;
+
+        for (auto &table : bind_data->sample_tables) {
+            if (!table->error.empty()) {
+                if (single_url) {
+                    throw BinderException("read_html() failed: " + table->error);
+                }
+                if (!bind_data->ignore_errors) {
+                    throw BinderException("read_html() failed for %s: %s", table->url, table->error);
+                }
+                continue;
+            }
+            if (bind_data->headers.empty() && !table->headers.empty()) {
+                bind_data->headers = table->headers;
             }
         }
-        names.push_back(col_name);
+        bind_data->num_columns = bind_data->headers.size();
 
-        // Use inferred type
-        switch (bind_data->column_types[i]) {
-            case InferredType::BIGINT:
-                return_types.push_back(LogicalType::BIGINT);
-                break;
-            case InferredType::DOUBLE:
-                return_types.push_back(LogicalType::DOUBLE);
-                break;
-            default:
-                return_types.push_back(LogicalType::VARCHAR);
-                break;
+        if (bind_data->num_columns == 0) {
+            throw BinderException("read_html() found no columns in the table");
         }
+
+        // Infer column types based on data
+        InferColumnTypes(context, *bind_data);
+    }
+
+    // Define columns based on headers and types
+    for (idx_t i = 0; i < bind_data->num_columns; i++) {
+        names.push_back(SanitizeColumnName(bind_data->headers[i], i));
+        return_types.push_back(bind_data->column_types[i]);
     }
 
     return std::move(bind_data);
@@ -554,59 +845,149 @@ static unique_ptr<FunctionData> ReadHtmlBind(ClientContext &context,
 
 static unique_ptr<GlobalTableFunctionState> ReadHtmlInitGlobal(ClientContext &context,
                                                                    TableFunctionInitInput &input) {
-    return make_uniq<ReadHtmlGlobalState>();
+    auto state = make_uniq<ReadHtmlGlobalState>();
+    state->cancel_token = make_uniq<CrawlCancelToken>(&context.interrupted);
+    return std::move(state);
 }
 
 //===--------------------------------------------------------------------===//
 // Table Function
 //===--------------------------------------------------------------------===//
 
-static void ReadHtmlFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
-    auto &bind_data = data.bind_data->Cast<ReadHtmlBindData>();
-    auto &state = data.global_state->Cast<ReadHtmlGlobalState>();
+// A row of a queued page, gathered into the current output chunk
+struct RowRef {
+    const HtmlTable *table;
+    idx_t row;
+};
 
-    idx_t count = 0;
-    while (count < STANDARD_VECTOR_SIZE && state.current_row < bind_data.num_rows) {
-        const auto &row = bind_data.rows[state.current_row++];
+// Convert one column of the gathered rows into the output vector, column-at-a-time
+static void ConvertColumn(ClientContext &context, const ReadHtmlBindData &bind_data, idx_t col,
+                          const vector<RowRef> &rows, const vector<std::shared_ptr<HtmlTable>> &chunk_tables,
+                          Vector &result) {
+    idx_t count = rows.size();
+
+    // VARCHAR columns point straight at the page's cell memory; the pages are
+    // attached to the vector so they outlive this chunk
+    if (bind_data.column_types[col].id() == LogicalTypeId::VARCHAR) {
+        auto result_data = FlatVector::GetData<string_t>(result);
+        for (idx_t i = 0; i < count; i++) {
+            auto cell = rows[i].table->Cell(rows[i].row, col);
+            if (cell.GetSize() == 0) {
+                FlatVector::SetNull(result, i, true);  // NULL for missing/empty cells
+            } else {
+                result_data[i] = cell;
+            }
+        }
+        for (auto &table : chunk_tables) {
+            StringVector::AddBuffer(result, make_buffer<HtmlTableBuffer>(table));
+        }
+        return;
+    }
 
-        // Output each cell with proper type conversion
-        for (idx_t col = 0; col < bind_data.num_columns; col++) {
-            if (col >= row.size() || row[col].empty()) {
-                output.SetValue(col, count, Value());  // NULL for missing/empty cells
-                continue;
+    // Typed columns: build a VARCHAR vector over the cells, then cast it in a single pass
+    Vector source(LogicalType::VARCHAR, count);
+    auto source_data = FlatVector::GetData<string_t>(source);
+    bool normalize = bind_data.normalize_numbers[col];
+    string buffer;
+    for (idx_t i = 0; i < count; i++) {
+        auto cell = rows[i].table->Cell(rows[i].row, col);
+        if (cell.GetSize() == 0) {
+            FlatVector::SetNull(source, i, true);
+            continue;
+        }
+        bool has_currency = false;
+        idx_t scale = 0;
+        if (normalize && NormalizeNumber(cell.GetString(), buffer, has_currency, scale)) {
+            source_data[i] = StringVector::AddString(source, buffer);
+        } else {
+            source_data[i] = cell;
+        }
+    }
+
+    // The type came from a sample (or the columns parameter), so later cells may not fit
+    // it. Failing beats silently turning them into NULL; ignore_errors opts into the NULLs.
+    string error_message;
+    if (!VectorOperations::TryCast(context, source, result, count, &error_message, true) &&
+        !bind_data.ignore_errors) {
+        throw InvalidInputException("read_html() column \"%s\": %s. Declare the column with columns := {...}, "
+                                    "or pass ignore_errors := true to read such cells as NULL",
+                                    bind_data.headers[col], error_message);
+    }
+}
+
+// Fetch the next batch of pages into the table queue. Returns false when no URLs remain.
+static bool FetchNextBatch(ClientContext &context, const ReadHtmlBindData &bind_data, ReadHtmlGlobalState &state) {
+    if (state.next_url >= state.urls.size() || state.cancel_token->IsCancelled()) {
+        return false;
+    }
+
+    // A few URLs per worker keeps every connection busy without holding many pages in memory
+    idx_t batch_size = static_cast<idx_t>(bind_data.concurrency) * 4;
+    idx_t end = MinValue<idx_t>(state.next_url + batch_size, state.urls.size());
+    vector<string> batch(state.urls.begin() + state.next_url, state.urls.begin() + end);
+    state.next_url = end;
+
+    for (auto &table : FetchTables(context, batch, bind_data, *state.cancel_token)) {
+        if (!table->error.empty()) {
+            if (!bind_data.ignore_errors) {
+                throw IOException("read_html() failed for %s: %s", table->url, table->error);
             }
+            continue;
+        }
+        state.tables.push_back(std::move(table));
+    }
+    return true;
+}
 
-            const string &val = row[col];
+static void ReadHtmlFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &bind_data = data.bind_data->Cast<ReadHtmlBindData>();
+    auto &state = data.global_state->Cast<ReadHtmlGlobalState>();
 
-            switch (bind_data.column_types[col]) {
-                case InferredType::BIGINT: {
-                    int64_t int_val;
-                    if (TryParseBigInt(val, int_val)) {
-                        output.SetValue(col, count, Value::BIGINT(int_val));
-                    } else {
-                        output.SetValue(col, count, Value());  // NULL on parse failure
-                    }
-                    break;
-                }
-                case InferredType::DOUBLE: {
-                    double dbl_val;
-                    if (TryParseDouble(val, dbl_val)) {
-                        output.SetValue(col, count, Value::DOUBLE(dbl_val));
-                    } else {
-                        output.SetValue(col, count, Value());  // NULL on parse failure
-                    }
-                    break;
-                }
-                default:
-                    output.SetValue(col, count, Value(val));
-                    break;
+    // Initialize on first call: emit sampled pages first, then fetch the rest
+    if (!state.initialized) {
+        state.initialized = true;
+        for (const auto &table : bind_data.sample_tables) {
+            if (table->error.empty()) {
+                state.tables.push_back(table);
             }
         }
+        if (!bind_data.source_query.empty()) {
+            state.urls = RunUrlQuery(context, bind_data.source_query);
+        } else {
+            state.urls.assign(bind_data.urls.begin() + bind_data.sampled_urls, bind_data.urls.end());
+        }
+    }
 
-        count++;
+    // Gather up to a vector's worth of rows across the queued pages
+    vector<RowRef> rows;
+    vector<std::shared_ptr<HtmlTable>> chunk_tables;
+    rows.reserve(STANDARD_VECTOR_SIZE);
+    while (rows.size() < STANDARD_VECTOR_SIZE) {
+        if (state.tables.empty()) {
+            if (!FetchNextBatch(context, bind_data, state)) {
+                break;
+            }
+            continue;
+        }
+        auto &table = state.tables.front();
+        if (state.current_row >= table->NumRows()) {
+            state.tables.pop_front();
+            state.current_row = 0;
+            continue;
+        }
+        if (chunk_tables.empty() || chunk_tables.back() != table) {
+            chunk_tables.push_back(table);
+        }
+        rows.push_back({table.get(), state.current_row++});
     }
 
-    output.SetCardinality(count);
+    // Pages are unioned by column position; extra cells are dropped, missing ones are NULL
+    if (!rows.empty()) {
+        for (idx_t col = 0; col < bind_data.num_columns; col++) {
+            ConvertColumn(context, bind_data, col, rows, chunk_tables, output.data[col]);
+        }
+    }
+    output.SetCardinality(rows.size());
 }
 
 //===--------------------------------------------------------------------===//
@@ -614,28 +995,34 @@ static void ReadHtmlFunction(ClientContext &context, TableFunctionInput &data, D
 //===--------------------------------------------------------------------===//
 
 void RegisterReadHtmlFunction(ExtensionLoader &loader) {
-    // 2-argument version: read_html(url, selector)
-    TableFunction read_html_func("read_html",
-                                   {LogicalType::VARCHAR, LogicalType::VARCHAR},
-                                   ReadHtmlFunction,
-                                   ReadHtmlBind,
-                                   ReadHtmlInitGlobal);
+    auto add_params = [](TableFunction &func) {
+        func.named_parameters["user_agent"] = LogicalType::VARCHAR;
+        func.named_parameters["timeout"] = LogicalType::INTEGER;
+        func.named_parameters["concurrency"] = LogicalType::INTEGER;
+        func.named_parameters["sample_size"] = LogicalType::INTEGER;
+        func.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+        func.named_parameters["columns"] = LogicalType::ANY;
+    };
+
+    // First argument: single URL / URL query (VARCHAR) or list of URLs
+    vector<LogicalType> first_arg_types = {LogicalType::VARCHAR, LogicalType::LIST(LogicalType::VARCHAR)};
+
+    TableFunctionSet read_html_set("read_html");
+    for (auto &first_arg : first_arg_types) {
+        // 2-argument version: read_html(url, selector)
+        TableFunction read_html_func("read_html", {first_arg, LogicalType::VARCHAR},
+                                     ReadHtmlFunction, ReadHtmlBind, ReadHtmlInitGlobal);
+        add_params(read_html_func);
+        read_html_set.AddFunction(read_html_func);
+
+        // 3-argument version: read_html(url, selector, table_index) - like Google Sheets IMPORTHTML
+        TableFunction read_html_func_idx("read_html", {first_arg, LogicalType::VARCHAR, LogicalType::INTEGER},
+                                         ReadHtmlFunction, ReadHtmlBind, ReadHtmlInitGlobal);
+        add_params(read_html_func_idx);
+        read_html_set.AddFunction(read_html_func_idx);
+    }
 
-    // Named parameters
-    read_html_func.named_parameters["user_agent"] = LogicalType::VARCHAR;
-    read_html_func.named_parameters["timeout"] = LogicalType::INTEGER;
-
-    // 3-argument version: read_html(url, selector, table_index) - like Google Sheets IMPORTHTML
-    TableFunction read_html_func_idx("read_html",
-                                      {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::INTEGER},
-                                      ReadHtmlFunction,
-                                      ReadHtmlBind,
-                                      ReadHtmlInitGlobal);
-    read_html_func_idx.named_parameters["user_agent"] = LogicalType::VARCHAR;
-    read_html_func_idx.named_parameters["timeout"] = LogicalType::INTEGER;
-
-    loader.RegisterFunction(read_html_func);
-    loader.RegisterFunction(read_html_func_idx);
+    loader.RegisterFunction(read_html_set);
 }
 
 } // namespace duckdb
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Version history of crawled bodies, keyed by SURT key
+static constexpr const char *VERSIONS_TABLE_NAME = "__crawler_versions";
+
+// A full keyframe is stored at least every this many versions of a URL
+static constexpr int64_t DEFAULT_KEYFRAME_INTERVAL = 16;
+
+//===--------------------------------------------------------------------===//
+// Delta Codec
+//===--------------------------------------------------------------------===//
+
+// Binary delta turning `base` into `target`: copies of base ranges (found via 16-byte
+// block matches) plus literal bytes. Small edits to a large page encode in a few bytes.
+string EncodeBodyDelta(const string &base, const string &target);
+
+// Rebuild the target from `base` and a delta from EncodeBodyDelta. Returns false if the
+// delta is malformed or does not belong to `base`.
+bool ApplyBodyDelta(const string &base, const string &delta, string &target);
+
+//===--------------------------------------------------------------------===//
+// Version Storage
+//===--------------------------------------------------------------------===//
+
+// Create __crawler_versions if it does not exist yet
+void EnsureVersionsTable(Connection &conn);
+
+// Body versioning settings (crawler_body_versions, crawler_version_keyframe_interval)
+bool IsBodyVersioningEnabled(ClientContext &context);
+int64_t GetKeyframeInterval(ClientContext &context);
+
+// Append `body` (whose XXH3-128 hex hash is content_hash) as the next version of `url`
+// unless it equals the latest version. Stored as a delta against the previous version,
+// or as a keyframe every keyframe_interval versions and whenever the delta would not
+// save at least half. Returns the version number written, or 0 if nothing was.
+int64_t RecordBodyVersion(Connection &conn, const string &url, const string &body, const string &content_hash,
+                          int64_t keyframe_interval);
+
+// Record a crawled body if versioning is enabled for the context (successful, non-empty responses only)
+void MaybeRecordBodyVersion(ClientContext &context, const string &url, int status_code, const string &body,
+                            const string &content_hash);
+
+} // namespace duckdb
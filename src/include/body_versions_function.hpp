@@ -0,0 +1,11 @@
+#pragma once
+
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Register crawl_body_versions(url, as_of) for reading __crawler_versions, and
+// crawl_record_body_version(url, body) for appending to it
+void RegisterBodyVersionsFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Register crawler_cache_vacuum() for __crawler_cache maintenance
+void RegisterCacheVacuumFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
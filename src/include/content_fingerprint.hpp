@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Exact Content Hash
+//===--------------------------------------------------------------------===//
+
+struct ContentHash128 {
+	uint64_t low = 0;
+	uint64_t high = 0;
+
+	bool operator==(const ContentHash128 &other) const {
+		return low == other.low && high == other.high;
+	}
+
+	// 32 lowercase hex digits, high half first (canonical XXH128 form)
+	std::string ToHex() const;
+};
+
+// XXH3-128 (seed 0) of a byte range. Stable across platforms, builds and processes,
+// so the result can be persisted and compared between crawls.
+ContentHash128 HashContent128(const char *data, size_t len);
+
+//===--------------------------------------------------------------------===//
+// Near-Duplicate Fingerprint
+//===--------------------------------------------------------------------===//
+
+// Documents with fewer word shingles than this get no SimHash (too little text to compare)
+static constexpr size_t SIMHASH_MIN_SHINGLES = 16;
+
+// 64-bit SimHash over 3-word shingles of the visible text of an HTML document
+// (tags, comments, script/style/template content and entities are skipped).
+// Pages that differ only in small regions (rotating ads, timestamps) are a few bits apart.
+// Returns false if the document has fewer than SIMHASH_MIN_SHINGLES shingles.
+bool SimHashFingerprint(const std::string &html, uint64_t &fingerprint);
+
+// Number of differing bits between two fingerprints
+int HammingDistance64(uint64_t a, uint64_t b);
+
+//===--------------------------------------------------------------------===//
+// Near-Duplicate Index
+//===--------------------------------------------------------------------===//
+
+// Finds earlier documents with the same content hash or a SimHash within max_distance bits.
+// Fingerprints are split into max_distance + 1 bands; by the pigeonhole principle a match
+// agrees exactly on at least one band, so lookups only compare the band's candidates.
+// Not thread-safe.
+class NearDuplicateIndex {
+public:
+	static constexpr int MAX_DISTANCE = 7;
+
+	explicit NearDuplicateIndex(int max_distance = 3);
+
+	// Return the URL of an earlier exact or near duplicate, or an empty string after
+	// recording this document under `url`
+	std::string FindOrInsert(const std::string &url, const ContentHash128 &hash, bool has_simhash,
+	                         uint64_t simhash);
+
+	size_t Size() const { return exact_.size(); }
+
+private:
+	struct HashKey {
+		size_t operator()(const ContentHash128 &hash) const { return static_cast<size_t>(hash.low); }
+	};
+
+	uint64_t BandKey(uint64_t simhash, int band) const;
+
+	int max_distance_;
+	int num_bands_;
+	std::unordered_map<ContentHash128, std::string, HashKey> exact_;
+	std::vector<std::pair<uint64_t, std::string>> documents_;  // (simhash, url)
+	std::vector<std::unordered_multimap<uint64_t, size_t>> bands_;  // band key -> documents_ index
+};
+
+} // namespace duckdb
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+// Resource budget of one crawl. Zero means unlimited.
+struct CrawlBudget {
+    int64_t max_duration_ms = 0;
+    int64_t max_bytes = 0;              // Response bytes fetched over the network
+    int64_t max_requests_per_host = 0;  // Network requests per host
+
+    bool IsLimited() const { return max_duration_ms > 0 || max_bytes > 0 || max_requests_per_host > 0; }
+
+    // Session defaults (crawler_max_duration, crawler_max_bytes, crawler_max_requests_per_host)
+    static CrawlBudget FromSettings(ClientContext &context);
+
+    // Apply a max_duration/max_bytes/max_requests_per_host named parameter.
+    // Returns false if `name` is not a budget parameter.
+    bool ApplyParameter(const string &function_name, const string &name, const Value &value);
+};
+
+// Tracks spending against a CrawlBudget; the clock starts at construction.
+// Once the duration or byte budget runs out no new request should be dispatched;
+// requests already in flight finish normally. Thread-safe.
+class CrawlBudgetTracker {
+public:
+    explicit CrawlBudgetTracker(const CrawlBudget &budget);
+
+    // Duration or byte budget spent (sticky)
+    bool Exhausted() const;
+
+    // Count one request against the host of `url`. Returns false, without counting,
+    // once that host's request budget is spent.
+    bool TryAcquireHost(const string &url);
+
+    void AddBytes(int64_t bytes) { bytes_.fetch_add(bytes, std::memory_order_relaxed); }
+
+private:
+    CrawlBudget budget_;
+    std::chrono::steady_clock::time_point deadline_;
+    std::atomic<int64_t> bytes_ {0};
+    mutable std::atomic<bool> exhausted_ {false};
+
+    std::mutex host_mutex_;
+    std::unordered_map<string, int64_t> host_requests_;
+};
+
+// Budget tracker for a crawl function call: the statement-wide tracker attached to the
+// pipeline (CRAWLING MERGE), else a private one if `budget` is limited, else nullptr
+std::shared_ptr<CrawlBudgetTracker> ResolveBudgetTracker(ClientContext &context, const CrawlBudget &budget);
+
+} // namespace duckdb
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Register crawl_due(budget) - URLs most worth recrawling now - and
+// crawl_record_change(url, body) - record a body fetched elsewhere
+void RegisterCrawlDueFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+#include <unordered_map>
+
+namespace duckdb {
+
+// URLs left unfetched when a crawl ran out of budget, keyed by crawl_id
+static constexpr const char *FRONTIER_TABLE_NAME = "__crawler_frontier";
+
+// A URL waiting in the crawl frontier, with the signals used to score it
+struct FrontierUrl {
+    string url;
+    int depth = 1;
+    Value sitemap_priority;  // DOUBLE 0..1 from the sitemap, NULL if unknown
+    Value lastmod_age_days;  // DOUBLE days since the sitemap lastmod, NULL if unknown
+    int64_t inlinks = 0;     // Links to this URL found on crawled pages
+    bool cache_prefetched = false;
+};
+
+// Days between a sitemap lastmod (W3C datetime or date) and now; NULL if unparseable
+Value LastmodAgeDays(ClientContext &context, const Value &lastmod);
+
+// How the frontier orders pending URLs
+enum class FrontierOrder : uint8_t {
+    FIFO,        // Discovery order (breadth-first for link following)
+    BEST_FIRST,  // Built-in score over depth, sitemap priority, lastmod recency and inlinks
+    EXPRESSION   // User SQL expression over the same signals
+};
+
+// Pending URLs of one crawl() call, highest score first (ties in discovery order).
+// Pushing a URL that is already pending counts an inlink and keeps its shallowest depth.
+// Not thread-safe.
+class CrawlFrontier {
+public:
+    // Built-in orders by name ('fifo', 'best_first'); anything else is a SQL expression
+    // over depth, sitemap_priority, lastmod_age_days, inlinks and url
+    CrawlFrontier(ClientContext &context, const string &order);
+
+    // Bind-time check that a priority expression is valid SQL over the frontier columns
+    static void ValidateOrder(ClientContext &context, const string &order);
+
+    // Score used by 'best_first': 1/depth + sitemap priority (0.5 if unknown)
+    //   + recency exp(-age/30 days) (0.25 if unknown) + ln(1 + inlinks) / 4
+    static double BestFirstScore(const FrontierUrl &url);
+
+    void Push(FrontierUrl url);
+    bool Pop(FrontierUrl &url);
+
+    // Pop every pending URL (in order) into `out`
+    void Drain(vector<FrontierUrl> &out);
+    idx_t Size() const { return index_.size(); }
+
+    // Up to n pending URLs not handed out by an earlier call, in current pop order.
+    // They are flagged cache_prefetched when popped.
+    vector<string> TakePrefetchWindow(idx_t n);
+
+private:
+    struct Slot {
+        FrontierUrl url;
+        double score = 0;
+        uint64_t seq = 0;
+        uint32_t version = 0;  // Bumped on rescore and release; older heap items are stale
+        bool dirty = false;    // Queued in dirty_ for expression scoring
+    };
+    struct HeapItem {
+        double score;
+        uint64_t seq;
+        idx_t slot;
+        uint32_t version;
+
+        // Max-heap on score, then earliest discovery
+        bool operator<(const HeapItem &other) const {
+            return score != other.score ? score < other.score : seq > other.seq;
+        }
+    };
+
+    static FrontierOrder ParseOrder(const string &order);
+    static string ScoreQuery(const string &expression);
+    void Schedule(idx_t slot_idx, double score);
+    void ScoreDirty();
+    bool IsLive(const HeapItem &item) const;
+
+    FrontierOrder order_;
+    string expression_;
+    unique_ptr<Connection> conn_;  // EXPRESSION only
+
+    vector<Slot> slots_;
+    vector<idx_t> free_slots_;
+    std::unordered_map<string, idx_t> index_;  // Pending URL -> slot
+    vector<HeapItem> heap_;
+    vector<idx_t> dirty_;                      // Slots awaiting (re)scoring
+    uint64_t next_seq_ = 0;
+};
+
+//===--------------------------------------------------------------------===//
+// Frontier Persistence
+//===--------------------------------------------------------------------===//
+
+// Create __crawler_frontier if it does not exist yet
+void EnsureFrontierTable(Connection &conn);
+
+// Persist unfetched URLs under crawl_id (replacing earlier rows for the same URLs)
+void SaveFrontier(Connection &conn, const string &crawl_id, const vector<FrontierUrl> &urls);
+
+// Return the URLs saved under crawl_id; they stay saved until ForgetSavedFrontierUrl
+vector<FrontierUrl> LoadSavedFrontier(Connection &conn, const string &crawl_id);
+
+// Drop one saved URL once a resumed run has fetched it
+void ForgetSavedFrontierUrl(Connection &conn, const string &crawl_id, const string &url);
+
+} // namespace duckdb
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Register the lease-based work queue table functions:
+//   crawl_queue_enqueue(urls)                       -> enqueued
+//   crawl_queue_claim(worker, n, shard, num_shards) -> url, host, attempts, lease_expires
+//   crawl_queue_heartbeat(worker)                   -> extended
+//   crawl_queue_complete(url, worker)               -> updated
+//   crawl_queue_fail(url, worker, error)            -> updated
+//   crawl_queue_reclaim()                           -> reclaimed
+void RegisterCrawlQueueFunctions(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -28,6 +28,7 @@ struct BatchCrawlEntry {
 	int status_code;
 	std::string body;
 	std::string content_type;
+	int64_t transfer_size = -1;  // Body bytes read off the connection, -1 if unknown
 	int64_t elapsed_ms;
 	std::string timestamp_expr;  // SQL expression for timestamp
 	std::string error;
@@ -63,6 +63,14 @@ bool IsValidCrawlUrl(const std::string &url);
 // Get validation error message for URL. Returns empty string if valid.
 std::string GetUrlValidationError(const std::string &url);
 
+// A VARCHAR URL argument is a query (SELECT/FROM/WITH/parenthesized) rather than a URL
+bool IsUrlQuery(const std::string &arg);
+
+// Normalize URL for use as a dedup/cache key: lowercase scheme and host, drop the
+// fragment and default ports, empty path becomes "/".
+// Example: HTTPS://Example.COM:443#top → https://example.com/
+std::string NormalizeCrawlUrl(const std::string &url);
+
 // Extract domain from URL (without port)
 std::string ExtractDomain(const std::string &url);
 
@@ -77,7 +85,11 @@ std::string GenerateSurtKey(const std::string &url);
 // Example: "www.example.com" → "com,example)"
 std::string GenerateDomainSurt(const std::string &hostname);
 
-// Generate content hash for deduplication (hex string)
+// Stable 64-bit hash of a URL's host, computed over the domain SURT so "www." variants
+// hash alike. Identical across processes and builds, so it can be stored and shared.
+uint64_t HostHash(const std::string &url);
+
+// Stable XXH3-128 content hash for exact deduplication (32 hex chars, empty for empty content)
 std::string GenerateContentHash(const std::string &content);
 
 //===--------------------------------------------------------------------===//
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Register crawl_decompress() for bodies kept raw by crawler_store_compressed
+void RegisterDecompressFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
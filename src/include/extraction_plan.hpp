@@ -0,0 +1,67 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "yyjson.hpp"
+
+namespace duckdb {
+
+// Per-document extraction limits (crawler_extract_* settings; 0 = unlimited). Facets
+// that hit one are cut short and carry a "$truncated" entry naming the limit.
+struct ExtractionBudget {
+    int64_t max_dom_nodes = 0;     // Larger documents skip microdata and readability
+    int64_t max_script_bytes = 0;  // Inline script bytes parsed for html.js
+    int64_t max_table_cells = 0;   // Cells of a read_html() table
+    int64_t max_facet_ms = 0;      // Wall-clock time per facet
+
+    static ExtractionBudget FromSettings(ClientContext &context);
+
+    bool Unlimited() const {
+        return max_dom_nodes == 0 && max_script_bytes == 0 && max_table_cells == 0 && max_facet_ms == 0;
+    }
+
+    // The budget as the Rust extractors take it ("" when unlimited)
+    string ToJson() const;
+};
+
+// What the Rust fetch task extracts from a page while it holds the body: the
+// extract := [...] specs, the html facets and the links to follow. The page is parsed
+// once, on the compute pool, instead of once per extractor on the DuckDB thread.
+struct ExtractionPlan {
+    string specs_json;       // JSON array of extract specs ("" = none)
+    bool facets = false;     // html.js, opengraph, schema and readability of HTML pages
+    string follow_selector;  // Return the links this selector matches
+    bool follow = false;
+    ExtractionBudget budget;
+
+    bool Empty() const { return specs_json.empty() && !facets && !follow; }
+
+    // The "extraction" object of a batch crawl request ("{}" when empty)
+    string ToJson() const;
+};
+
+// Facets and links computed by the fetch task. Responses served from the cache have
+// neither, and are extracted on the DuckDB thread as before.
+struct PlanResult {
+    bool has_facets = false;
+    string js_json;
+    string opengraph_json;
+    string schema_json;  // JSON-LD and microdata, keyed by @type
+    string readability_json;
+    bool has_links = false;
+    vector<string> links;
+
+    // Read the "facets" and "links" fields of one crawl result
+    void Read(duckdb_yyjson::yyjson_val *result);
+};
+
+// Parse extract := [...] entries into a JSON array of specs. An entry is
+// `[alias :=] source.path` (source: jsonld, microdata, og, meta or js) or
+// `alias := $("selector")[.text | .html | .attr("name")]`. Throws BinderException
+// naming `function_name` for a malformed entry or a repeated alias.
+string ParseExtractSpecs(const vector<string> &entries, const string &function_name);
+
+// Evaluate specs against a page fetched earlier (cache hits): the "extract" JSON
+// object, or "" if there are no specs
+string EvaluateExtractSpecs(const string &body, const string &specs_json, const ExtractionBudget &budget);
+
+} // namespace duckdb
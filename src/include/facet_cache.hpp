@@ -0,0 +1,83 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include "extraction_plan.hpp"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+// Extracted html facets, shared by crawl() and crawl_url()
+static constexpr const char *FACET_TABLE_NAME = "__crawler_facets";
+
+// Per-database cache of extractor outputs keyed by (content hash, extractor version,
+// facet): a byte-budgeted LRU in memory in front of the __crawler_facets table.
+// Identical bodies, whether served from the response cache or fetched under another
+// URL, are extracted once. Readability resolves links against the document's base URL,
+// so its facet is also keyed by that. Thread-safe.
+class FacetCache : public ObjectCacheEntry {
+public:
+    static constexpr idx_t DEFAULT_MEMORY_BYTES = 32 * 1024 * 1024;
+
+    // The cache of the context's database, or nullptr if crawler_facet_cache_memory_bytes is 0
+    static shared_ptr<FacetCache> Get(ClientContext &context);
+
+    // Fill the facets of `facets` that are cached for this content (memory first, then
+    // the table). Returns false if any is missing; `missing` names them.
+    bool Lookup(DatabaseInstance &db, const string &content_hash, const string &url, PlanResult &facets,
+                vector<string> &missing);
+
+    // Remember the named facets in memory and, with `persist`, in the table
+    void Save(DatabaseInstance &db, const string &content_hash, const vector<string> &names,
+              const PlanResult &facets, bool persist);
+
+    void Clear();
+    void SetMemoryBudget(idx_t bytes) { memory_budget_.store(bytes); }
+    idx_t MemoryUsage() const;
+
+    static string ObjectType() { return "crawler_facet_cache"; }
+    string GetObjectType() override { return ObjectType(); }
+    optional_idx GetEstimatedCacheMemory() const override { return optional_idx(MemoryUsage()); }
+
+private:
+    struct Entry {
+        string key;  // content hash + '\n' + facet
+        string value;
+        idx_t MemorySize() const { return sizeof(Entry) + key.size() + value.size(); }
+    };
+
+    bool GetFromMemory(const string &key, string &value);
+    void PutInMemory(const string &key, const string &value);
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  // Most recently used first
+    std::unordered_map<string, std::list<Entry>::iterator> index_;
+    idx_t bytes_ = 0;
+    std::atomic<idx_t> memory_budget_ {DEFAULT_MEMORY_BYTES};
+};
+
+// Version of the extractors behind the facets; rows written by other versions are ignored
+string FacetExtractorVersion();
+
+// Create __crawler_facets if it does not exist yet
+void EnsureFacetTable(Connection &conn);
+
+// Delete facet rows older than max_age_hours (0 = keep) or written by other extractor
+// versions. Returns the number of rows deleted.
+int64_t PruneFacetTable(Connection &conn, int64_t max_age_hours);
+
+// The html facets of an HTML page the fetch task did not extract (cache hits, dedup):
+// from the facet cache, else extracted here and remembered (persisted with `persist`).
+// A no-op if `facets` is already filled or the page is not HTML.
+void ResolvePageFacets(ClientContext &context, const string &body, const string &content_type,
+                       const string &content_hash, const string &url, bool persist, PlanResult &facets);
+
+// Remember the facets the fetch task computed, so cache hits of the content are free
+void RememberPageFacets(ClientContext &context, const string &content_hash, const string &url,
+                        const PlanResult &facets, bool persist);
+
+} // namespace duckdb
@@ -1,26 +1,45 @@
 #pragma once
 
 #include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "crawl_budget.hpp"
 #include <atomic>
 #include <memory>
 
 namespace duckdb {
 
-// Shared pipeline state for LIMIT pushdown across table function calls
-struct PipelineState {
+// Shared pipeline state for LIMIT pushdown across table function calls.
+// Scoped to the ClientContext that runs the pipeline, so concurrent pipelines
+// (even on the same database) never see each other's limits.
+struct PipelineState : public ClientContextState {
     std::atomic<int64_t> remaining;
     std::atomic<bool> stopped;
+    std::shared_ptr<CrawlBudgetTracker> budget;  // Statement-wide budget shared by all crawl calls (optional)
 
     PipelineState(int64_t limit) : remaining(limit), stopped(false) {}
+
+    // Count one emitted row against the limit; lock-free. Returns false once the limit is reached.
+    bool ConsumeRow() {
+        if (remaining.fetch_sub(1, std::memory_order_relaxed) <= 1) {
+            stopped.store(true, std::memory_order_release);
+            return false;
+        }
+        return true;
+    }
+
+    bool IsStopped() const { return stopped.load(std::memory_order_acquire); }
 };
 
-// Initialize pipeline limit for a database instance (call before running query)
-void InitPipelineLimit(DatabaseInstance &db, int64_t limit);
+// Attach a pipeline limit to a client context (call on the connection that runs the query)
+shared_ptr<PipelineState> InitPipelineLimit(ClientContext &context, int64_t limit);
+
+// Attach a statement-wide crawl budget to a client context (creates an unlimited pipeline if needed)
+shared_ptr<PipelineState> InitPipelineBudget(ClientContext &context, const CrawlBudget &budget);
 
-// Get existing pipeline state for a database instance (returns nullptr if not set)
-std::shared_ptr<PipelineState> GetPipelineState(DatabaseInstance &db);
+// Get the pipeline state attached to a client context (returns nullptr if not set)
+shared_ptr<PipelineState> GetPipelineState(ClientContext &context);
 
-// Clear pipeline state for a database instance
-void ClearPipelineState(DatabaseInstance &db);
+// Detach the pipeline state from a client context
+void ClearPipelineState(ClientContext &context);
 
 } // namespace duckdb
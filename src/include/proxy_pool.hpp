@@ -0,0 +1,145 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+class CrawlCancelToken;
+
+// One egress proxy of a pool
+struct ProxyEndpoint {
+    string url;
+    string username;
+    string password;
+    double weight = 1.0;
+    int64_t max_concurrency = 0;  // Requests in flight through this proxy (0 = unlimited)
+};
+
+// Health of a proxy, as reported by crawler_proxy_stats()
+struct ProxyStats {
+    ProxyEndpoint endpoint;
+    int64_t in_flight = 0;
+    int64_t requests = 0;
+    int64_t failures = 0;
+    double latency_ms = 0;       // Moving average of response times
+    double error_rate = 0;       // Moving average of proxy failures (0..1)
+    double effective_weight = 0; // weight scaled by health; 0 while ejected
+    bool ejected = false;
+};
+
+class ProxyPool;
+
+// A request's hold on one proxy. Complete() records the outcome; destroying the lease
+// without it (e.g. cancellation) just frees the slot.
+class ProxyLease {
+public:
+    ProxyLease(shared_ptr<ProxyPool> pool, idx_t slot, string host, ProxyEndpoint endpoint);
+    ~ProxyLease();
+    ProxyLease(const ProxyLease &) = delete;
+    ProxyLease &operator=(const ProxyLease &) = delete;
+
+    const ProxyEndpoint &Endpoint() const { return endpoint_; }
+
+    // Record the response time and status (0 = network error) of the request
+    void Complete(int64_t response_time_ms, int status_code);
+
+private:
+    shared_ptr<ProxyPool> pool_;
+    idx_t slot_;
+    string host_;
+    ProxyEndpoint endpoint_;
+    bool completed_ = false;
+};
+
+// Per-database pool of egress proxies with weighted rotation, per-proxy concurrency
+// caps, health scoring and ejection, and host-sticky assignment.
+//
+// Proxies are picked by smooth weighted round-robin over their effective weight: the
+// configured weight scaled down by average latency and error rate. Only failures that
+// point at the proxy count against it: a 407, or network errors, 502 and 504 once they
+// come from more than one host, so one dead origin cannot eject a healthy proxy.
+// Repeated failures eject a proxy for an exponentially growing backoff; the first
+// request after it expires is its probe. A host keeps its proxy for as long
+// as the proxy stays in the pool and healthy, so cookies and sessions stay consistent
+// and per-host politeness is not multiplied by the pool size; a host that keeps failing
+// through its proxy moves on to another one. Thread-safe.
+class ProxyPool : public ObjectCacheEntry, public enable_shared_from_this<ProxyPool> {
+public:
+    static constexpr int64_t TABLE_RELOAD_MS = 60 * 1000;
+    static constexpr int64_t MIN_EJECTION_MS = 30 * 1000;
+    static constexpr int64_t MAX_EJECTION_MS = 10 * 60 * 1000;
+    static constexpr int64_t EJECT_AFTER_CONSECUTIVE_FAILURES = 3;
+    static constexpr idx_t MAX_STICKY_HOSTS = 100000;
+
+    // The pool to route a request through, or nullptr for a direct or single-proxy fetch:
+    // the table named by crawler_proxy_pool (reloaded every minute), else a comma-separated
+    // `http_proxy` list from the settings or a matching HTTP secret.
+    static shared_ptr<ProxyPool> Resolve(ClientContext &context, const string &http_proxy,
+                                         const string &http_proxy_username,
+                                         const string &http_proxy_password);
+
+    // Pick a proxy for the host of `url`. Blocks while every usable proxy is at its
+    // concurrency cap; returns nullptr if the pool is empty or `cancel` fires meanwhile.
+    unique_ptr<ProxyLease> Acquire(const string &url, const CrawlCancelToken *cancel = nullptr);
+
+    // Replace the proxy list; proxies that stay keep their health and in-flight counts
+    void Configure(const vector<ProxyEndpoint> &endpoints);
+
+    vector<ProxyStats> Snapshot() const;
+
+    // True if a table-backed pool is due for reloading
+    bool NeedsReload() const;
+
+    static string ObjectType() { return "crawler_proxy_pool"; }
+    string GetObjectType() override { return ObjectType(); }
+    optional_idx GetEstimatedCacheMemory() const override { return optional_idx(); }
+
+private:
+    friend class ProxyLease;
+
+    struct Slot {
+        ProxyEndpoint endpoint;
+        bool active = true;  // False once removed from the pool (kept for leases in flight)
+        int64_t in_flight = 0;
+        int64_t requests = 0;
+        int64_t failures = 0;
+        int64_t consecutive_failures = 0;          // 407s since the last success
+        // Network errors, 502s and 504s per host since the last success
+        std::unordered_map<string, int64_t> failing_hosts;
+        int64_t ejections = 0;
+        double latency_ms = 0;
+        double error_rate = 0;
+        double current_weight = 0;  // Smooth weighted round-robin state
+        std::chrono::steady_clock::time_point ejected_until;
+    };
+
+    void Release(idx_t slot, const string &host, bool completed, int64_t response_time_ms, int status_code);
+
+    double EffectiveWeightLocked(const Slot &slot) const;
+    bool EjectedLocked(const Slot &slot, std::chrono::steady_clock::time_point now) const;
+    bool HasCapacityLocked(const Slot &slot) const;
+    // Slot for `host`, or INVALID_INDEX if all usable proxies are at their caps
+    idx_t PickLocked(const string &host, std::chrono::steady_clock::time_point now);
+
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    vector<Slot> slots_;
+    std::unordered_map<string, idx_t> sticky_;  // Host -> slot
+    bool loaded_ = false;
+    std::chrono::steady_clock::time_point loaded_at_;
+};
+
+// Parse a comma-separated proxy list ("http://a:3128, socks5://b:1080") into endpoints
+vector<ProxyEndpoint> ParseProxyList(const string &list, const string &username, const string &password);
+
+// Endpoints from a pool table: a proxy column, optional username, password, weight and
+// max_concurrency columns
+vector<ProxyEndpoint> LoadProxyTable(DatabaseInstance &db, const string &table_name);
+
+} // namespace duckdb
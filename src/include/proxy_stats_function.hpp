@@ -0,0 +1,10 @@
+#pragma once
+
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Register crawler_proxy_stats() - health of the configured proxy pool
+void RegisterProxyStatsFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Per-URL change observations used to schedule recrawls, keyed by SURT key
+static constexpr const char *CHANGE_STATS_TABLE_NAME = "__crawler_change_stats";
+
+// Recheck interval for URLs whose change rate is not known yet
+static constexpr double DEFAULT_RECRAWL_HOURS = 24.0;
+
+//===--------------------------------------------------------------------===//
+// Change Tracking
+//===--------------------------------------------------------------------===//
+
+// Create __crawler_change_stats if it does not exist yet
+void EnsureChangeStatsTable(Connection &conn);
+
+// Record one fetch of `url` with the given content hash and reschedule it, in a single
+// upsert. The table must exist (EnsureChangeStatsTable).
+//
+// A page is modelled as a Poisson process: from `checks` revisits over the observed hours
+// of which `changes` saw a new content hash, the bias-reduced estimator
+// -log((n - X + 0.5) / (n + 0.5)) / I gives its changes per hour, finite even when every
+// revisit saw a change. It is next due once it has changed with probability 1/2
+// (ln 2 / rate hours), clamped to [min_hours, max_hours]. Unknown rates use
+// DEFAULT_RECRAWL_HOURS, pages never seen to change max_hours.
+void RecordChangeObservation(Connection &conn, const string &url, const string &content_hash, double min_hours,
+                             double max_hours);
+
+// The same, clamped by the crawler_recrawl_min_hours / crawler_recrawl_max_hours settings
+void RecordChangeObservation(ClientContext &context, Connection &conn, const string &url,
+                             const string &content_hash);
+
+// Record a crawled body by its content hash if crawler_track_changes is enabled
+// (successful, non-empty responses only). `conn` is opened on first use and should be
+// kept for the rest of the scan.
+void MaybeRecordChangeObservation(ClientContext &context, unique_ptr<Connection> &conn, const string &url,
+                                  int status_code, const string &content_hash);
+
+} // namespace duckdb
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+// HTTP response cache table shared by crawl() and crawl_url()
+static constexpr const char *CACHE_TABLE_NAME = "__crawler_cache";
+
+// A cached HTTP response (row of __crawler_cache)
+struct CachedResponse {
+    string url;
+    int status_code = 0;
+    string content_type;
+    string body;
+    string error;
+    int64_t response_time_ms = 0;
+    string content_encoding;  // Coding of body_compressed (crawler_store_compressed only)
+    string body_compressed;   // Body exactly as received, still compressed
+    std::chrono::steady_clock::time_point cached_at;  // When the response was stored
+
+    idx_t MemorySize() const {
+        return sizeof(CachedResponse) + url.size() + content_type.size() + body.size() + error.size() +
+               content_encoding.size() + body_compressed.size();
+    }
+};
+
+// Automatic compaction of __crawler_cache (crawler_cache_auto_vacuum, with the limits of
+// crawler_cache_max_age_hours / crawler_cache_max_bytes), as set in the writing session
+struct CacheAutoVacuum {
+    bool enabled = false;
+    int64_t max_age_hours = 0;
+    int64_t max_bytes = 0;
+
+    static CacheAutoVacuum FromSettings(ClientContext &context);
+};
+
+// Per-database response cache: a sharded, byte-budgeted, TTL-aware LRU kept in memory
+// in front of the __crawler_cache table. Hits never touch the SQL layer; misses are
+// looked up in the table in one batched query and then kept in memory.
+class ResponseCache : public ObjectCacheEntry {
+public:
+    static constexpr idx_t NUM_SHARDS = 16;
+    static constexpr idx_t DEFAULT_MEMORY_BYTES = 64 * 1024 * 1024;
+
+    // Get the cache of the context's database. The memory tier is shared by all connections,
+    // so its budget is the database-wide crawler_cache_memory_bytes (SET GLOBAL).
+    static shared_ptr<ResponseCache> Get(ClientContext &context);
+
+    // Fresh cached responses for `urls` (younger than ttl_hours), in no particular order.
+    // Memory tier first; remaining URLs are fetched from the table in a single query
+    // unless memory_only is set (e.g. the URLs were just prefetched).
+    vector<CachedResponse> Lookup(DatabaseInstance &db, const vector<string> &urls, int ttl_hours,
+                                  bool memory_only = false);
+
+    // Load the table rows for `urls` that are not in memory yet, in a single query
+    void Prefetch(DatabaseInstance &db, const vector<string> &urls, int ttl_hours);
+
+    // Store a response in the table and the memory tier, vacuuming the table every
+    // AUTO_VACUUM_INTERVAL saves made with auto_vacuum enabled
+    void Save(DatabaseInstance &db, const CachedResponse &response, const CacheAutoVacuum &auto_vacuum);
+
+    // Drop everything from the memory tier (e.g. after rows were evicted from the table)
+    void Clear();
+
+    void SetMemoryBudget(idx_t bytes) { memory_budget_.store(bytes); }
+    idx_t MemoryUsage() const;
+
+    static string ObjectType() { return "crawler_response_cache"; }
+    string GetObjectType() override { return ObjectType(); }
+    optional_idx GetEstimatedCacheMemory() const override { return optional_idx(MemoryUsage()); }
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<CachedResponse> lru;  // Most recently used first
+        std::unordered_map<string, std::list<CachedResponse>::iterator> index;  // By full URL
+        idx_t bytes = 0;
+    };
+
+    Shard &ShardFor(const string &url) { return shards_[std::hash<string>()(url) % NUM_SHARDS]; }
+    bool GetFromMemory(const string &url, std::chrono::steady_clock::duration ttl, CachedResponse &out);
+    bool ContainsInMemory(const string &url, std::chrono::steady_clock::duration ttl);
+    void LoadFromTable(DatabaseInstance &db, const vector<string> &urls, int ttl_hours, vector<CachedResponse> *found);
+    void PutInMemory(const CachedResponse &response);
+    static void EraseLocked(Shard &shard, std::unordered_map<string, std::list<CachedResponse>::iterator>::iterator it);
+
+    Shard shards_[NUM_SHARDS];
+    std::atomic<idx_t> memory_budget_ {DEFAULT_MEMORY_BYTES};
+
+    static constexpr idx_t AUTO_VACUUM_INTERVAL = 1000;
+    std::atomic<idx_t> saves_since_vacuum_ {0};
+};
+
+// Create __crawler_cache if it does not exist yet (adding columns missing from older tables)
+void EnsureCacheTable(Connection &conn);
+
+//===--------------------------------------------------------------------===//
+// Compressed Bodies (crawler_store_compressed)
+//===--------------------------------------------------------------------===//
+
+// What is kept of a compressed response: nothing ('off', the HTTP client inflates it),
+// the raw bytes next to the decoded body ('alongside'), or the raw bytes only ('only').
+// 'only' rows are inflated lazily, when a cache lookup or crawl_decompress() reads them.
+enum class CompressedStorage : uint8_t { OFF, ALONGSIDE, ONLY };
+
+CompressedStorage GetCompressedStorage(ClientContext &context);
+const char *CompressedStorageName(CompressedStorage storage);
+
+// Raw body bytes from the base64 transport encoding used by the Rust fetcher
+string DecodeBase64Body(const string &base64);
+
+//===--------------------------------------------------------------------===//
+// Cache Maintenance
+//===--------------------------------------------------------------------===//
+
+static constexpr idx_t DEFAULT_VACUUM_BATCH_SIZE = 1000;
+
+struct CacheVacuumStats {
+    int64_t expired = 0;          // Rows deleted for being older than max_age_hours
+    int64_t evicted = 0;          // Rows deleted to fit max_bytes
+    int64_t remaining_rows = 0;
+    int64_t remaining_bytes = 0;  // Approximate size of url, content_type, body and error
+};
+
+// Delete rows older than max_age_hours, then the oldest rows until the table fits in
+// max_bytes (0 disables either step). Deletes run in batches of batch_size rows.
+CacheVacuumStats VacuumCacheTable(Connection &conn, int64_t max_age_hours, int64_t max_bytes, idx_t batch_size);
+
+// Cache maintenance settings (crawler_cache_max_age_hours, crawler_cache_max_bytes)
+int64_t GetCacheMaxAgeHours(ClientContext &context);
+int64_t GetCacheMaxBytes(ClientContext &context);
+
+} // namespace duckdb
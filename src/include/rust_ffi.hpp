@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,21 +19,55 @@ bool IsRustParserAvailable();
 std::string GetRustParserVersion();
 
 // Convenience extractors - return JSON strings
+// budget_json is an ExtractionBudget::ToJson() ("" = unlimited); a facet that hits it
+// carries a "$truncated" entry naming the limit
 std::string ExtractJsonLdWithRust(const std::string &html);
-std::string ExtractMicrodataWithRust(const std::string &html);
+std::string ExtractMicrodataWithRust(const std::string &html, const std::string &budget_json = "");
 std::string ExtractOpenGraphWithRust(const std::string &html);
-std::string ExtractJsWithRust(const std::string &html);
+std::string ExtractJsWithRust(const std::string &html, const std::string &budget_json = "");
 std::string ExtractCssWithRust(const std::string &html, const std::string &selector);
 
 // Extract article content using readability algorithm
 // Returns JSON: {"title": "...", "content": "<html>", "text_content": "...", "length": 123, "excerpt": "..."}
-std::string ExtractReadabilityWithRust(const std::string &html, const std::string &url);
+std::string ExtractReadabilityWithRust(const std::string &html, const std::string &url,
+                                       const std::string &budget_json = "");
 
 // Batch crawl + extract (HTTP done in Rust)
 // Takes JSON request: {"urls": [...], "extraction": {...}, "user_agent": "...", "timeout_ms": 30000, "concurrency": 4}
 // Returns JSON response: {"results": [{url, status, content_type, body, error, extracted, response_time_ms}, ...]}
 std::string CrawlBatchWithRust(const std::string &request_json);
 
+// Per-query cancellation token for Rust crawls. It is cancelled explicitly via
+// Cancel() (also done by the destructor) or as soon as a watched flag turns true,
+// e.g. ClientContext::interrupted or PipelineState::stopped. Only crawls started
+// with this token are affected, unlike the process-wide SetInterrupted().
+class CrawlCancelToken {
+public:
+    explicit CrawlCancelToken(const std::atomic<bool> *interrupted = nullptr,
+                              const std::atomic<bool> *stopped = nullptr);
+    ~CrawlCancelToken();
+    CrawlCancelToken(const CrawlCancelToken &) = delete;
+    CrawlCancelToken &operator=(const CrawlCancelToken &) = delete;
+
+    void Cancel();
+    bool IsCancelled() const;
+
+    // True if a watched flag is set (polled from Rust worker threads)
+    bool WatchedFlagSet() const {
+        return (interrupted_ && interrupted_->load()) || (stopped_ && stopped_->load());
+    }
+    void *Handle() const { return handle_; }
+
+private:
+    void *handle_;
+    std::atomic<bool> cancelled_{false};
+    const std::atomic<bool> *interrupted_;
+    const std::atomic<bool> *stopped_;
+};
+
+// Batch crawl that stops (aborting in-flight requests) once token is cancelled
+std::string CrawlBatchWithRust(const std::string &request_json, const CrawlCancelToken &token);
+
 // Fetch and parse sitemap(s)
 // Takes JSON request: {"url": "...", "recursive": true, "max_depth": 5, "discover_from_robots": false}
 // Returns JSON response: {"urls": [{url, lastmod, changefreq, priority}, ...], "sitemaps": [...], "errors": [...]}
@@ -41,7 +78,12 @@ std::string FetchSitemapWithRust(const std::string &request_json);
 // Returns JSON response: {"allowed": true, "crawl_delay": 1.0, "sitemaps": [...]}
 std::string CheckRobotsWithRust(const std::string &request_json);
 
-// Signal handling for graceful shutdown
+// Decompress a body kept raw by crawler_store_compressed (gzip, deflate, br, zstd) and
+// decode it to UTF-8. Returns false with `error` set for unknown codings or corrupt data.
+bool DecompressBodyWithRust(const std::string &data, const std::string &content_encoding,
+                            const std::string &content_type, std::string &text, std::string &error);
+
+// Process-wide interrupt flag; stops every running crawl. Prefer CrawlCancelToken.
 void SetInterrupted(bool value);
 bool IsInterrupted();
 
@@ -65,6 +107,52 @@ std::string ExtractPathWithRust(const std::string &html, const std::string &path
 // Returns JSON: {"headers": [...], "rows": [[...], ...], "num_columns": N, "num_rows": M, "error": null}
 // url is used to detect Wikipedia pages for special handling (removes citation references)
 // table_index is 0-based index of which matching table to extract
-std::string ExtractTableWithRust(const std::string &html, const std::string &selector, const std::string &url, size_t table_index);
+// Rows stop at the budget's table cells or facet time ("$truncated" names the limit)
+std::string ExtractTableWithRust(const std::string &html, const std::string &selector, const std::string &url, size_t table_index,
+                                 const std::string &budget_json = "");
+
+// HTML table extracted by Rust in columnar form: one contiguous byte buffer plus
+// per-column offsets. Header and cell pointers stay valid for the lifetime of this
+// object (the Rust allocation is released by the destructor).
+class RustColumnarTable {
+public:
+    RustColumnarTable(const char *data, size_t data_len, const uint64_t *offsets, size_t offsets_len,
+                      size_t num_columns, size_t num_rows, std::string error);
+    ~RustColumnarTable();
+    RustColumnarTable(const RustColumnarTable &) = delete;
+    RustColumnarTable &operator=(const RustColumnarTable &) = delete;
+
+    size_t NumColumns() const { return num_columns_; }
+    size_t NumRows() const { return num_rows_; }
+    bool HasError() const { return !error_.empty(); }
+    const std::string &GetError() const { return error_; }
+
+    // Header bytes for a column (not null-terminated)
+    const char *Header(size_t col, size_t &len) const {
+        len = offsets_[col + 1] - offsets_[col];
+        return data_ + offsets_[col];
+    }
+    // Cell bytes for (row, col) (not null-terminated, empty for missing cells)
+    const char *Cell(size_t row, size_t col, size_t &len) const {
+        const uint64_t *column = offsets_ + (num_columns_ + 1) + col * (num_rows_ + 1);
+        len = column[row + 1] - column[row];
+        return data_ + column[row];
+    }
+
+private:
+    const char *data_;
+    size_t data_len_;
+    const uint64_t *offsets_;
+    size_t offsets_len_;
+    size_t num_columns_;
+    size_t num_rows_;
+    std::string error_;
+};
+
+// Extract HTML table in columnar form (same arguments as ExtractTableWithRust)
+// Avoids serializing every cell to JSON and re-parsing it on the C++ side
+std::unique_ptr<RustColumnarTable> ExtractTableColumnarWithRust(const std::string &html, const std::string &selector,
+                                                                const std::string &url, size_t table_index,
+                                                                const std::string &budget_json = "");
 
 } // namespace duckdb
@@ -2,7 +2,9 @@
 
 #include "robots_parser.hpp"
 #include "duckdb/common/helper.hpp"
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -158,4 +160,64 @@ private:
 	std::unordered_map<std::string, unique_ptr<DomainState>> domain_states_;
 };
 
+//===--------------------------------------------------------------------===//
+// Host Sharding - every host is owned by exactly one worker
+//===--------------------------------------------------------------------===//
+
+// Jump consistent hash (Lamping & Veach): maps a key to one of num_shards buckets.
+// Growing num_shards moves only ~1/num_shards of the keys to the new bucket.
+int32_t JumpConsistentHash(uint64_t key, int32_t num_shards);
+
+// Shard that owns the host of `url` (via HostHash, so "www." variants share a shard)
+int32_t HostShardFor(const std::string &url, int32_t num_shards);
+
+// Lock-free multi-producer / single-consumer queue (Vyukov). Used to hand URLs to the
+// worker that owns their host: any thread may Push, only the owning worker may TryPop.
+template <class T>
+class MpscQueue {
+public:
+	MpscQueue() : head_(new Node()), tail_(head_.load()) {}
+
+	~MpscQueue() {
+		T value;
+		while (TryPop(value)) {
+		}
+		delete tail_;
+	}
+
+	MpscQueue(const MpscQueue &) = delete;
+	MpscQueue &operator=(const MpscQueue &) = delete;
+
+	void Push(T value) {
+		Node *node = new Node(std::move(value));
+		Node *prev = head_.exchange(node, std::memory_order_acq_rel);
+		prev->next.store(node, std::memory_order_release);
+	}
+
+	// Consumer only. May briefly miss an element whose Push is still in progress.
+	bool TryPop(T &value) {
+		Node *tail = tail_;
+		Node *next = tail->next.load(std::memory_order_acquire);
+		if (!next) {
+			return false;
+		}
+		value = std::move(next->value);
+		tail_ = next;
+		delete tail;
+		return true;
+	}
+
+private:
+	struct Node {
+		std::atomic<Node *> next {nullptr};
+		T value;
+
+		Node() = default;
+		explicit Node(T v) : value(std::move(v)) {}
+	};
+
+	std::atomic<Node *> head_;  // Producers append here
+	Node *tail_;                // Consumer-owned stub node
+};
+
 } // namespace duckdb
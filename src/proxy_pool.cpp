@@ -0,0 +1,364 @@
+#include "proxy_pool.hpp"
+#include "crawler_utils.hpp"
+#include "rust_ffi.hpp"
+
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/connection.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+// Weight of the newest sample in the latency and error-rate moving averages
+static constexpr double HEALTH_ALPHA = 0.2;
+// Error rate that ejects a proxy once it has served enough requests to judge
+static constexpr double EJECT_ERROR_RATE = 0.5;
+static constexpr int64_t EJECT_MIN_REQUESTS = 10;
+// A slow or flaky proxy keeps this share of its weight, so it is still probed
+static constexpr double MIN_WEIGHT_SHARE = 0.05;
+
+// The proxy rejected our credentials: always the proxy's fault
+static bool IsProxyAuthFailure(int status_code) {
+    return status_code == 407;
+}
+
+// Network errors and gateway errors: the proxy or the origin, depending on the host
+static bool IsGatewayFailure(int status_code) {
+    return status_code == 0 || status_code == 502 || status_code == 504;
+}
+
+//===--------------------------------------------------------------------===//
+// ProxyLease
+//===--------------------------------------------------------------------===//
+
+ProxyLease::ProxyLease(shared_ptr<ProxyPool> pool, idx_t slot, string host, ProxyEndpoint endpoint)
+    : pool_(std::move(pool)), slot_(slot), host_(std::move(host)), endpoint_(std::move(endpoint)) {
+}
+
+ProxyLease::~ProxyLease() {
+    if (!completed_) {
+        pool_->Release(slot_, host_, false, 0, 0);
+    }
+}
+
+void ProxyLease::Complete(int64_t response_time_ms, int status_code) {
+    if (completed_) {
+        return;
+    }
+    completed_ = true;
+    pool_->Release(slot_, host_, true, response_time_ms, status_code);
+}
+
+//===--------------------------------------------------------------------===//
+// ProxyPool
+//===--------------------------------------------------------------------===//
+
+shared_ptr<ProxyPool> ProxyPool::Resolve(ClientContext &context, const string &http_proxy,
+                                         const string &http_proxy_username,
+                                         const string &http_proxy_password) {
+    auto &object_cache = ObjectCache::GetObjectCache(context);
+
+    Value setting_value;
+    if (context.TryGetCurrentSetting("crawler_proxy_pool", setting_value) && !setting_value.IsNull() &&
+        !setting_value.ToString().empty()) {
+        auto table_name = setting_value.ToString();
+        auto pool = object_cache.GetOrCreate<ProxyPool>(ObjectType() + ":table:" + table_name);
+        if (pool->NeedsReload()) {
+            pool->Configure(LoadProxyTable(*context.db, table_name));
+        }
+        return pool;
+    }
+
+    if (http_proxy.find(',') == string::npos) {
+        return nullptr;
+    }
+    auto pool = object_cache.GetOrCreate<ProxyPool>(ObjectType() + ":list:" + http_proxy + "\n" +
+                                                    http_proxy_username);
+    if (pool->NeedsReload()) {
+        pool->Configure(ParseProxyList(http_proxy, http_proxy_username, http_proxy_password));
+    }
+    return pool;
+}
+
+bool ProxyPool::NeedsReload() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !loaded_ ||
+           std::chrono::steady_clock::now() - loaded_at_ >= std::chrono::milliseconds(TABLE_RELOAD_MS);
+}
+
+void ProxyPool::Configure(const vector<ProxyEndpoint> &endpoints) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &slot : slots_) {
+        slot.active = false;
+    }
+    for (auto &endpoint : endpoints) {
+        auto it = std::find_if(slots_.begin(), slots_.end(),
+                               [&](const Slot &slot) { return slot.endpoint.url == endpoint.url; });
+        if (it == slots_.end()) {
+            Slot slot;
+            slot.endpoint = endpoint;
+            slots_.push_back(std::move(slot));
+        } else {
+            it->endpoint = endpoint;
+            it->active = true;
+        }
+    }
+    loaded_ = true;
+    loaded_at_ = std::chrono::steady_clock::now();
+    released_.notify_all();  // Raised caps or new proxies may unblock waiters
+}
+
+double ProxyPool::EffectiveWeightLocked(const Slot &slot) const {
+    // Scaled by the success rate and halved at one second of average latency
+    double health = (1.0 - slot.error_rate) * 1000.0 / (1000.0 + slot.latency_ms);
+    return slot.endpoint.weight * MaxValue(health, MIN_WEIGHT_SHARE);
+}
+
+bool ProxyPool::EjectedLocked(const Slot &slot, std::chrono::steady_clock::time_point now) const {
+    return now < slot.ejected_until;
+}
+
+bool ProxyPool::HasCapacityLocked(const Slot &slot) const {
+    return slot.endpoint.max_concurrency <= 0 || slot.in_flight < slot.endpoint.max_concurrency;
+}
+
+idx_t ProxyPool::PickLocked(const string &host, std::chrono::steady_clock::time_point now) {
+    // Host-sticky: stay on the assigned proxy while it is healthy, waiting for a free slot
+    auto sticky = sticky_.find(host);
+    if (sticky != sticky_.end()) {
+        auto &slot = slots_[sticky->second];
+        if (slot.active && !EjectedLocked(slot, now)) {
+            return HasCapacityLocked(slot) ? sticky->second : DConstants::INVALID_INDEX;
+        }
+        sticky_.erase(sticky);
+    }
+
+    // Smooth weighted round-robin over healthy proxies with free capacity
+    idx_t best = DConstants::INVALID_INDEX;
+    double total = 0;
+    bool any_healthy = false;
+    for (idx_t i = 0; i < slots_.size(); i++) {
+        auto &slot = slots_[i];
+        if (!slot.active || EjectedLocked(slot, now)) {
+            continue;
+        }
+        any_healthy = true;
+        if (!HasCapacityLocked(slot)) {
+            continue;
+        }
+        double weight = EffectiveWeightLocked(slot);
+        slot.current_weight += weight;
+        total += weight;
+        if (best == DConstants::INVALID_INDEX || slot.current_weight > slots_[best].current_weight) {
+            best = i;
+        }
+    }
+    if (best != DConstants::INVALID_INDEX) {
+        slots_[best].current_weight -= total;
+        return best;
+    }
+    if (any_healthy) {
+        return DConstants::INVALID_INDEX;  // All healthy proxies busy
+    }
+
+    // Every proxy is ejected: probe the one whose backoff ends first rather than stall
+    for (idx_t i = 0; i < slots_.size(); i++) {
+        auto &slot = slots_[i];
+        if (slot.active && HasCapacityLocked(slot) &&
+            (best == DConstants::INVALID_INDEX || slot.ejected_until < slots_[best].ejected_until)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+unique_ptr<ProxyLease> ProxyPool::Acquire(const string &url, const CrawlCancelToken *cancel) {
+    auto host = ExtractDomain(url);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (cancel && cancel->IsCancelled()) {
+            return nullptr;
+        }
+        bool any_active = std::any_of(slots_.begin(), slots_.end(), [](const Slot &slot) { return slot.active; });
+        if (!any_active) {
+            return nullptr;
+        }
+
+        auto index = PickLocked(host, std::chrono::steady_clock::now());
+        if (index != DConstants::INVALID_INDEX) {
+            auto &slot = slots_[index];
+            slot.in_flight++;
+            if (sticky_.size() >= MAX_STICKY_HOSTS) {
+                sticky_.clear();
+            }
+            sticky_[host] = index;
+            return make_uniq<ProxyLease>(shared_from_this(), index, host, slot.endpoint);
+        }
+
+        // Backpressure: wait for a lease to be released (or a cancellation to be noticed)
+        released_.wait_for(lock, std::chrono::milliseconds(100));
+    }
+}
+
+void ProxyPool::Release(idx_t index, const string &host, bool completed, int64_t response_time_ms,
+                        int status_code) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &slot = slots_[index];
+    slot.in_flight--;
+
+    if (completed) {
+        slot.requests++;
+        if (response_time_ms > 0) {
+            slot.latency_ms = slot.requests == 1 ? static_cast<double>(response_time_ms)
+                                                 : slot.latency_ms + HEALTH_ALPHA * (response_time_ms - slot.latency_ms);
+        }
+
+        bool auth_failure = IsProxyAuthFailure(status_code);
+        bool gateway_failure = IsGatewayFailure(status_code);
+        if (auth_failure || gateway_failure) {
+            // A gateway failure is blamed on the proxy only once a second host fails through
+            // it; repeats from one dead origin neither count nor reset the streak, but
+            // eventually move that host to another proxy
+            bool new_host = false;
+            if (gateway_failure) {
+                auto &host_failures = slot.failing_hosts[host];
+                new_host = host_failures == 0;
+                if (++host_failures >= EJECT_AFTER_CONSECUTIVE_FAILURES) {
+                    auto sticky = sticky_.find(host);
+                    if (sticky != sticky_.end() && sticky->second == index) {
+                        sticky_.erase(sticky);
+                    }
+                }
+            }
+            if (auth_failure || (new_host && slot.failing_hosts.size() >= 2)) {
+                slot.failures++;
+                slot.error_rate += HEALTH_ALPHA * (1.0 - slot.error_rate);
+            }
+            if (auth_failure) {
+                slot.consecutive_failures++;
+            }
+            auto streak = slot.consecutive_failures + static_cast<int64_t>(slot.failing_hosts.size());
+            if (streak >= EJECT_AFTER_CONSECUTIVE_FAILURES ||
+                (slot.requests >= EJECT_MIN_REQUESTS && slot.error_rate > EJECT_ERROR_RATE)) {
+                auto backoff = MinValue<int64_t>(MIN_EJECTION_MS << MinValue<int64_t>(slot.ejections, 10), MAX_EJECTION_MS);
+                slot.ejected_until = std::chrono::steady_clock::now() + std::chrono::milliseconds(backoff);
+                slot.ejections++;
+                slot.consecutive_failures = 0;
+                slot.failing_hosts.clear();
+            }
+        } else {
+            slot.error_rate += HEALTH_ALPHA * (0.0 - slot.error_rate);
+            slot.consecutive_failures = 0;
+            slot.failing_hosts.clear();
+            slot.ejections = 0;
+        }
+    }
+
+    released_.notify_all();
+}
+
+vector<ProxyStats> ProxyPool::Snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    vector<ProxyStats> stats;
+    for (auto &slot : slots_) {
+        if (!slot.active) {
+            continue;
+        }
+        ProxyStats entry;
+        entry.endpoint = slot.endpoint;
+        entry.in_flight = slot.in_flight;
+        entry.requests = slot.requests;
+        entry.failures = slot.failures;
+        entry.latency_ms = slot.latency_ms;
+        entry.error_rate = slot.error_rate;
+        entry.ejected = EjectedLocked(slot, now);
+        entry.effective_weight = entry.ejected ? 0 : EffectiveWeightLocked(slot);
+        stats.push_back(std::move(entry));
+    }
+    return stats;
+}
+
+//===--------------------------------------------------------------------===//
+// Pool definitions
+//===--------------------------------------------------------------------===//
+
+vector<ProxyEndpoint> ParseProxyList(const string &list, const string &username, const string &password) {
+    vector<ProxyEndpoint> endpoints;
+    for (auto &entry : StringUtil::Split(list, ',')) {
+        StringUtil::Trim(entry);
+        if (entry.empty()) {
+            continue;
+        }
+        ProxyEndpoint endpoint;
+        endpoint.url = entry;
+        endpoint.username = username;
+        endpoint.password = password;
+        endpoints.push_back(std::move(endpoint));
+    }
+    return endpoints;
+}
+
+vector<ProxyEndpoint> LoadProxyTable(DatabaseInstance &db, const string &table_name) {
+    Connection conn(db);
+    auto result = conn.Query("SELECT * FROM " + QuoteSqlIdentifier(table_name));
+    if (result->HasError()) {
+        throw InvalidInputException("crawler_proxy_pool: %s", result->GetError());
+    }
+
+    optional_idx proxy_col, username_col, password_col, weight_col, max_concurrency_col;
+    for (idx_t col = 0; col < result->names.size(); col++) {
+        auto name = StringUtil::Lower(result->names[col]);
+        if (name == "proxy" || name == "url") {
+            proxy_col = col;
+        } else if (name == "username") {
+            username_col = col;
+        } else if (name == "password") {
+            password_col = col;
+        } else if (name == "weight") {
+            weight_col = col;
+        } else if (name == "max_concurrency") {
+            max_concurrency_col = col;
+        }
+    }
+    if (!proxy_col.IsValid()) {
+        throw InvalidInputException("crawler_proxy_pool: table %s has no proxy column", table_name);
+    }
+
+    auto optional_value = [&](optional_idx col, idx_t row) {
+        return col.IsValid() ? result->GetValue(col.GetIndex(), row) : Value();
+    };
+
+    vector<ProxyEndpoint> endpoints;
+    for (idx_t row = 0; row < result->RowCount(); row++) {
+        auto proxy = result->GetValue(proxy_col.GetIndex(), row);
+        if (proxy.IsNull() || proxy.ToString().empty()) {
+            continue;
+        }
+        ProxyEndpoint endpoint;
+        endpoint.url = proxy.ToString();
+        auto username = optional_value(username_col, row);
+        auto password = optional_value(password_col, row);
+        auto weight = optional_value(weight_col, row);
+        auto max_concurrency = optional_value(max_concurrency_col, row);
+        if (!username.IsNull()) {
+            endpoint.username = username.ToString();
+        }
+        if (!password.IsNull()) {
+            endpoint.password = password.ToString();
+        }
+        if (!weight.IsNull()) {
+            endpoint.weight = weight.GetValue<double>();
+        }
+        if (!max_concurrency.IsNull()) {
+            endpoint.max_concurrency = max_concurrency.GetValue<int64_t>();
+        }
+        // Weight 0 takes a proxy out of rotation without deleting its row
+        if (endpoint.weight > 0) {
+            endpoints.push_back(std::move(endpoint));
+        }
+    }
+    return endpoints;
+}
+
+} // namespace duckdb
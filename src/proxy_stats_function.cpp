@@ -0,0 +1,98 @@
+// crawler_proxy_stats() - health of the proxy pool
+//
+// Usage:
+//   SET crawler_proxy_pool = 'egress_proxies';
+//   SELECT * FROM crawler_proxy_stats();
+//
+// One row per proxy of the pool the crawl functions currently route through: the
+// crawler_proxy_pool table, else a comma-separated http_proxy list.
+
+#include "proxy_stats_function.hpp"
+#include "proxy_pool.hpp"
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Global State
+//===--------------------------------------------------------------------===//
+
+struct ProxyStatsGlobalState : public GlobalTableFunctionState {
+    vector<ProxyStats> stats;
+    idx_t offset = 0;
+
+    idx_t MaxThreads() const override { return 1; }
+};
+
+//===--------------------------------------------------------------------===//
+// Bind Function
+//===--------------------------------------------------------------------===//
+
+static unique_ptr<FunctionData> ProxyStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+    return_types = {LogicalType::VARCHAR, LogicalType::DOUBLE,  LogicalType::BIGINT, LogicalType::BIGINT,
+                    LogicalType::BIGINT,  LogicalType::BIGINT,  LogicalType::DOUBLE, LogicalType::DOUBLE,
+                    LogicalType::DOUBLE,  LogicalType::BOOLEAN};
+    names = {"proxy",    "weight",     "max_concurrency", "in_flight",        "requests",
+             "failures", "latency_ms", "error_rate",      "effective_weight", "ejected"};
+    return make_uniq<TableFunctionData>();
+}
+
+//===--------------------------------------------------------------------===//
+// Init Global
+//===--------------------------------------------------------------------===//
+
+static unique_ptr<GlobalTableFunctionState> ProxyStatsInitGlobal(ClientContext &context,
+                                                                  TableFunctionInitInput &input) {
+    auto state = make_uniq<ProxyStatsGlobalState>();
+
+    Value proxy, username, password;
+    context.TryGetCurrentSetting("http_proxy", proxy);
+    context.TryGetCurrentSetting("http_proxy_username", username);
+    context.TryGetCurrentSetting("http_proxy_password", password);
+    auto pool = ProxyPool::Resolve(context, proxy.IsNull() ? "" : proxy.ToString(),
+                                   username.IsNull() ? "" : username.ToString(),
+                                   password.IsNull() ? "" : password.ToString());
+    if (pool) {
+        state->stats = pool->Snapshot();
+    }
+    return std::move(state);
+}
+
+//===--------------------------------------------------------------------===//
+// Table Function
+//===--------------------------------------------------------------------===//
+
+static void ProxyStatsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<ProxyStatsGlobalState>();
+
+    idx_t count = 0;
+    while (state.offset < state.stats.size() && count < STANDARD_VECTOR_SIZE) {
+        auto &entry = state.stats[state.offset++];
+        output.SetValue(0, count, Value(entry.endpoint.url));
+        output.SetValue(1, count, Value::DOUBLE(entry.endpoint.weight));
+        output.SetValue(2, count, entry.endpoint.max_concurrency > 0 ? Value::BIGINT(entry.endpoint.max_concurrency)
+                                                                     : Value());
+        output.SetValue(3, count, Value::BIGINT(entry.in_flight));
+        output.SetValue(4, count, Value::BIGINT(entry.requests));
+        output.SetValue(5, count, Value::BIGINT(entry.failures));
+        output.SetValue(6, count, Value::DOUBLE(entry.latency_ms));
+        output.SetValue(7, count, Value::DOUBLE(entry.error_rate));
+        output.SetValue(8, count, Value::DOUBLE(entry.effective_weight));
+        output.SetValue(9, count, Value::BOOLEAN(entry.ejected));
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// Register Function
+//===--------------------------------------------------------------------===//
+
+void RegisterProxyStatsFunction(ExtensionLoader &loader) {
+    TableFunction func("crawler_proxy_stats", {}, ProxyStatsFunction, ProxyStatsBind, ProxyStatsInitGlobal);
+    loader.RegisterFunction(func);
+}
+
+} // namespace duckdb
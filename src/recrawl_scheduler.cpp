@@ -0,0 +1,89 @@
+#include "recrawl_scheduler.hpp"
+#include "crawler_utils.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Change Tracking
+//===--------------------------------------------------------------------===//
+
+void EnsureChangeStatsTable(Connection &conn) {
+    conn.Query("CREATE TABLE IF NOT EXISTS " + string(CHANGE_STATS_TABLE_NAME) + " ("
+               "surt_key VARCHAR PRIMARY KEY, "
+               "url VARCHAR, "
+               "content_hash VARCHAR, "
+               "first_checked TIMESTAMP, "
+               "last_checked TIMESTAMP, "
+               "last_changed TIMESTAMP, "
+               "checks BIGINT, "          // Revisits after the first fetch
+               "changes BIGINT, "         // Revisits that saw a new content hash
+               "changes_per_day DOUBLE, " // NULL until the URL was revisited
+               "next_due TIMESTAMP)");
+}
+
+// The update half of the upsert below: the change-rate estimate and recrawl interval
+// written over the existing row (unqualified columns) and the new one (excluded.*), so
+// the read-modify-write is one statement and concurrent fetches cannot lose updates
+static string ChangeStatsUpdateSql() {
+    string changed = "(content_hash IS DISTINCT FROM excluded.content_hash)";
+    string checks = "(checks + 1)";
+    string changes = "least(changes + " + changed + "::BIGINT, " + checks + ")";
+    string observed_hours = "(date_diff('second', first_checked, current_timestamp::TIMESTAMP) / 3600.0)";
+    string rate = "(CASE WHEN " + observed_hours + " > 0 THEN -ln((" + checks + " - " + changes + " + 0.5) / (" +
+                  checks + " + 0.5)) / (" + observed_hours + " / " + checks + ") END)";
+    string hours = "greatest($5, least(CASE WHEN " + rate + " IS NULL THEN $7 WHEN " + rate +
+                   " = 0 THEN $6 ELSE ln(2) / " + rate + " END, $6))";
+    return "url = excluded.url, "
+           "content_hash = excluded.content_hash, "
+           "last_checked = current_timestamp, "
+           "last_changed = CASE WHEN " + changed + " THEN current_timestamp ELSE last_changed END, "
+           "checks = " + checks + ", "
+           "changes = " + changes + ", "
+           "changes_per_day = " + rate + " * 24, "
+           "next_due = current_timestamp + to_microseconds((" + hours + " * 3600000000)::BIGINT)";
+}
+
+void RecordChangeObservation(Connection &conn, const string &url, const string &content_hash, double min_hours,
+                             double max_hours) {
+    // First sighting: recheck after the default interval to start learning the rate
+    double first_hours = MaxValue<double>(min_hours, MinValue<double>(DEFAULT_RECRAWL_HOURS, max_hours));
+    conn.Query("INSERT INTO " + string(CHANGE_STATS_TABLE_NAME) +
+                   " VALUES ($1, $2, $3, current_timestamp, current_timestamp, current_timestamp, 0, 0, NULL, "
+                   "current_timestamp + to_microseconds($4::BIGINT)) "
+                   "ON CONFLICT (surt_key) DO UPDATE SET " + ChangeStatsUpdateSql(),
+               GenerateSurtKey(url), url, content_hash, Value::BIGINT(static_cast<int64_t>(first_hours * 3600.0 * 1e6)),
+               Value::DOUBLE(min_hours), Value::DOUBLE(max_hours), Value::DOUBLE(DEFAULT_RECRAWL_HOURS));
+}
+
+static double GetDoubleSetting(ClientContext &context, const char *name, double default_value) {
+    Value setting_value;
+    if (context.TryGetCurrentSetting(name, setting_value) && !setting_value.IsNull()) {
+        return setting_value.GetValue<double>();
+    }
+    return default_value;
+}
+
+void RecordChangeObservation(ClientContext &context, Connection &conn, const string &url,
+                             const string &content_hash) {
+    RecordChangeObservation(conn, url, content_hash, GetDoubleSetting(context, "crawler_recrawl_min_hours", 1.0),
+                            GetDoubleSetting(context, "crawler_recrawl_max_hours", 720.0));
+}
+
+void MaybeRecordChangeObservation(ClientContext &context, unique_ptr<Connection> &conn, const string &url,
+                                  int status_code, const string &content_hash) {
+    if (content_hash.empty() || status_code < 200 || status_code >= 300) {
+        return;
+    }
+    Value setting_value;
+    if (!context.TryGetCurrentSetting("crawler_track_changes", setting_value) || setting_value.IsNull() ||
+        !setting_value.GetValue<bool>()) {
+        return;
+    }
+    if (!conn) {
+        conn = make_uniq<Connection>(*context.db);
+        EnsureChangeStatsTable(*conn);
+    }
+    RecordChangeObservation(context, *conn, url, content_hash);
+}
+
+} // namespace duckdb
@@ -0,0 +1,401 @@
+#include "response_cache.hpp"
+#include "crawler_utils.hpp"
+#include "rust_ffi.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/blob.hpp"
+#include "duckdb/main/config.hpp"
+
+#include <functional>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Cache Table
+//===--------------------------------------------------------------------===//
+
+void EnsureCacheTable(Connection &conn) {
+    string sql = "CREATE TABLE IF NOT EXISTS " + string(CACHE_TABLE_NAME) + " ("
+                 "url VARCHAR PRIMARY KEY, "
+                 "status_code INTEGER, "
+                 "content_type VARCHAR, "
+                 "body VARCHAR, "
+                 "error VARCHAR, "
+                 "response_time_ms BIGINT, "
+                 "cached_at TIMESTAMP DEFAULT current_timestamp, "
+                 "content_encoding VARCHAR, "
+                 "body_compressed BLOB)";
+    conn.Query(sql);
+
+    // Tables created before raw bodies were kept lack the last two columns
+    auto columns = conn.Query("SELECT count(*) FROM duckdb_columns() WHERE table_name = '" +
+                              string(CACHE_TABLE_NAME) + "' AND column_name = 'body_compressed'");
+    if (!columns->HasError() && columns->RowCount() > 0 && columns->GetValue(0, 0).GetValue<int64_t>() == 0) {
+        conn.Query("ALTER TABLE " + string(CACHE_TABLE_NAME) + " ADD COLUMN IF NOT EXISTS content_encoding VARCHAR");
+        conn.Query("ALTER TABLE " + string(CACHE_TABLE_NAME) + " ADD COLUMN IF NOT EXISTS body_compressed BLOB");
+    }
+}
+
+//===--------------------------------------------------------------------===//
+// Compressed Bodies
+//===--------------------------------------------------------------------===//
+
+CompressedStorage GetCompressedStorage(ClientContext &context) {
+    Value setting_value;
+    if (!context.TryGetCurrentSetting("crawler_store_compressed", setting_value) || setting_value.IsNull()) {
+        return CompressedStorage::OFF;
+    }
+    auto mode = StringUtil::Lower(setting_value.ToString());
+    if (mode == "off") {
+        return CompressedStorage::OFF;
+    } else if (mode == "alongside") {
+        return CompressedStorage::ALONGSIDE;
+    } else if (mode == "only") {
+        return CompressedStorage::ONLY;
+    }
+    throw InvalidInputException("crawler_store_compressed must be 'off', 'alongside' or 'only', got '%s'", mode);
+}
+
+const char *CompressedStorageName(CompressedStorage storage) {
+    switch (storage) {
+    case CompressedStorage::ALONGSIDE:
+        return "alongside";
+    case CompressedStorage::ONLY:
+        return "only";
+    default:
+        return "off";
+    }
+}
+
+string DecodeBase64Body(const string &base64) {
+    string_t input(base64.data(), static_cast<uint32_t>(base64.size()));
+    string bytes(Blob::FromBase64Size(input), '\0');
+    Blob::FromBase64(input, data_ptr_cast(&bytes[0]), bytes.size());
+    return bytes;
+}
+
+// Inflate a row that was stored compressed only. The body stays empty if it cannot be decoded.
+static void InflateStoredBody(CachedResponse &response) {
+    if (!response.body.empty() || response.body_compressed.empty()) {
+        return;
+    }
+    string error;
+    DecompressBodyWithRust(response.body_compressed, response.content_encoding, response.content_type,
+                           response.body, error);
+}
+
+//===--------------------------------------------------------------------===//
+// ResponseCache
+//===--------------------------------------------------------------------===//
+
+int64_t GetCacheMaxAgeHours(ClientContext &context) {
+    Value setting_value;
+    if (context.TryGetCurrentSetting("crawler_cache_max_age_hours", setting_value) && !setting_value.IsNull()) {
+        return setting_value.GetValue<int64_t>();
+    }
+    return 168;
+}
+
+int64_t GetCacheMaxBytes(ClientContext &context) {
+    Value setting_value;
+    if (context.TryGetCurrentSetting("crawler_cache_max_bytes", setting_value) && !setting_value.IsNull()) {
+        return setting_value.GetValue<int64_t>();
+    }
+    return 0;
+}
+
+// Delete rows selected by `selection` (a query returning url) in batches until none are
+// left. Small batches keep each transaction short so concurrent crawls are not blocked.
+static int64_t DeleteInBatches(Connection &conn, const string &selection, idx_t batch_size) {
+    string sql = "DELETE FROM " + string(CACHE_TABLE_NAME) + " WHERE url IN (" + selection +
+                 " LIMIT " + std::to_string(batch_size) + ")";
+    int64_t deleted = 0;
+    while (true) {
+        auto result = conn.Query(sql);
+        if (result->HasError()) {
+            throw IOException("crawler cache vacuum failed: %s", result->GetError());
+        }
+        int64_t batch = result->RowCount() > 0 ? result->GetValue(0, 0).GetValue<int64_t>() : 0;
+        deleted += batch;
+        if (batch < static_cast<int64_t>(batch_size)) {
+            return deleted;
+        }
+    }
+}
+
+// Approximate stored size of a cache row
+static constexpr const char *CACHE_ROW_BYTES =
+    "(strlen(url) + coalesce(strlen(content_type), 0) + coalesce(strlen(body), 0) + coalesce(strlen(error), 0) + "
+    "coalesce(octet_length(body_compressed), 0))";
+
+CacheVacuumStats VacuumCacheTable(Connection &conn, int64_t max_age_hours, int64_t max_bytes, idx_t batch_size) {
+    EnsureCacheTable(conn);
+    CacheVacuumStats stats;
+
+    // TTL compaction: rows past max_age are never served again
+    if (max_age_hours > 0) {
+        stats.expired = DeleteInBatches(
+            conn,
+            "SELECT url FROM " + string(CACHE_TABLE_NAME) + " WHERE cached_at < current_timestamp - INTERVAL '" +
+                std::to_string(max_age_hours) + " hours'",
+            batch_size);
+    }
+
+    // Size budget: evict the least recently written rows until the newest rows fit. The
+    // first row (newest first) that no longer fits is found once; it and everything older
+    // is then deleted in batches, without recomputing the running sum per batch.
+    if (max_bytes > 0) {
+        auto cutoff = conn.Query("SELECT cached_at, url FROM (SELECT cached_at, url, sum(" + string(CACHE_ROW_BYTES) +
+                                 ") OVER (ORDER BY cached_at DESC, url) AS newer_bytes FROM " +
+                                 string(CACHE_TABLE_NAME) + ") WHERE newer_bytes > " + std::to_string(max_bytes) +
+                                 " ORDER BY cached_at DESC, url LIMIT 1");
+        if (cutoff->HasError()) {
+            throw IOException("crawler cache vacuum failed: %s", cutoff->GetError());
+        }
+        if (cutoff->RowCount() > 0) {
+            auto cutoff_at = cutoff->GetValue(0, 0);
+            auto cutoff_url = EscapeSqlString(cutoff->GetValue(1, 0).ToString());
+            // Rows without cached_at sort after every timestamped row
+            string older = cutoff_at.IsNull()
+                               ? "cached_at IS NULL AND url >= " + cutoff_url
+                               : "cached_at IS NULL OR cached_at < " + cutoff_at.ToSQLString() + " OR (cached_at = " +
+                                     cutoff_at.ToSQLString() + " AND url >= " + cutoff_url + ")";
+            stats.evicted = DeleteInBatches(
+                conn, "SELECT url FROM " + string(CACHE_TABLE_NAME) + " WHERE " + older, batch_size);
+        }
+    }
+
+    auto result = conn.Query("SELECT count(*), coalesce(sum(" + string(CACHE_ROW_BYTES) + "), 0)::BIGINT FROM " +
+                             string(CACHE_TABLE_NAME));
+    if (!result->HasError() && result->RowCount() > 0) {
+        stats.remaining_rows = result->GetValue(0, 0).GetValue<int64_t>();
+        stats.remaining_bytes = result->GetValue(1, 0).GetValue<int64_t>();
+    }
+    return stats;
+}
+
+CacheAutoVacuum CacheAutoVacuum::FromSettings(ClientContext &context) {
+    CacheAutoVacuum auto_vacuum;
+    Value setting_value;
+    if (context.TryGetCurrentSetting("crawler_cache_auto_vacuum", setting_value) && !setting_value.IsNull()) {
+        auto_vacuum.enabled = setting_value.GetValue<bool>();
+    }
+    auto_vacuum.max_age_hours = GetCacheMaxAgeHours(context);
+    auto_vacuum.max_bytes = GetCacheMaxBytes(context);
+    return auto_vacuum;
+}
+
+// A session SET would let the last connection to touch the cache resize it for all others
+static idx_t DatabaseMemoryBudget(ClientContext &context) {
+    auto &config = DBConfig::GetConfig(context);
+    std::lock_guard<std::mutex> lock(config.config_lock);
+    auto entry = config.options.set_variables.find("crawler_cache_memory_bytes");
+    if (entry == config.options.set_variables.end() || entry->second.IsNull()) {
+        return ResponseCache::DEFAULT_MEMORY_BYTES;
+    }
+    return static_cast<idx_t>(MaxValue<int64_t>(entry->second.GetValue<int64_t>(), 0));
+}
+
+shared_ptr<ResponseCache> ResponseCache::Get(ClientContext &context) {
+    auto cache = ObjectCache::GetObjectCache(context).GetOrCreate<ResponseCache>(ResponseCache::ObjectType());
+    cache->SetMemoryBudget(DatabaseMemoryBudget(context));
+    return cache;
+}
+
+void ResponseCache::EraseLocked(Shard &shard,
+                                std::unordered_map<string, std::list<CachedResponse>::iterator>::iterator it) {
+    shard.bytes -= it->second->MemorySize();
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+}
+
+bool ResponseCache::GetFromMemory(const string &url, std::chrono::steady_clock::duration ttl, CachedResponse &out) {
+    auto &shard = ShardFor(url);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(url);
+    if (it == shard.index.end()) {
+        return false;
+    }
+    if (std::chrono::steady_clock::now() - it->second->cached_at > ttl) {
+        EraseLocked(shard, it);
+        return false;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    out = *it->second;
+    return true;
+}
+
+void ResponseCache::PutInMemory(const CachedResponse &response) {
+    idx_t shard_budget = memory_budget_.load() / NUM_SHARDS;
+    idx_t size = response.MemorySize();
+    auto &shard = ShardFor(response.url);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(response.url);
+    if (it != shard.index.end()) {
+        EraseLocked(shard, it);
+    }
+    if (size > shard_budget) {
+        return;  // Larger than the shard can ever hold: table only
+    }
+
+    // Evict least recently used entries until the new one fits
+    while (!shard.lru.empty() && shard.bytes + size > shard_budget) {
+        EraseLocked(shard, shard.index.find(shard.lru.back().url));
+    }
+    shard.lru.push_front(response);
+    shard.index[response.url] = shard.lru.begin();
+    shard.bytes += size;
+}
+
+bool ResponseCache::ContainsInMemory(const string &url, std::chrono::steady_clock::duration ttl) {
+    auto &shard = ShardFor(url);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(url);
+    return it != shard.index.end() &&
+           std::chrono::steady_clock::now() - it->second->cached_at <= ttl;
+}
+
+vector<CachedResponse> ResponseCache::Lookup(DatabaseInstance &db, const vector<string> &urls, int ttl_hours,
+                                             bool memory_only) {
+    vector<CachedResponse> found;
+    if (urls.empty()) return found;
+
+    auto ttl = std::chrono::hours(ttl_hours);
+    vector<string> misses;
+    for (const auto &url : urls) {
+        CachedResponse response;
+        if (GetFromMemory(url, ttl, response)) {
+            found.push_back(std::move(response));
+        } else {
+            misses.push_back(url);
+        }
+    }
+    if (!memory_only) {
+        LoadFromTable(db, misses, ttl_hours, &found);
+    }
+    return found;
+}
+
+void ResponseCache::Prefetch(DatabaseInstance &db, const vector<string> &urls, int ttl_hours) {
+    auto ttl = std::chrono::hours(ttl_hours);
+    vector<string> misses;
+    for (const auto &url : urls) {
+        if (!ContainsInMemory(url, ttl)) {
+            misses.push_back(url);
+        }
+    }
+    LoadFromTable(db, misses, ttl_hours, nullptr);
+}
+
+void ResponseCache::LoadFromTable(DatabaseInstance &db, const vector<string> &urls, int ttl_hours,
+                                  vector<CachedResponse> *found) {
+    if (urls.empty()) return;
+
+    Connection conn(db);
+    EnsureCacheTable(conn);
+
+    // Build IN clause with properly quoted URLs
+    string url_list;
+    for (size_t i = 0; i < urls.size(); i++) {
+        if (i > 0) url_list += ", ";
+        url_list += EscapeSqlString(urls[i]);
+    }
+
+    // Single batch query for all misses; the row age is computed in SQL so it is
+    // independent of the time zone cached_at was written in
+    string sql = "SELECT url, status_code, content_type, body, error, response_time_ms, "
+                 "date_diff('millisecond', cached_at, current_timestamp::TIMESTAMP), "
+                 "content_encoding, CASE WHEN body IS NULL THEN body_compressed END "
+                 "FROM " + string(CACHE_TABLE_NAME) + " "
+                 "WHERE url IN (" + url_list + ") "
+                 "AND cached_at > current_timestamp - INTERVAL '" + std::to_string(ttl_hours) + " hours'";
+
+    auto result = conn.Query(sql);
+    if (result->HasError()) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    while (true) {
+        auto chunk = result->Fetch();
+        if (!chunk || chunk->size() == 0) break;
+
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            CachedResponse response;
+            response.url = chunk->GetValue(0, row).ToString();
+            response.status_code = chunk->GetValue(1, row).GetValue<int>();
+            response.content_type = chunk->GetValue(2, row).IsNull() ? "" : chunk->GetValue(2, row).ToString();
+            response.body = chunk->GetValue(3, row).IsNull() ? "" : chunk->GetValue(3, row).ToString();
+            response.error = chunk->GetValue(4, row).IsNull() ? "" : chunk->GetValue(4, row).ToString();
+            response.response_time_ms = chunk->GetValue(5, row).IsNull() ? 0 : chunk->GetValue(5, row).GetValue<int64_t>();
+            int64_t age_ms = chunk->GetValue(6, row).IsNull() ? 0 : chunk->GetValue(6, row).GetValue<int64_t>();
+            response.cached_at = now - std::chrono::milliseconds(MaxValue<int64_t>(age_ms, 0));
+            if (!chunk->GetValue(8, row).IsNull()) {
+                // Stored compressed only: inflate now that the body is actually read
+                response.content_encoding = chunk->GetValue(7, row).IsNull() ? "" : chunk->GetValue(7, row).ToString();
+                response.body_compressed = StringValue::Get(chunk->GetValue(8, row));
+                InflateStoredBody(response);
+                response.body_compressed.clear();
+            }
+            PutInMemory(response);
+            if (found) {
+                found->push_back(std::move(response));
+            }
+        }
+    }
+}
+
+void ResponseCache::Save(DatabaseInstance &db, const CachedResponse &response, const CacheAutoVacuum &auto_vacuum) {
+    Connection conn(db);
+    EnsureCacheTable(conn);
+    string sql = "INSERT OR REPLACE INTO " + string(CACHE_TABLE_NAME) +
+                 " (url, status_code, content_type, body, error, response_time_ms, cached_at, "
+                 "content_encoding, body_compressed) "
+                 "VALUES ($1, $2, $3, $4, $5, $6, current_timestamp, $7, $8)";
+    conn.Query(sql, response.url, response.status_code,
+               response.content_type.empty() ? Value() : Value(response.content_type),
+               response.body.empty() ? Value() : Value(response.body),
+               response.error.empty() ? Value() : Value(response.error),
+               response.response_time_ms,
+               response.content_encoding.empty() ? Value() : Value(response.content_encoding),
+               response.body_compressed.empty()
+                   ? Value()
+                   : Value::BLOB(const_data_ptr_cast(response.body_compressed.data()), response.body_compressed.size()));
+
+    // The memory tier serves bodies only; compressed-only rows are inflated when next loaded
+    if (response.body_compressed.empty() || !response.body.empty()) {
+        CachedResponse stored = response;
+        stored.body_compressed.clear();
+        stored.cached_at = std::chrono::steady_clock::now();
+        PutInMemory(stored);
+    }
+
+    // Automatic compaction: amortized over many writes so the table stays bounded
+    // without a dedicated maintenance job
+    if (auto_vacuum.enabled && ++saves_since_vacuum_ >= AUTO_VACUUM_INTERVAL) {
+        saves_since_vacuum_ = 0;
+        VacuumCacheTable(conn, auto_vacuum.max_age_hours, auto_vacuum.max_bytes, DEFAULT_VACUUM_BATCH_SIZE);
+        Clear();
+    }
+}
+
+void ResponseCache::Clear() {
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.lru.clear();
+        shard.index.clear();
+        shard.bytes = 0;
+    }
+}
+
+idx_t ResponseCache::MemoryUsage() const {
+    idx_t total = 0;
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.bytes;
+    }
+    return total;
+}
+
+} // namespace duckdb
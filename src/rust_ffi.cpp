@@ -2,6 +2,7 @@
 // Only compiled when RUST_PARSER_AVAILABLE is defined
 
 #include "rust_ffi.hpp"
+#include "crawler_utils.hpp"
 #include "yyjson.hpp"
 #include <sstream>
 #include <cctype>
@@ -18,21 +19,32 @@ extern "C" {
     ExtractionResultFFI extract_from_html(const char *html_ptr, size_t html_len,
                                            const char *request_json);
     ExtractionResultFFI extract_jsonld_ffi(const char *html_ptr, size_t html_len);
-    ExtractionResultFFI extract_microdata_ffi(const char *html_ptr, size_t html_len);
+    ExtractionResultFFI extract_microdata_ffi(const char *html_ptr, size_t html_len, const char *budget_json);
     ExtractionResultFFI extract_opengraph_ffi(const char *html_ptr, size_t html_len);
-    ExtractionResultFFI extract_js_ffi(const char *html_ptr, size_t html_len);
+    ExtractionResultFFI extract_js_ffi(const char *html_ptr, size_t html_len, const char *budget_json);
     ExtractionResultFFI extract_css_ffi(const char *html_ptr, size_t html_len,
                                          const char *selector);
     // Readability extraction
     ExtractionResultFFI extract_readability_ffi(const char *html_ptr, size_t html_len,
-                                                 const char *url);
+                                                 const char *url, const char *budget_json);
     // Batch crawl + extract (HTTP in Rust)
     ExtractionResultFFI crawl_batch_ffi(const char *request_json);
+    // Per-query cancellation tokens
+    struct CancelToken;
+    typedef bool (*CancelProbeFn)(void *probe_data);
+    CancelToken *cancel_token_new(CancelProbeFn probe, void *probe_data);
+    void cancel_token_cancel(const CancelToken *token);
+    bool cancel_token_is_cancelled(const CancelToken *token);
+    void cancel_token_free(CancelToken *token);
+    ExtractionResultFFI crawl_batch_cancellable_ffi(const char *request_json, const CancelToken *token);
     // Sitemap fetching (simple API - returns char* directly)
     char *fetch_sitemap_simple(const char *request_json);
     void free_rust_string(char *ptr);
     // Robots.txt checking
     ExtractionResultFFI check_robots_ffi(const char *request_json);
+    // Lazy decompression of raw stored bodies
+    ExtractionResultFFI decompress_body_ffi(const uint8_t *data_ptr, size_t data_len,
+                                             const char *content_encoding, const char *content_type);
     void free_extraction_result(ExtractionResultFFI result);
     const char *rust_parser_version();
     // Signal handling for graceful shutdown
@@ -50,7 +62,22 @@ extern "C" {
     // HTML table extraction (url is used to detect Wikipedia for special handling)
     // table_index: 0-based index of which matching element to extract
     ExtractionResultFFI extract_table_ffi(const char *html_ptr, size_t html_len,
-                                           const char *selector, const char *url, size_t table_index);
+                                           const char *selector, const char *url, size_t table_index,
+                                           const char *budget_json);
+    // Columnar HTML table extraction (headers first, then column by column)
+    struct ColumnarTableFFI {
+        char *data_ptr;
+        size_t data_len;
+        uint64_t *offsets_ptr;
+        size_t offsets_len;
+        size_t num_columns;
+        size_t num_rows;
+        char *error_ptr;
+    };
+    ColumnarTableFFI extract_table_columnar_ffi(const char *html_ptr, size_t html_len,
+                                                 const char *selector, const char *url, size_t table_index,
+                                                 const char *budget_json);
+    void free_columnar_table(ColumnarTableFFI table);
 }
 
 namespace duckdb {
@@ -108,9 +135,9 @@ std::string ExtractJsonLdWithRust(const std::string &html) {
     return result.HasError() ? "{}" : result.GetJson();
 }
 
-std::string ExtractMicrodataWithRust(const std::string &html) {
+std::string ExtractMicrodataWithRust(const std::string &html, const std::string &budget_json) {
     if (html.empty()) return "{}";
-    auto ffi_result = extract_microdata_ffi(html.c_str(), html.length());
+    auto ffi_result = extract_microdata_ffi(html.c_str(), html.length(), budget_json.c_str());
     RustResult result(ffi_result);
     return result.HasError() ? "{}" : result.GetJson();
 }
@@ -122,9 +149,9 @@ std::string ExtractOpenGraphWithRust(const std::string &html) {
     return result.HasError() ? "{}" : result.GetJson();
 }
 
-std::string ExtractJsWithRust(const std::string &html) {
+std::string ExtractJsWithRust(const std::string &html, const std::string &budget_json) {
     if (html.empty()) return "{}";
-    auto ffi_result = extract_js_ffi(html.c_str(), html.length());
+    auto ffi_result = extract_js_ffi(html.c_str(), html.length(), budget_json.c_str());
     RustResult result(ffi_result);
     return result.HasError() ? "{}" : result.GetJson();
 }
@@ -136,9 +163,10 @@ std::string ExtractCssWithRust(const std::string &html, const std::string &selec
     return result.HasError() ? "[]" : result.GetJson();
 }
 
-std::string ExtractReadabilityWithRust(const std::string &html, const std::string &url) {
+std::string ExtractReadabilityWithRust(const std::string &html, const std::string &url,
+                                       const std::string &budget_json) {
     if (html.empty()) return "{}";
-    auto ffi_result = extract_readability_ffi(html.c_str(), html.length(), url.c_str());
+    auto ffi_result = extract_readability_ffi(html.c_str(), html.length(), url.c_str(), budget_json.c_str());
     RustResult result(ffi_result);
     return result.HasError() ? "{}" : result.GetJson();
 }
@@ -153,6 +181,42 @@ std::string CrawlBatchWithRust(const std::string &request_json) {
     return result.GetJson();
 }
 
+// Probe handed to Rust: the token watches DuckDB-owned flags
+static bool CancelTokenProbe(void *probe_data) {
+    return static_cast<const CrawlCancelToken *>(probe_data)->WatchedFlagSet();
+}
+
+CrawlCancelToken::CrawlCancelToken(const std::atomic<bool> *interrupted, const std::atomic<bool> *stopped)
+    : handle_(nullptr), interrupted_(interrupted), stopped_(stopped) {
+    handle_ = cancel_token_new(CancelTokenProbe, this);
+}
+
+CrawlCancelToken::~CrawlCancelToken() {
+    Cancel();
+    cancel_token_free(static_cast<CancelToken *>(handle_));
+}
+
+void CrawlCancelToken::Cancel() {
+    cancelled_.store(true);
+    cancel_token_cancel(static_cast<CancelToken *>(handle_));
+}
+
+bool CrawlCancelToken::IsCancelled() const {
+    return cancelled_.load() || cancel_token_is_cancelled(static_cast<CancelToken *>(handle_));
+}
+
+std::string CrawlBatchWithRust(const std::string &request_json, const CrawlCancelToken &token) {
+    if (request_json.empty()) return "{\"results\":[]}";
+    if (token.IsCancelled()) return "{\"results\":[]}";
+    auto ffi_result = crawl_batch_cancellable_ffi(request_json.c_str(),
+                                                  static_cast<const CancelToken *>(token.Handle()));
+    RustResult result(ffi_result);
+    if (result.HasError()) {
+        return "{\"error\":\"" + result.GetError() + "\"}";
+    }
+    return result.GetJson();
+}
+
 std::string FetchSitemapWithRust(const std::string &request_json) {
     if (request_json.empty()) return "{\"urls\":[],\"sitemaps\":[],\"errors\":[]}";
 
@@ -182,6 +246,19 @@ std::string CheckRobotsWithRust(const std::string &request_json) {
     return result.GetJson();
 }
 
+bool DecompressBodyWithRust(const std::string &data, const std::string &content_encoding,
+                            const std::string &content_type, std::string &text, std::string &error) {
+    auto ffi_result = decompress_body_ffi(reinterpret_cast<const uint8_t *>(data.data()), data.size(),
+                                          content_encoding.c_str(), content_type.c_str());
+    RustResult result(ffi_result);
+    if (result.HasError()) {
+        error = result.GetError();
+        return false;
+    }
+    text = result.GetJson();
+    return true;
+}
+
 void SetInterrupted(bool value) {
     set_interrupted(value);
 }
@@ -251,12 +328,14 @@ std::string ExtractPathWithRust(const std::string &html, const std::string &path
     return rust_result.GetJson();
 }
 
-std::string ExtractTableWithRust(const std::string &html, const std::string &selector, const std::string &url, size_t table_index) {
+std::string ExtractTableWithRust(const std::string &html, const std::string &selector, const std::string &url, size_t table_index,
+                                 const std::string &budget_json) {
     if (html.empty() || selector.empty()) {
         return "{\"headers\":[],\"rows\":[],\"num_columns\":0,\"num_rows\":0,\"error\":\"Empty input\"}";
     }
 
-    auto ffi_result = extract_table_ffi(html.c_str(), html.length(), selector.c_str(), url.c_str(), table_index);
+    auto ffi_result = extract_table_ffi(html.c_str(), html.length(), selector.c_str(), url.c_str(), table_index,
+                                        budget_json.c_str());
     RustResult rust_result(ffi_result);
 
     if (rust_result.HasError()) {
@@ -267,6 +346,44 @@ std::string ExtractTableWithRust(const std::string &html, const std::string &sel
     return rust_result.GetJson();
 }
 
+RustColumnarTable::RustColumnarTable(const char *data, size_t data_len, const uint64_t *offsets, size_t offsets_len,
+                                     size_t num_columns, size_t num_rows, std::string error)
+    : data_(data), data_len_(data_len), offsets_(offsets), offsets_len_(offsets_len), num_columns_(num_columns),
+      num_rows_(num_rows), error_(std::move(error)) {}
+
+RustColumnarTable::~RustColumnarTable() {
+    ColumnarTableFFI table;
+    table.data_ptr = const_cast<char *>(data_);
+    table.data_len = data_len_;
+    table.offsets_ptr = const_cast<uint64_t *>(offsets_);
+    table.offsets_len = offsets_len_;
+    table.num_columns = num_columns_;
+    table.num_rows = num_rows_;
+    table.error_ptr = nullptr;  // Copied into error_ and freed at construction
+    free_columnar_table(table);
+}
+
+std::unique_ptr<RustColumnarTable> ExtractTableColumnarWithRust(const std::string &html, const std::string &selector,
+                                                                const std::string &url, size_t table_index,
+                                                                const std::string &budget_json) {
+    if (html.empty() || selector.empty()) {
+        return std::unique_ptr<RustColumnarTable>(
+            new RustColumnarTable(nullptr, 0, nullptr, 0, 0, 0, "Empty input"));
+    }
+
+    auto ffi_table = extract_table_columnar_ffi(html.c_str(), html.length(), selector.c_str(), url.c_str(),
+                                                table_index, budget_json.c_str());
+    if (ffi_table.error_ptr) {
+        std::string error(ffi_table.error_ptr);
+        free_columnar_table(ffi_table);
+        return std::unique_ptr<RustColumnarTable>(new RustColumnarTable(nullptr, 0, nullptr, 0, 0, 0, error));
+    }
+
+    return std::unique_ptr<RustColumnarTable>(
+        new RustColumnarTable(ffi_table.data_ptr, ffi_table.data_len, ffi_table.offsets_ptr, ffi_table.offsets_len,
+                              ffi_table.num_columns, ffi_table.num_rows, ""));
+}
+
 } // namespace duckdb
 
 #else // RUST_PARSER_AVAILABLE not defined
@@ -292,8 +409,9 @@ std::string ExtractJsonLdWithRust(const std::string &html) {
     return "{}";
 }
 
-std::string ExtractMicrodataWithRust(const std::string &html) {
+std::string ExtractMicrodataWithRust(const std::string &html, const std::string &budget_json) {
     (void)html;
+    (void)budget_json;
     return "{}";
 }
 
@@ -302,8 +420,9 @@ std::string ExtractOpenGraphWithRust(const std::string &html) {
     return "{}";
 }
 
-std::string ExtractJsWithRust(const std::string &html) {
+std::string ExtractJsWithRust(const std::string &html, const std::string &budget_json) {
     (void)html;
+    (void)budget_json;
     return "{}";
 }
 
@@ -313,9 +432,11 @@ std::string ExtractCssWithRust(const std::string &html, const std::string &selec
     return "[]";
 }
 
-std::string ExtractReadabilityWithRust(const std::string &html, const std::string &url) {
+std::string ExtractReadabilityWithRust(const std::string &html, const std::string &url,
+                                       const std::string &budget_json) {
     (void)html;
     (void)url;
+    (void)budget_json;
     return "{}";
 }
 
@@ -324,6 +445,27 @@ std::string CrawlBatchWithRust(const std::string &request_json) {
     return "{\"error\":\"Rust parser not available\"}";
 }
 
+CrawlCancelToken::CrawlCancelToken(const std::atomic<bool> *interrupted, const std::atomic<bool> *stopped)
+    : handle_(nullptr), interrupted_(interrupted), stopped_(stopped) {
+}
+
+CrawlCancelToken::~CrawlCancelToken() {
+}
+
+void CrawlCancelToken::Cancel() {
+    cancelled_.store(true);
+}
+
+bool CrawlCancelToken::IsCancelled() const {
+    return cancelled_.load() || WatchedFlagSet();
+}
+
+std::string CrawlBatchWithRust(const std::string &request_json, const CrawlCancelToken &token) {
+    (void)request_json;
+    (void)token;
+    return "{\"error\":\"Rust parser not available\"}";
+}
+
 std::string FetchSitemapWithRust(const std::string &request_json) {
     (void)request_json;
     return "{\"urls\":[],\"sitemaps\":[],\"errors\":[\"Rust parser not available\"]}";
@@ -334,6 +476,22 @@ std::string CheckRobotsWithRust(const std::string &request_json) {
     return "{\"allowed\":true,\"crawl_delay\":null,\"sitemaps\":[]}";
 }
 
+bool DecompressBodyWithRust(const std::string &data, const std::string &content_encoding,
+                            const std::string &content_type, std::string &text, std::string &error) {
+    (void)content_type;
+    // zlib covers gzip without the Rust decoders; br and zstd need them
+    if (content_encoding.empty() || content_encoding == "identity") {
+        text = data;
+        return true;
+    }
+    if (content_encoding == "gzip" && IsGzippedData(data)) {
+        text = DecompressGzip(data);
+        return true;
+    }
+    error = "Rust parser not available to decode " + content_encoding;
+    return false;
+}
+
 void SetInterrupted(bool value) {
     (void)value;
     // No-op when Rust parser not available
@@ -363,14 +521,36 @@ std::string ExtractPathWithRust(const std::string &html, const std::string &path
     return "null";
 }
 
-std::string ExtractTableWithRust(const std::string &html, const std::string &selector, const std::string &url, size_t table_index) {
+std::string ExtractTableWithRust(const std::string &html, const std::string &selector, const std::string &url, size_t table_index,
+                                 const std::string &budget_json) {
     (void)html;
     (void)selector;
     (void)url;
     (void)table_index;
+    (void)budget_json;
     return "{\"headers\":[],\"rows\":[],\"num_columns\":0,\"num_rows\":0,\"error\":\"Rust parser not available\"}";
 }
 
+RustColumnarTable::RustColumnarTable(const char *data, size_t data_len, const uint64_t *offsets, size_t offsets_len,
+                                     size_t num_columns, size_t num_rows, std::string error)
+    : data_(data), data_len_(data_len), offsets_(offsets), offsets_len_(offsets_len), num_columns_(num_columns),
+      num_rows_(num_rows), error_(std::move(error)) {}
+
+RustColumnarTable::~RustColumnarTable() {
+}
+
+std::unique_ptr<RustColumnarTable> ExtractTableColumnarWithRust(const std::string &html, const std::string &selector,
+                                                                const std::string &url, size_t table_index,
+                                                                const std::string &budget_json) {
+    (void)html;
+    (void)selector;
+    (void)url;
+    (void)table_index;
+    (void)budget_json;
+    return std::unique_ptr<RustColumnarTable>(
+        new RustColumnarTable(nullptr, 0, nullptr, 0, 0, 0, "Rust parser not available"));
+}
+
 } // namespace duckdb
 
 #endif // RUST_PARSER_AVAILABLE
@@ -88,9 +88,10 @@ static void StreamIntoFunction(ClientContext &context, TableFunctionInput &data,
     conn.Query("LOAD crawler");
 
     // Initialize pipeline state for LIMIT pushdown to crawl functions
-    // This allows crawl_url in LATERAL to respect the LIMIT
+    // This allows crawl_url in LATERAL to respect the LIMIT; the state is scoped to
+    // this connection, so concurrent STREAM INTO queries stay isolated
     if (bind_data.row_limit > 0) {
-        InitPipelineLimit(*context.db, bind_data.row_limit);
+        InitPipelineLimit(*conn.context, bind_data.row_limit);
     }
 
     // Execute source query
@@ -181,7 +182,7 @@ static void StreamIntoFunction(ClientContext &context, TableFunctionInput &data,
 
     // Clean up pipeline state
     if (bind_data.row_limit > 0) {
-        ClearPipelineState(*context.db);
+        ClearPipelineState(*conn.context);
     }
 
     // Return rows_inserted count
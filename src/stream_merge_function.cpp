@@ -490,7 +490,14 @@ static void CrawlingMergeFunction(ClientContext &context, TableFunctionInput &da
 
 	// Initialize pipeline state for LIMIT pushdown
 	if (bind_data.row_limit > 0) {
-		InitPipelineLimit(*context.db, bind_data.row_limit);
+		InitPipelineLimit(*conn.context, bind_data.row_limit);
+	}
+
+	// Statement-wide budget (crawler_max_* settings): every crawl call in the source draws
+	// from it; once spent the source ends early and the rows crawled so far are merged
+	auto budget = CrawlBudget::FromSettings(context);
+	if (budget.IsLimited()) {
+		InitPipelineBudget(*conn.context, budget);
 	}
 
 	// CONDITION PUSHDOWN: If there's a WHEN MATCHED AND condition, rewrite the query
@@ -742,8 +749,8 @@ static void CrawlingMergeFunction(ClientContext &context, TableFunctionInput &da
 	state.finished = true;
 
 	// Clean up pipeline state
-	if (bind_data.row_limit > 0) {
-		ClearPipelineState(*context.db);
+	if (bind_data.row_limit > 0 || budget.IsLimited()) {
+		ClearPipelineState(*conn.context);
 	}
 
 	// Return counts
@@ -1,4 +1,5 @@
 #include "thread_utils.hpp"
+#include "crawler_utils.hpp"
 
 namespace duckdb {
 
@@ -82,4 +83,26 @@ void ThreadSafeDomainMap::InitializeFromDiscovery(const std::string &domain, con
 	state->min_crawl_delay_seconds = src.min_crawl_delay_seconds;
 }
 
+//===--------------------------------------------------------------------===//
+// Host Sharding
+//===--------------------------------------------------------------------===//
+
+int32_t JumpConsistentHash(uint64_t key, int32_t num_shards) {
+	int64_t b = -1;
+	int64_t j = 0;
+	while (j < num_shards) {
+		b = j;
+		key = key * 2862933555777941757ULL + 1;
+		j = static_cast<int64_t>((b + 1) * (static_cast<double>(1LL << 31) / static_cast<double>((key >> 33) + 1)));
+	}
+	return static_cast<int32_t>(b);
+}
+
+int32_t HostShardFor(const std::string &url, int32_t num_shards) {
+	if (num_shards <= 1) {
+		return 0;
+	}
+	return JumpConsistentHash(HostHash(url), num_shards);
+}
+
 } // namespace duckdb
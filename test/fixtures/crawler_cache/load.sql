@@ -0,0 +1,2 @@
+-- Empty: each suite inserts its own cached pages after
+--   IMPORT DATABASE 'test/fixtures/crawler_cache';
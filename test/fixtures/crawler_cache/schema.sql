@@ -0,0 +1,12 @@
+-- __crawler_cache as the extension creates it (EnsureCacheTable in src/response_cache.cpp)
+CREATE TABLE __crawler_cache (
+    url VARCHAR PRIMARY KEY,
+    status_code INTEGER,
+    content_type VARCHAR,
+    body VARCHAR,
+    error VARCHAR,
+    response_time_ms BIGINT,
+    cached_at TIMESTAMP DEFAULT current_timestamp,
+    content_encoding VARCHAR,
+    body_compressed BLOB
+);